@@ -0,0 +1,88 @@
+#define NOMINMAX
+#include "capture_replay.h"
+#include "stronghold_calculator.h"
+#include <chrono>
+
+std::vector<CaptureReplayStep> replayCaptureLog(const std::vector<CaptureEvent>& events,
+    ResultPublisher* publisher) {
+    std::vector<CaptureReplayStep> steps;
+
+    // Start from a clean state so replays are deterministic
+    appState = ApplicationState();
+    strongholdCandidates.clear();
+    CaptureStateMachine machine(appState);
+    machine.setRecording(false);
+
+    for (size_t i = 0; i < events.size(); i++) {
+        auto start = std::chrono::steady_clock::now();
+
+        unsigned int actions = machine.handleEvent(events[i]);
+        if (actions & CAPTURE_ACTION_SOLVE) {
+            solveCapturedThrow(machine.solveTargetDistance());
+        }
+        if ((actions & CAPTURE_ACTION_COPY_RESULTS) && publisher) {
+            publisher->publish(makeResultSnapshot(i, appState, strongholdCandidates));
+        }
+        if (actions & CAPTURE_ACTION_CLEAR_RESULTS) {
+            strongholdCandidates.clear();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        CaptureReplayStep step = {};
+        step.eventIndex = i;
+        step.actions = actions;
+        step.capturePhase = appState.capturePhase;
+        step.latencyMs = std::chrono::duration<double, std::milli>(end - start).count();
+        step.candidateCount = strongholdCandidates.size();
+        step.hasTopCandidate = !strongholdCandidates.empty();
+        if (step.hasTopCandidate) {
+            step.topCandidate = strongholdCandidates[0];
+        }
+        steps.push_back(step);
+    }
+
+    return steps;
+}
+
+ReplayFrameSource::ReplayFrameSource(const std::vector<CaptureEvent>& events) {
+    for (const auto& event : events) {
+        if (event.type == CAPTURE_EVENT_DIRECTION_KEY) presses.push_back(event);
+    }
+}
+
+// The recorded press stands in for the HUD image
+struct ReplayHudFrame : HudFrame {
+    CaptureEvent press;
+};
+
+std::shared_ptr<const HudFrame> ReplayFrameSource::grabFrame() {
+    if (next >= presses.size()) return nullptr;
+    auto frame = std::make_shared<ReplayHudFrame>();
+    frame->press = presses[next++];
+    return frame;
+}
+
+bool ReplayFrameSource::decodeCoordinates(const HudFrame& frame, Vec3& coords) {
+    const CaptureEvent& press = static_cast<const ReplayHudFrame&>(frame).press;
+    coords = press.coords;
+    return press.coordsRead;
+}
+
+std::shared_ptr<const CaptureSnapshot> replayCaptureLogThreaded(const std::vector<CaptureEvent>& events,
+    ResultPublisher* publisher, SessionLogWriter* sessionLog) {
+    appState = ApplicationState();
+    strongholdCandidates.clear();
+    CaptureStateMachine machine(appState);
+    machine.setRecording(false);
+    ReplayFrameSource frames(events);
+
+    CaptureWorker worker(machine, frames, nullptr, publisher, sessionLog);
+    for (const auto& event : events) {
+        worker.submit(event.type, event.timeMs);
+    }
+    worker.stop();
+
+    unsigned int actions = CAPTURE_ACTION_NONE;
+    return worker.takeSnapshot(actions);
+}
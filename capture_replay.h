@@ -0,0 +1,40 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "capture_state_machine.h"
+#include "result_sinks.h"
+#include "capture_worker.h"
+
+// Result of replaying one recorded event
+struct CaptureReplayStep {
+    size_t eventIndex;
+    unsigned int actions;
+    int capturePhase;
+    double latencyMs;       // Event dispatch through solve, measured on this machine
+    size_t candidateCount;
+    bool hasTopCandidate;
+    StrongholdCandidate topCandidate;
+};
+
+// Replay a recorded session headlessly against the global appState and solver.
+// No Win32 calls are made; overlay actions are only reported, and copied results
+// go to the publisher's sinks when one is given.
+std::vector<CaptureReplayStep> replayCaptureLog(const std::vector<CaptureEvent>& events,
+    ResultPublisher* publisher = nullptr);
+
+// Hands out the coordinates recorded with the direction presses of a log, in order
+class ReplayFrameSource : public FrameSource {
+public:
+    explicit ReplayFrameSource(const std::vector<CaptureEvent>& events);
+    std::shared_ptr<const HudFrame> grabFrame() override;
+    bool decodeCoordinates(const HudFrame& frame, Vec3& coords) override;
+
+private:
+    std::vector<CaptureEvent> presses;
+    size_t next = 0;
+};
+
+// Replay through a CaptureWorker, the way the GUI runs it: all events are queued at
+// once, so stale solves are superseded. Returns the final snapshot, nullptr for an empty log.
+std::shared_ptr<const CaptureSnapshot> replayCaptureLogThreaded(const std::vector<CaptureEvent>& events,
+    ResultPublisher* publisher = nullptr, SessionLogWriter* sessionLog = nullptr);
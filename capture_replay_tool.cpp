@@ -0,0 +1,143 @@
+// Headless replay of a recorded capture_log.txt session.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread capture_replay_tool.cpp capture_replay.cpp capture_state_machine.cpp
+//       stronghold_calculator.cpp fixed_point_solver.cpp first_throw_table.cpp cell_lattice.cpp distance_estimator.cpp
+//       result_sinks.cpp solver_config.cpp capture_worker.cpp route_planner.cpp throw_recommender.cpp
+//       ring_prior.cpp session_log.cpp number_format.cpp trace.cpp metrics.cpp -o capture_replay
+// Pass --config to solve with the settings of a config.ini (such as session_log config
+// writes), --fixed to replay with the deterministic fixed-point solver, --java to solve
+// with the Java Edition ring prior, --sink to publish copied results like the GUI
+// does, and --threaded to run the events through the capture worker and print only
+// the final state. --session-log also appends the threaded run to a session log.
+#define NOMINMAX
+#include "capture_replay.h"
+#include "number_format.h"
+#include "stronghold_calculator.h"
+#include "metrics.h"
+#include "session_log.h"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+int main(int argc, char** argv) {
+    ResultPublisher publisher;
+    SessionLogWriter sessionLog;
+    bool threaded = false;
+    int argument = 1;
+    for (; argument < argc && std::strncmp(argv[argument], "--", 2) == 0; argument++) {
+        std::string option = argv[argument];
+        if (option == "--config" && argument + 1 < argc) {
+            std::ifstream config(argv[++argument]);
+            std::vector<std::string> errors;
+            if (!config.is_open()) {
+                std::cerr << "Could not open " << argv[argument] << "\n";
+                return 1;
+            }
+            readSolverConfig(config, solverConfig, errors);
+            for (const auto& error : errors) {
+                std::cerr << error << "\n";
+            }
+        }
+        else if (option == "--fixed") {
+            solverMode = SOLVER_FIXED_POINT;
+        }
+        else if (option == "--java") {
+            solverConfig.edition = EDITION_JAVA;
+        }
+        else if (option == "--threaded") {
+            threaded = true;
+        }
+        else if (option == "--session-log" && argument + 1 < argc) {
+            if (!sessionLog.open(argv[++argument])) {
+                std::cerr << "Could not open " << argv[argument] << "\n";
+                return 1;
+            }
+            sessionLog.append(makeSessionStartRecord(solverConfig, solverMode));
+        }
+        else if (option == "--sink" && argument + 1 < argc) {
+            std::string sink = argv[++argument];
+            if (sink == "stdout") publisher.addSink(std::make_unique<StdoutResultSink>());
+            else if (sink.compare(0, 5, "file:") == 0) publisher.addSink(std::make_unique<FileResultSink>(sink.substr(5)));
+            else if (sink.compare(0, 7, "socket:") == 0) publisher.addSink(std::make_unique<SocketResultSink>(sink.substr(7)));
+            else argument = argc;
+        }
+        else {
+            argument = argc;
+        }
+    }
+    if (argument >= argc) {
+        std::cerr << "Usage: capture_replay [--config <config.ini>] [--fixed] [--java] [--threaded]\n"
+            << "                      [--session-log <path>] [--sink stdout|file:<path>|socket:<path>]... <capture_log.txt>\n";
+        return 1;
+    }
+
+    std::ifstream file(argv[argument]);
+    if (!file.is_open()) {
+        std::cerr << "Could not open " << argv[argument] << "\n";
+        return 1;
+    }
+
+    std::vector<CaptureEvent> events = readCaptureLog(file);
+    if (threaded) {
+        std::shared_ptr<const CaptureSnapshot> snapshot = replayCaptureLogThreaded(events,
+            publisher.empty() ? nullptr : &publisher, sessionLog.isOpen() ? &sessionLog : nullptr);
+        publisher.stop();
+        sessionLog.stop();
+        if (!snapshot) return 0;
+
+        NarrowFormatBuffer line;
+        line.text("Snapshots: ").integer(snapshot->sequence)
+            .text("  superseded solves: ").integer(metrics.supersededSolves.get())
+            .text("  phase=").integer(snapshot->state.capturePhase)
+            .text(" candidates=").integer(snapshot->candidates.size());
+        if (!snapshot->candidates.empty()) {
+            const auto& top = snapshot->candidates[0];
+            line.text(" top=(").integer(top.projectionX).text(", ").integer(top.projectionZ)
+                .text(") ").fixed(top.conditionalProb * 100.0, 1).text("%");
+        }
+        std::cout << line.c_str() << "\n";
+        return 0;
+    }
+
+    std::vector<CaptureReplayStep> steps = replayCaptureLog(events, publisher.empty() ? nullptr : &publisher);
+    publisher.stop();
+
+    double totalLatency = 0.0, maxLatency = 0.0;
+    int solves = 0;
+    for (const auto& step : steps) {
+        const auto& event = events[step.eventIndex];
+        NarrowFormatBuffer line;
+        line.text("#").integer(step.eventIndex).text(" ")
+            .text(event.type == CAPTURE_EVENT_DIRECTION_KEY ? "direction" : "distance")
+            .text(" phase=").integer(step.capturePhase);
+        std::cout << line.c_str() << " actions=0x" << std::hex << step.actions << std::dec;
+
+        if (step.actions & CAPTURE_ACTION_SOLVE) {
+            solves++;
+            totalLatency += step.latencyMs;
+            maxLatency = std::max(maxLatency, step.latencyMs);
+            line.clear();
+            line.text(" candidates=").integer(step.candidateCount)
+                .text(" latency=").fixed(step.latencyMs, 3).text("ms");
+            if (step.hasTopCandidate) {
+                line.text(" top=(").integer(step.topCandidate.projectionX).text(", ").integer(step.topCandidate.projectionZ)
+                    .text(") ").fixed(step.topCandidate.conditionalProb * 100.0, 1).text("%");
+            }
+            std::cout << line.c_str();
+        }
+        std::cout << "\n";
+    }
+
+    if (solves > 0) {
+        std::cout << "Solves: " << solves << "  mean " << std::fixed << std::setprecision(3)
+            << (totalLatency / solves) << "ms  max " << maxLatency << "ms\n";
+    }
+    return 0;
+}
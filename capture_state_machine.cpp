@@ -0,0 +1,159 @@
+#define NOMINMAX
+#include "capture_state_machine.h"
+#include "stronghold_calculator.h"
+#include <chrono>
+#include <sstream>
+#include <string>
+
+unsigned int CaptureStateMachine::handleEvent(const CaptureEvent& event) {
+    if (recording && log.size() < MAX_CAPTURE_LOG_EVENTS) {
+        log.push_back(event);
+    }
+
+    switch (event.type) {
+    case CAPTURE_EVENT_DIRECTION_KEY:
+        return handleDirectionKey(event);
+    case CAPTURE_EVENT_DISTANCE_KEY:
+        return handleDistanceKey(event);
+    }
+    return CAPTURE_ACTION_NONE;
+}
+
+unsigned int CaptureStateMachine::handleDirectionKey(const CaptureEvent& event) {
+    // Nothing happens when the coordinates could not be read
+    if (!event.coordsRead) {
+        return CAPTURE_ACTION_NONE;
+    }
+
+    unsigned int actions = CAPTURE_ACTION_NONE;
+    state.latestCoords = event.coords;
+
+    if (state.capturePhase == 0) {
+        // First press - only mark as direction first if distance wasn't pressed yet
+        if (state.distanceKeyPresses == 0) {
+            state.tabPressedFirst = true;
+            actions |= CAPTURE_ACTION_SHOW_OVERLAY;
+        }
+        state.coord1 = state.latestCoords;
+        state.capturePhase = 1;
+    }
+    else if (state.capturePhase == 1) {
+        state.coord2 = state.latestCoords;
+        state.lastAngle = angleBetween(state.coord1.x, state.coord1.z,
+            state.coord2.x, state.coord2.z);
+        state.capturePhase = 2;
+        actions |= CAPTURE_ACTION_SOLVE | CAPTURE_ACTION_COPY_RESULTS;
+    }
+    else {
+        // Third press resets everything
+        reset();
+        actions |= CAPTURE_ACTION_CLEAR_RESULTS | CAPTURE_ACTION_HIDE_OVERLAY;
+    }
+
+    return actions | CAPTURE_ACTION_UPDATE_OVERLAY | CAPTURE_ACTION_REPAINT;
+}
+
+unsigned int CaptureStateMachine::handleDistanceKey(const CaptureEvent& event) {
+    // If TAB was pressed first, ignore F4 presses
+    if (state.tabPressedFirst) {
+        return CAPTURE_ACTION_NONE;
+    }
+
+    unsigned int actions = CAPTURE_ACTION_NONE;
+
+    // Mark that F4 was pressed first
+    if (state.distanceKeyPresses == 0 && state.capturePhase == 0) {
+        state.f4PressedFirst = true;
+        actions |= CAPTURE_ACTION_SHOW_OVERLAY;
+    }
+
+    // Check if this is a new sequence (timeout exceeded)
+    if (state.distanceKeyPresses > 0 && !state.distanceKeyPressTimesMs.empty()) {
+        double elapsed = event.timeMs - state.distanceKeyPressTimesMs.back();
+        if (elapsed > DISTANCE_KEY_TIMEOUT_MS) {
+            state.distanceKeyPresses = 0;
+            state.distanceKeyPressTimesMs.clear();
+        }
+    }
+
+    state.distanceKeyPresses++;
+    state.distanceKeyPressTimesMs.push_back(event.timeMs);
+
+    // Calculate distance: 3655 / (presses / 2), plus the full likelihood for the solver
+    state.distanceLikelihood = DistanceLikelihood::fromPresses(state.distanceKeyPressTimesMs);
+    state.calculatedDistance = state.distanceLikelihood.nominalDistance();
+
+    return actions | CAPTURE_ACTION_UPDATE_OVERLAY | CAPTURE_ACTION_REPAINT;
+}
+
+double CaptureStateMachine::solveTargetDistance() const {
+    // Always use distance when distance key was pressed first
+    if (state.f4PressedFirst && state.calculatedDistance > 0) {
+        return state.calculatedDistance;
+    }
+    return -1;
+}
+
+void CaptureStateMachine::reset() {
+    state.capturePhase = 0;
+    state.coord1 = { 0, 0, 0 };
+    state.coord2 = { 0, 0, 0 };
+    state.lastAngle = 0.0;
+    state.distanceKeyPresses = 0;
+    state.calculatedDistance = 0.0;
+    state.distanceKeyPressTimesMs.clear();
+    state.distanceLikelihood = DistanceLikelihood();
+    state.tabPressedFirst = false;
+    state.f4PressedFirst = false;
+    state.distanceValidationFailed = false;
+    state.validationErrorMessage = L"";
+}
+
+double captureClockMs() {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(now.time_since_epoch()).count();
+}
+
+// Line format:
+//   D <timeMs>                      distance key
+//   T <timeMs> <read> <x> <y> <z>   direction key
+void writeCaptureLog(std::ostream& out, const std::vector<CaptureEvent>& events) {
+    out.precision(17);
+    for (const auto& event : events) {
+        if (event.type == CAPTURE_EVENT_DISTANCE_KEY) {
+            out << "D " << event.timeMs << "\n";
+        }
+        else {
+            out << "T " << event.timeMs << " " << (event.coordsRead ? 1 : 0) << " "
+                << event.coords.x << " " << event.coords.y << " " << event.coords.z << "\n";
+        }
+    }
+}
+
+std::vector<CaptureEvent> readCaptureLog(std::istream& in) {
+    std::vector<CaptureEvent> events;
+    std::string line;
+    while (std::getline(in, line)) {
+        // Skip empty lines and comments
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream ss(line);
+        char kind = 0;
+        CaptureEvent event = { CAPTURE_EVENT_DISTANCE_KEY, 0.0, false, { 0, 0, 0 } };
+        if (!(ss >> kind >> event.timeMs)) continue;
+
+        if (kind == 'T') {
+            int read = 0;
+            if (!(ss >> read >> event.coords.x >> event.coords.y >> event.coords.z)) continue;
+            event.type = CAPTURE_EVENT_DIRECTION_KEY;
+            event.coordsRead = read != 0;
+        }
+        else if (kind != 'D') {
+            continue;
+        }
+        events.push_back(event);
+    }
+    return events;
+}
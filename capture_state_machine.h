@@ -0,0 +1,69 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include <istream>
+#include <ostream>
+#include "app_state.h"
+
+// Constants
+const int DISTANCE_KEY_TIMEOUT_MS = 2000; // 2 seconds timeout between presses
+const size_t MAX_CAPTURE_LOG_EVENTS = 10000; // Recording stops once the log is this long
+
+enum CaptureEventType {
+    CAPTURE_EVENT_DIRECTION_KEY,
+    CAPTURE_EVENT_DISTANCE_KEY
+};
+
+struct CaptureEvent {
+    CaptureEventType type;
+    double timeMs;      // Steady clock time of the key press
+    bool coordsRead;    // Direction key only: HUD coordinates were decoded
+    Vec3 coords;
+};
+
+// Side effects requested by a transition, executed by the caller
+enum CaptureAction {
+    CAPTURE_ACTION_NONE = 0,
+    CAPTURE_ACTION_SHOW_OVERLAY = 1 << 0,
+    CAPTURE_ACTION_HIDE_OVERLAY = 1 << 1,
+    CAPTURE_ACTION_SOLVE = 1 << 2,
+    CAPTURE_ACTION_COPY_RESULTS = 1 << 3,
+    CAPTURE_ACTION_CLEAR_RESULTS = 1 << 4,
+    CAPTURE_ACTION_UPDATE_OVERLAY = 1 << 5,
+    CAPTURE_ACTION_REPAINT = 1 << 6
+};
+
+// Event-driven TAB/F4 capture logic. Owns no Win32 state: every transition only
+// updates the ApplicationState it was given and returns the actions to perform.
+class CaptureStateMachine {
+public:
+    explicit CaptureStateMachine(ApplicationState& state) : state(state) {}
+
+    // Apply one key event, returns a mask of CaptureAction flags
+    unsigned int handleEvent(const CaptureEvent& event);
+
+    // Target distance to pass to the solver for a CAPTURE_ACTION_SOLVE
+    double solveTargetDistance() const;
+
+    // Return to the initial phase (the third direction press)
+    void reset();
+
+    const std::vector<CaptureEvent>& eventLog() const { return log; }
+    void clearEventLog() { log.clear(); }
+    void setRecording(bool enabled) { recording = enabled; }
+
+private:
+    unsigned int handleDirectionKey(const CaptureEvent& event);
+    unsigned int handleDistanceKey(const CaptureEvent& event);
+
+    ApplicationState& state;
+    std::vector<CaptureEvent> log;
+    bool recording = true;
+};
+
+// Current steady clock time in milliseconds, the time base for CaptureEvent
+double captureClockMs();
+
+// Event log serialization, one event per line
+void writeCaptureLog(std::ostream& out, const std::vector<CaptureEvent>& events);
+std::vector<CaptureEvent> readCaptureLog(std::istream& in);
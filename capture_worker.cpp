@@ -0,0 +1,202 @@
+#define NOMINMAX
+#include "capture_worker.h"
+#include <chrono>
+#include "stronghold_calculator.h"
+#include "session_log.h"
+#include "metrics.h"
+#include "trace.h"
+
+unsigned int mergeCaptureActions(unsigned int earlier, unsigned int later) {
+    if (later & CAPTURE_ACTION_SHOW_OVERLAY) earlier &= ~CAPTURE_ACTION_HIDE_OVERLAY;
+    if (later & CAPTURE_ACTION_HIDE_OVERLAY) earlier &= ~CAPTURE_ACTION_SHOW_OVERLAY;
+    return earlier | later;
+}
+
+CaptureWorker::CaptureWorker(CaptureStateMachine& machine, FrameSource& frames, std::function<void()> notify,
+    ResultPublisher* publisher, SessionLogWriter* sessionLog)
+    : machine(machine), frames(frames), notify(notify), publisher(publisher), sessionLog(sessionLog) {
+    worker = std::thread(&CaptureWorker::run, this);
+}
+
+void CaptureWorker::submit(CaptureEventType type, double timeMs) {
+    // Grabbed now, so the position is the one at the press even when the worker is busy
+    std::shared_ptr<const HudFrame> frame;
+    if (type == CAPTURE_EVENT_DIRECTION_KEY) frame = frames.grabFrame();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ CAPTURE_JOB_KEY, type, timeMs, frame, SolverConfig() });
+    }
+    wake.notify_one();
+}
+
+void CaptureWorker::submitConfig(const SolverConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ CAPTURE_JOB_CONFIG, CAPTURE_EVENT_DIRECTION_KEY, 0.0, nullptr, config });
+    }
+    wake.notify_one();
+}
+
+void CaptureWorker::submitOutcome(double timeMs) {
+    std::shared_ptr<const HudFrame> frame = frames.grabFrame();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ CAPTURE_JOB_OUTCOME, CAPTURE_EVENT_DIRECTION_KEY, timeMs, frame, SolverConfig() });
+    }
+    wake.notify_one();
+}
+
+std::shared_ptr<const CaptureSnapshot> CaptureWorker::takeSnapshot(unsigned int& actions) {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    actions = latestActions;
+    latestActions = 0;
+    std::shared_ptr<const CaptureSnapshot> snapshot;
+    snapshot.swap(latest);
+    return snapshot;
+}
+
+void CaptureWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void CaptureWorker::publishSnapshot(unsigned int actions) {
+    auto snapshot = std::make_shared<CaptureSnapshot>();
+    snapshot->sequence = ++sequence;
+    snapshot->actions = actions;
+    snapshot->state = appState;
+    snapshot->candidates = strongholdCandidates;
+    snapshot->route = strongholdRoute;
+    snapshot->nextThrows = nextThrowRecommendations;
+    snapshot->config = solverConfig;
+
+    // Only the first unread snapshot needs a notification; later ones replace it
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        wasEmpty = !latest;
+        latest = snapshot;
+        latestActions = mergeCaptureActions(latestActions, actions);
+    }
+    if (wasEmpty && notify) notify();
+}
+
+void CaptureWorker::run() {
+    // Carried across batches while newer presses keep a solve waiting
+    unsigned int pendingActions = CAPTURE_ACTION_NONE;
+    bool solvePending = false;
+    // Jobs were handled since the last snapshot, the first of them at unpublishedSince
+    bool unpublished = false;
+    std::chrono::steady_clock::time_point unpublishedSince;
+    auto overdue = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - unpublishedSince).count()
+            >= CAPTURE_MAX_DEFER_MS;
+    };
+
+    while (true) {
+        std::deque<CaptureJob> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) break;
+            batch.swap(jobs);
+        }
+        if (!unpublished) {
+            unpublished = true;
+            unpublishedSince = std::chrono::steady_clock::now();
+        }
+
+        for (size_t i = 0; i < batch.size(); i++) {
+            const CaptureJob& job = batch[i];
+            if (i > 0 && overdue()) {
+                // A backlog of presses: publish what is done, the rest go back to the front
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.insert(jobs.begin(), batch.begin() + i, batch.end());
+                break;
+            }
+            if (job.kind == CAPTURE_JOB_OUTCOME) {
+                Vec3 coords;
+                if (sessionLog && job.frame && frames.decodeCoordinates(*job.frame, coords)) {
+                    SessionRecord outcome;
+                    outcome.kind = SESSION_RECORD_OUTCOME;
+                    outcome.outcomeX = coords.x;
+                    outcome.outcomeZ = coords.z;
+                    sessionLog->append(outcome);
+                }
+                continue;
+            }
+            if (job.kind == CAPTURE_JOB_CONFIG) {
+                solverConfig = job.config;
+                if (sessionLog) sessionLog->append(makeSessionStartRecord(solverConfig, solverMode));
+                pendingActions |= CAPTURE_ACTION_REPAINT;
+                if (appState.capturePhase == 2) {
+                    solvePending = true;
+                    pendingActions |= CAPTURE_ACTION_UPDATE_OVERLAY;
+                }
+                continue;
+            }
+
+            CaptureEvent event = { job.type, job.timeMs, false, { 0, 0, 0 } };
+            if (job.frame) {
+                event.coordsRead = frames.decodeCoordinates(*job.frame, event.coords);
+            }
+            if (sessionLog) {
+                SessionRecord capture;
+                capture.kind = SESSION_RECORD_CAPTURE;
+                capture.keyType = job.type;
+                capture.keyTimeMs = job.timeMs;
+                sessionLog->append(capture);
+                if (job.type == CAPTURE_EVENT_DIRECTION_KEY) {
+                    SessionRecord decode;
+                    decode.kind = SESSION_RECORD_DECODE;
+                    decode.coordsRead = event.coordsRead;
+                    decode.coords = event.coords;
+                    sessionLog->append(decode);
+                }
+            }
+
+            unsigned int actions = machine.handleEvent(event);
+            if (actions & CAPTURE_ACTION_SOLVE) {
+                solvePending = true;
+            }
+            if (actions & CAPTURE_ACTION_CLEAR_RESULTS) {
+                // A reset makes the throw waiting to be solved stale
+                if (solvePending) metrics.supersededSolves.add();
+                solvePending = false;
+                pendingActions &= ~CAPTURE_ACTION_COPY_RESULTS;
+                strongholdCandidates.clear();
+                strongholdRoute = RoutePlan();
+                nextThrowRecommendations.clear();
+            }
+            pendingActions = mergeCaptureActions(pendingActions, actions);
+        }
+
+        // Let presses that arrived meanwhile in first; one of them may supersede the solve.
+        // A solve still goes ahead with the state after them, and a steady stream of
+        // presses holds it back for CAPTURE_MAX_DEFER_MS at most.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!jobs.empty() && !overdue()) continue;
+        }
+        unpublished = false;
+
+        if (solvePending) {
+            TRACE_SPAN("worker solve");
+            solveCapturedThrow(machine.solveTargetDistance());
+            strongholdRoute = planStrongholdRoute(appState.coord2.x, appState.coord2.z, strongholdCandidates);
+            nextThrowRecommendations = recommendNextThrow(appState.coord2.x, appState.coord2.z, strongholdCandidates);
+            if (sessionLog) sessionLog->append(makeSessionSolveRecord(appState, strongholdCandidates));
+            solvePending = false;
+        }
+        if ((pendingActions & CAPTURE_ACTION_COPY_RESULTS) && publisher) {
+            publisher->publish(makeResultSnapshot(sequence + 1, appState, strongholdCandidates));
+        }
+
+        publishSnapshot(pendingActions & ~(CAPTURE_ACTION_SOLVE | CAPTURE_ACTION_CLEAR_RESULTS | CAPTURE_ACTION_COPY_RESULTS));
+        pendingActions = CAPTURE_ACTION_NONE;
+    }
+}
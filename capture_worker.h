@@ -0,0 +1,120 @@
+#pragma once
+#define NOMINMAX
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "capture_state_machine.h"
+#include "route_planner.h"
+#include "throw_recommender.h"
+#include "solver_config.h"
+#include "result_sinks.h"
+
+// Runs the hotkey work (HUD capture, OCR, state machine, solve, route and next-throw
+// planning) on one worker thread so the UI thread only queues key presses and paints.
+// While running, the worker thread owns the state machine, its ApplicationState,
+// the solver globals and solverConfig; the UI reads immutable CaptureSnapshots.
+
+class SessionLogWriter;
+
+// Longest a waiting solve and snapshot are put off for presses that keep arriving
+const double CAPTURE_MAX_DEFER_MS = 50.0;
+
+// A HUD image taken at a direction press, decoded later on the worker thread
+class HudFrame {
+public:
+    virtual ~HudFrame() {}
+};
+
+// Reads the player position from the game HUD. grabFrame is called by submit, on the
+// thread and at the moment of the press; decodeCoordinates runs on the worker thread.
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+    // nullptr when there is nothing to capture
+    virtual std::shared_ptr<const HudFrame> grabFrame() = 0;
+    virtual bool decodeCoordinates(const HudFrame& frame, Vec3& coords) = 0;
+};
+
+// Everything the UI shows after a job, never modified once published
+struct CaptureSnapshot {
+    uint64_t sequence = 0;
+    unsigned int actions = 0;   // CaptureAction flags left for the UI (overlay, repaint)
+    ApplicationState state;
+    std::vector<StrongholdCandidate> candidates;
+    RoutePlan route;
+    std::vector<ThrowRecommendation> nextThrows;
+    SolverConfig config;        // Settings the candidates were solved with
+};
+
+class CaptureWorker {
+public:
+    // notify is called on the worker thread whenever takeSnapshot has something new.
+    // Key presses, HUD reads, settings and solves go to sessionLog when one is given.
+    CaptureWorker(CaptureStateMachine& machine, FrameSource& frames, std::function<void()> notify,
+        ResultPublisher* publisher = nullptr, SessionLogWriter* sessionLog = nullptr);
+    ~CaptureWorker() { stop(); }
+    CaptureWorker(const CaptureWorker&) = delete;
+    CaptureWorker& operator=(const CaptureWorker&) = delete;
+
+    // Queue a key press; timeMs is the press time on the captureClockMs clock.
+    // A direction press grabs the HUD here, before returning.
+    void submit(CaptureEventType type, double timeMs);
+
+    // Queue new settings, applied between jobs; the current throw is solved again with them
+    void submitConfig(const SolverConfig& config);
+
+    // Queue a confirmation that the player stands at the stronghold; the HUD is grabbed
+    // here like for a direction press and the position goes to the session log as an OUTCOME
+    void submitOutcome(double timeMs);
+
+    // Latest snapshot and the actions of every snapshot since the previous call.
+    // Returns nullptr when nothing was published since then.
+    std::shared_ptr<const CaptureSnapshot> takeSnapshot(unsigned int& actions);
+
+    // Finish the queued jobs and join the worker; the state machine is the caller's again
+    void stop();
+
+private:
+    enum CaptureJobKind {
+        CAPTURE_JOB_KEY,
+        CAPTURE_JOB_CONFIG,
+        CAPTURE_JOB_OUTCOME
+    };
+
+    struct CaptureJob {
+        CaptureJobKind kind;
+        CaptureEventType type;
+        double timeMs;
+        std::shared_ptr<const HudFrame> frame;  // Direction presses and outcomes only
+        SolverConfig config;
+    };
+
+    void run();
+    void publishSnapshot(unsigned int actions);
+
+    CaptureStateMachine& machine;
+    FrameSource& frames;
+    std::function<void()> notify;
+    ResultPublisher* publisher;
+    SessionLogWriter* sessionLog;
+    uint64_t sequence = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<CaptureJob> jobs;
+    bool stopping = false;
+    std::thread worker;
+
+    // Published snapshot and the actions accumulated until the UI takes it
+    std::mutex snapshotMutex;
+    std::shared_ptr<const CaptureSnapshot> latest;
+    unsigned int latestActions = 0;
+};
+
+// Fold the actions of a later snapshot into earlier ones; of SHOW and HIDE overlay only
+// the later one is kept, so a reset followed by a new throw leaves the overlay shown
+unsigned int mergeCaptureActions(unsigned int earlier, unsigned int later);
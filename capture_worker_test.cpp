@@ -0,0 +1,140 @@
+// Checks that CaptureWorker takes the HUD at the key press rather than when the job
+// runs, that a steady stream of presses cannot hold snapshots back indefinitely and
+// that a confirmation logs the player's position as an OUTCOME record.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread capture_worker_test.cpp capture_worker.cpp capture_state_machine.cpp result_sinks.cpp route_planner.cpp throw_recommender.cpp session_log.cpp fixed_point_solver.cpp stronghold_calculator.cpp first_throw_table.cpp cell_lattice.cpp ring_prior.cpp distance_estimator.cpp solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o capture_worker_test
+#define NOMINMAX
+#include "capture_worker.h"
+#include "session_log.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+ApplicationState appState;
+
+struct PositionFrame : HudFrame {
+    int x;
+    bool readable;
+};
+
+// A HUD showing whatever position the test sets, with a slow OCR
+class SlowFrameSource : public FrameSource {
+public:
+    std::shared_ptr<const HudFrame> grabFrame() override {
+        auto frame = std::make_shared<PositionFrame>();
+        frame->x = position;
+        frame->readable = readable;
+        return frame;
+    }
+
+    bool decodeCoordinates(const HudFrame& frame, Vec3& coords) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(decodeMs));
+        const PositionFrame& shown = static_cast<const PositionFrame&>(frame);
+        coords = { shown.x, 64, 0 };
+        decoded.push_back(coords.x);  // Worker thread only
+        return shown.readable;
+    }
+
+    std::atomic<int> position{ 0 };
+    std::atomic<bool> readable{ true };
+    int decodeMs = 0;
+    std::vector<int> decoded;
+};
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+static void checkPositionAtPress() {
+    appState = ApplicationState();
+    CaptureStateMachine machine(appState);
+    SlowFrameSource frames;
+    frames.decodeMs = 20;
+
+    CaptureWorker worker(machine, frames, nullptr);
+    // The player walks on while the worker is still decoding the earlier presses
+    for (int press = 0; press < 3; press++) {
+        frames.position = 100 * (press + 1);
+        worker.submit(CAPTURE_EVENT_DIRECTION_KEY, press * 10.0);
+        frames.position = -1;
+    }
+    worker.stop();
+
+    check(frames.decoded.size() == 3, "every direction press is decoded");
+    for (size_t i = 0; i < frames.decoded.size(); i++) {
+        check(frames.decoded[i] == 100 * (int)(i + 1), "each press decodes the HUD from its own key press");
+    }
+}
+
+static void checkSteadyPresses() {
+    appState = ApplicationState();
+    CaptureStateMachine machine(appState);
+    SlowFrameSource frames;
+    frames.decodeMs = 5;
+    frames.readable = false;
+
+    // Presses arrive faster than they are decoded, so the queue never runs dry
+    std::atomic<int> snapshots{ 0 };
+    CaptureWorker worker(machine, frames, [&snapshots] { snapshots++; });
+    unsigned int actions;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(300)) {
+        worker.submit(CAPTURE_EVENT_DIRECTION_KEY, 0.0);
+        worker.takeSnapshot(actions);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int duringPresses = snapshots;
+    worker.stop();
+
+    check(duringPresses >= 2, "snapshots keep coming while presses keep arriving");
+    std::cout << "300 ms of presses: " << duringPresses << " snapshots published meanwhile\n";
+}
+
+static void checkOutcome() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "capture_worker_test_log.bin";
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".idx");
+
+    appState = ApplicationState();
+    CaptureStateMachine machine(appState);
+    SlowFrameSource frames;
+    SessionLogWriter sessionLog;
+    check(sessionLog.open(path), "session log opens");
+    uint32_t session = sessionLog.session();
+
+    CaptureWorker worker(machine, frames, nullptr, nullptr, &sessionLog);
+    frames.position = 1300;
+    worker.submitOutcome(0.0);
+    frames.readable = false;    // Nothing is logged when the HUD cannot be read
+    worker.submitOutcome(10.0);
+    worker.stop();
+    sessionLog.stop();
+
+    SessionLogReader reader;
+    check(reader.open(path), "session log reads back");
+    int outcomes = 0;
+    for (const auto& record : reader.readSession(session)) {
+        if (record.kind != SESSION_RECORD_OUTCOME) continue;
+        outcomes++;
+        check(record.outcomeX == 1300 && record.outcomeZ == 0, "the outcome is the position at the confirmation");
+    }
+    check(outcomes == 1, "one OUTCOME record per readable confirmation");
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".idx");
+}
+
+int main() {
+    checkPositionAtPress();
+    checkSteadyPresses();
+    checkOutcome();
+
+    std::cout << (ok ? "All capture worker checks passed\n" : "Capture worker checks FAILED\n");
+    return ok ? 0 : 1;
+}
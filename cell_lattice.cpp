@@ -0,0 +1,244 @@
+#define NOMINMAX
+#include "cell_lattice.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+struct CellTile {
+    StrongholdCell cells[LATTICE_TILE_CELLS * LATTICE_TILE_CELLS];
+    bool present[LATTICE_TILE_CELLS * LATTICE_TILE_CELLS];
+};
+
+static std::unordered_map<uint64_t, std::unique_ptr<CellTile>> cellTiles;
+
+// Prior and distanceProbabilities key for each whole-block distance up to the last key
+struct PriorEntry {
+    double prob;
+    int distanceRange;
+};
+static std::vector<PriorEntry> priorTable;
+
+int strongholdCellMin(int index) {
+    if (index >= 0) {
+        return index * STRONGHOLD_CELL_STEP;
+    }
+    // Negative cells end a gap before the multiple of the step
+    return index * STRONGHOLD_CELL_STEP - STRONGHOLD_CELL_GAP - STRONGHOLD_CELL_SIZE;
+}
+
+// Cell index for a step of the uniform 432-block grid; the step just below the origin has no cell
+static bool cellIndexForStep(int step, int& index) {
+    if (step == -1) return false;
+    index = step >= 0 ? step : step + 1;
+    return true;
+}
+
+bool strongholdCellIndexAt(double coordinate, int& index) {
+    int step = (int)std::floor(coordinate / STRONGHOLD_CELL_STEP);
+    if (!cellIndexForStep(step, index)) return false;
+    double offset = coordinate - strongholdCellMin(index);
+    return offset >= 0 && offset < STRONGHOLD_CELL_SIZE;
+}
+
+static void buildPriorTable() {
+    int lastDistance = distanceProbabilities.rbegin()->first;
+    priorTable.resize(lastDistance + 1);
+    for (int distance = 0; distance <= lastDistance; distance++) {
+        // Closest entry, ties going to the first one
+        int closestDistance = 500;
+        double minDiff = std::abs(500 - distance);
+        for (auto& pair : distanceProbabilities) {
+            double diff = std::abs(pair.first - distance);
+            if (diff < minDiff) {
+                minDiff = diff;
+                closestDistance = pair.first;
+            }
+        }
+        priorTable[distance] = { distanceProbabilities[closestDistance], closestDistance };
+    }
+}
+
+double strongholdPriorAtDistance(double distanceFromOrigin, int* distanceRange) {
+    if (priorTable.empty()) buildPriorTable();
+    size_t index = std::min(priorTable.size() - 1, (size_t)std::max(0, (int)distanceFromOrigin));
+    if (distanceRange) *distanceRange = priorTable[index].distanceRange;
+    return priorTable[index].prob;
+}
+
+static int floorDiv(int value, int divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+static CellTile& tileAt(int tileX, int tileZ) {
+    uint64_t key = ((uint64_t)(uint32_t)tileX << 32) | (uint32_t)tileZ;
+    auto& tile = cellTiles[key];
+    if (tile) return *tile;
+
+    tile.reset(new CellTile());
+    for (int i = 0; i < LATTICE_TILE_CELLS; i++) {
+        for (int j = 0; j < LATTICE_TILE_CELLS; j++) {
+            int xIndex = tileX * LATTICE_TILE_CELLS + i;
+            int zIndex = tileZ * LATTICE_TILE_CELLS + j;
+
+            StrongholdCell& cell = tile->cells[i * LATTICE_TILE_CELLS + j];
+            cell.xMin = strongholdCellMin(xIndex);
+            cell.xMax = cell.xMin + STRONGHOLD_CELL_SIZE;
+            cell.zMin = strongholdCellMin(zIndex);
+            cell.zMax = cell.zMin + STRONGHOLD_CELL_SIZE;
+            cell.centerX = (cell.xMin + cell.xMax) / 2.0;
+            cell.centerZ = (cell.zMin + cell.zMax) / 2.0;
+            cell.distance = std::sqrt(cell.centerX * cell.centerX + cell.centerZ * cell.centerZ);
+            cell.prob = strongholdPriorAtDistance(cell.distance, &cell.distanceRange);
+            tile->present[i * LATTICE_TILE_CELLS + j] = cell.distance >= MIN_STRONGHOLD_DISTANCE;
+        }
+    }
+    return *tile;
+}
+
+const StrongholdCell* strongholdCellAt(int xIndex, int zIndex) {
+    int tileX = floorDiv(xIndex, LATTICE_TILE_CELLS);
+    int tileZ = floorDiv(zIndex, LATTICE_TILE_CELLS);
+    CellTile& tile = tileAt(tileX, tileZ);
+    int slot = (xIndex - tileX * LATTICE_TILE_CELLS) * LATTICE_TILE_CELLS + (zIndex - tileZ * LATTICE_TILE_CELLS);
+    return tile.present[slot] ? &tile.cells[slot] : nullptr;
+}
+
+// Cell indices whose extent along one axis comes within margin of the coordinate
+static void indexRangeNear(double coordinate, double margin, int& first, int& last) {
+    int firstStep = (int)std::floor((coordinate - margin - STRONGHOLD_CELL_SIZE) / STRONGHOLD_CELL_STEP);
+    int lastStep = (int)std::floor((coordinate + margin) / STRONGHOLD_CELL_STEP);
+    first = firstStep >= 0 ? firstStep : firstStep + 1;
+    last = lastStep >= 0 ? lastStep : lastStep + 1;
+}
+
+void strongholdCellsNear(double x, double z, double margin, std::vector<const StrongholdCell*>& cells) {
+    cells.clear();
+    int firstX, lastX, firstZ, lastZ;
+    indexRangeNear(x, margin, firstX, lastX);
+    indexRangeNear(z, margin, firstZ, lastZ);
+
+    for (int xIndex = firstX; xIndex <= lastX; xIndex++) {
+        for (int zIndex = firstZ; zIndex <= lastZ; zIndex++) {
+            const StrongholdCell* cell = strongholdCellAt(xIndex, zIndex);
+            if (!cell) continue;
+            double clampedX = std::max(cell->xMin, std::min(cell->xMax, x));
+            double clampedZ = std::max(cell->zMin, std::min(cell->zMax, z));
+            if (std::sqrt((clampedX - x) * (clampedX - x) + (clampedZ - z) * (clampedZ - z)) <= margin) {
+                cells.push_back(cell);
+            }
+        }
+    }
+}
+
+// Throw direction in degrees of the offset (dx, dz), 0 = -z and 90 = +x
+static double directionDegrees(double dx, double dz) {
+    return std::atan2(dx, -dz) * 180.0 / M_PI;
+}
+
+void strongholdCellsInWedge(double startX, double startZ, double angle, double halfAngle,
+    double minDistance, double maxDistance, double margin, std::vector<const StrongholdCell*>& cells) {
+    cells.clear();
+
+    // Bounding box of the annulus sector: its corners, plus the outer arc wherever it crosses an axis
+    double minX = startX, maxX = startX, minZ = startZ, maxZ = startZ;
+    bool first = true;
+    auto include = [&](double degrees, double distance) {
+        double radians = degrees * M_PI / 180.0;
+        double x = startX + distance * std::sin(radians);
+        double z = startZ - distance * std::cos(radians);
+        if (first) {
+            minX = maxX = x;
+            minZ = maxZ = z;
+            first = false;
+        }
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minZ = std::min(minZ, z);
+        maxZ = std::max(maxZ, z);
+    };
+    include(angle - halfAngle, minDistance);
+    include(angle - halfAngle, maxDistance);
+    include(angle + halfAngle, minDistance);
+    include(angle + halfAngle, maxDistance);
+    for (double axis = std::ceil((angle - halfAngle) / 90.0) * 90.0; axis <= angle + halfAngle; axis += 90.0) {
+        include(axis, maxDistance);
+    }
+
+    int firstX, lastX, firstZ, lastZ;
+    indexRangeNear((minX + maxX) / 2.0, (maxX - minX) / 2.0 + margin, firstX, lastX);
+    indexRangeNear((minZ + maxZ) / 2.0, (maxZ - minZ) / 2.0 + margin, firstZ, lastZ);
+
+    // Cells whose margin-expanded box can reach the sector, tested conservatively:
+    // the box lies within a circle around its center, so its angular extent is bounded
+    const double halfDiagonal = STRONGHOLD_CELL_SIZE * std::sqrt(0.5) + margin;
+    for (int xIndex = firstX; xIndex <= lastX; xIndex++) {
+        for (int zIndex = firstZ; zIndex <= lastZ; zIndex++) {
+            const StrongholdCell* cell = strongholdCellAt(xIndex, zIndex);
+            if (!cell) continue;
+
+            double nearX = std::max(cell->xMin, std::min(cell->xMax, startX)) - startX;
+            double nearZ = std::max(cell->zMin, std::min(cell->zMax, startZ)) - startZ;
+            double farX = std::max(std::abs(cell->xMin - startX), std::abs(cell->xMax - startX));
+            double farZ = std::max(std::abs(cell->zMin - startZ), std::abs(cell->zMax - startZ));
+            if (std::sqrt(nearX * nearX + nearZ * nearZ) > maxDistance + margin) continue;
+            if (std::sqrt(farX * farX + farZ * farZ) < minDistance - margin) continue;
+
+            double centerDistance = std::sqrt((cell->centerX - startX) * (cell->centerX - startX)
+                + (cell->centerZ - startZ) * (cell->centerZ - startZ));
+            if (centerDistance > halfDiagonal) {
+                double cellHalfAngle = std::asin(halfDiagonal / centerDistance) * 180.0 / M_PI;
+                double offset = std::remainder(directionDegrees(cell->centerX - startX, cell->centerZ - startZ) - angle, 360.0);
+                if (std::abs(offset) > halfAngle + cellHalfAngle) continue;
+            }
+            cells.push_back(cell);
+        }
+    }
+}
+
+void strongholdCellsAlongRay(double startX, double startZ, double dx, double dz, double maxDistance,
+    std::vector<const StrongholdCell*>& cells) {
+    cells.clear();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // Walk the uniform 432-block grid; each grid square holds at most one cell in its low corner
+    int stepX = (int)std::floor(startX / STRONGHOLD_CELL_STEP);
+    int stepZ = (int)std::floor(startZ / STRONGHOLD_CELL_STEP);
+    int directionX = dx > 0 ? 1 : -1;
+    int directionZ = dz > 0 ? 1 : -1;
+    double deltaX = dx != 0 ? STRONGHOLD_CELL_STEP / std::abs(dx) : infinity;
+    double deltaZ = dz != 0 ? STRONGHOLD_CELL_STEP / std::abs(dz) : infinity;
+    double nextX = dx != 0 ? ((stepX + (dx > 0 ? 1 : 0)) * (double)STRONGHOLD_CELL_STEP - startX) / dx : infinity;
+    double nextZ = dz != 0 ? ((stepZ + (dz > 0 ? 1 : 0)) * (double)STRONGHOLD_CELL_STEP - startZ) / dz : infinity;
+
+    double t = 0.0;
+    while (t <= maxDistance) {
+        int xIndex, zIndex;
+        if (cellIndexForStep(stepX, xIndex) && cellIndexForStep(stepZ, zIndex)) {
+            const StrongholdCell* cell = strongholdCellAt(xIndex, zIndex);
+            if (cell) cells.push_back(cell);
+        }
+
+        if (nextX < nextZ) {
+            t = nextX;
+            nextX += deltaX;
+            stepX += directionX;
+        }
+        else {
+            t = nextZ;
+            nextZ += deltaZ;
+            stepZ += directionZ;
+        }
+    }
+}
+
+void trimStrongholdCellCache() {
+    if (cellTiles.size() > LATTICE_MAX_CACHED_TILES) {
+        cellTiles.clear();
+    }
+}
+
+size_t cachedStrongholdTileCount() {
+    return cellTiles.size();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "app_state.h"
+
+// Virtual stronghold cell lattice. Cells are computed on demand from their indices
+// and cached in square tiles, so any world position works and only the tiles a
+// query touches are ever built. Not thread-safe: the solver and the heatmap export call it
+// from one thread only; heatmap worker threads read priors looked up before they start.
+
+const int STRONGHOLD_CELL_SIZE = 272;   // Blocks per cell side
+const int STRONGHOLD_CELL_GAP = 160;    // Blocks between neighbouring cells
+const int STRONGHOLD_CELL_STEP = STRONGHOLD_CELL_SIZE + STRONGHOLD_CELL_GAP; // 432 blocks between cell starts
+const double MIN_STRONGHOLD_DISTANCE = 512.0;   // Cells whose center is closer to the origin hold no stronghold
+
+const int LATTICE_TILE_CELLS = 16;              // Cells per tile side
+const size_t LATTICE_MAX_CACHED_TILES = 256;    // Cache is dropped past this between solves
+const double LATTICE_MAX_RAY_DISTANCE = 10000.0; // How far along a throw cells are considered
+
+// Lowest block coordinate of the cell with this index along one axis
+int strongholdCellMin(int index);
+
+// Index of the cell containing the block coordinate along one axis, false if it lies in a gap
+bool strongholdCellIndexAt(double coordinate, int& index);
+
+// Prior for a cell at this distance from the origin, and the distanceProbabilities entry it came from
+double strongholdPriorAtDistance(double distanceFromOrigin, int* distanceRange = nullptr);
+
+// Cell at the lattice index, nullptr if it holds no stronghold. Pointers stay valid
+// until trimStrongholdCellCache drops the tile.
+const StrongholdCell* strongholdCellAt(int xIndex, int zIndex);
+
+// Cells whose bounds come within margin of the point
+void strongholdCellsNear(double x, double z, double margin, std::vector<const StrongholdCell*>& cells);
+
+// Superset of the cells that come within margin of a point at minDistance to maxDistance
+// from the start, in a direction within halfAngle degrees of angle (0 = -z, 90 = +x)
+void strongholdCellsInWedge(double startX, double startZ, double angle, double halfAngle,
+    double minDistance, double maxDistance, double margin, std::vector<const StrongholdCell*>& cells);
+
+// Cells the ray crosses within maxDistance, in order along the ray
+void strongholdCellsAlongRay(double startX, double startZ, double dx, double dz, double maxDistance,
+    std::vector<const StrongholdCell*>& cells);
+
+// Drop cached tiles once the cache has grown past LATTICE_MAX_CACHED_TILES
+void trimStrongholdCellCache();
+size_t cachedStrongholdTileCount();
@@ -1,7 +1,10 @@
 #define NOMINMAX
 #include "coordinate_reader.h"
+#include "solver_config.h"
 
 std::unique_ptr<Bitmap> BitmapFromHWND(HWND hwnd) {
+    TRACE_SPAN("capture");
+    ScopedLatency latency(metrics.captureLatency);
     if (IsIconic(hwnd)) ShowWindow(hwnd, SW_RESTORE);
     RECT rc; GetWindowRect(hwnd, &rc);
     int width = rc.right - rc.left;
@@ -25,6 +28,12 @@ std::unique_ptr<Bitmap> BitmapFromHWND(HWND hwnd) {
 
 int GetShownCoordinates(HWND hwnd, Vec3* coordinates) {
     auto pBitmap = BitmapFromHWND(hwnd);
+    return DecodeShownCoordinates(pBitmap.get(), coordinates);
+}
+
+int DecodeShownCoordinates(Bitmap* pBitmap, Vec3* coordinates) {
+    TRACE_SPAN("decode");
+    ScopedLatency latency(metrics.decodeLatency);
     int width = pBitmap->GetWidth();
     int height = pBitmap->GetHeight();
     int searchWidth = std::max(width / 3, std::min(125, width));
@@ -34,25 +43,30 @@ int GetShownCoordinates(HWND hwnd, Vec3* coordinates) {
     Gdiplus::Rect rect(0, 0, searchWidth, searchHeight);
     pBitmap->LockBits(&rect, ImageLockModeRead, PixelFormat32bppARGB, &bitmapData);
 
+    int minStreak = solverConfig.ocrMinStreak;
     int startTextX = 0, startTextY = 0, streak = 0;
     int stride = bitmapData.Stride / sizeof(ARGB);
     ARGB* pixels = static_cast<ARGB*>(bitmapData.Scan0);
 
-    for (int y = 30; y < searchHeight; y++) {
+    for (int y = solverConfig.ocrSearchTop; y < searchHeight; y++) {
         for (int x = 8; x < searchWidth; x++) {
             if (pixels[y * stride + x] == 0xFFFFFFFF) {
                 if (!startTextX) { startTextX = x; startTextY = y; }
                 streak++;
             }
-            else if (streak < 4) streak = 0;
-            else if (streak >= 4) break;
+            else if (streak < minStreak) streak = 0;
+            else if (streak >= minStreak) break;
         }
-        if (streak >= 4) break;
+        if (streak >= minStreak) break;
     }
 
-    if (streak < 4) return 0;
-    int scale = streak / 4;
-    startTextX += 44 * scale;
+    if (streak < minStreak) {
+        pBitmap->UnlockBits(&bitmapData);
+        metrics.ocrFailure.add();
+        return 0;
+    }
+    int scale = streak / minStreak;
+    startTextX += solverConfig.ocrLabelOffset * scale;
 
     int coords[3] = { 0, 0, 0 };
     int index = 0;
@@ -104,13 +118,6 @@ int GetShownCoordinates(HWND hwnd, Vec3* coordinates) {
     coordinates->x = coords[0];
     coordinates->y = coords[1];
     coordinates->z = coords[2];
+    metrics.ocrSuccess.add();
     return 1;
-}
-
-double angleBetween(double x1, double y1, double x2, double y2) {
-    double dx = x2 - x1;
-    double dz = y2 - y1;
-    double angle = std::atan2(dx, -dz) * 180.0 / M_PI; // note the -dz
-    if (angle < 0) angle += 360.0;
-    return angle;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #define NOMINMAX
 #include "common.h"
+#include "trace.h"
+#include "metrics.h"
 
 // Function to capture bitmap from window
 std::unique_ptr<Bitmap> BitmapFromHWND(HWND hwnd);
@@ -8,5 +10,5 @@ std::unique_ptr<Bitmap> BitmapFromHWND(HWND hwnd);
 // Function to read coordinates from Minecraft window
 int GetShownCoordinates(HWND hwnd, Vec3* coordinates);
 
-// Utility function for angle calculation
-double angleBetween(double x1, double y1, double x2, double y2); 
+// Read the coordinates from a HUD image taken earlier by BitmapFromHWND
+int DecodeShownCoordinates(Bitmap* bitmap, Vec3* coordinates);
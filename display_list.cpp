@@ -0,0 +1,455 @@
+#define NOMINMAX
+#include "display_list.h"
+#include <algorithm>
+#include <cmath>
+#include "number_format.h"
+
+// Overlay colors
+const uint32_t OVERLAY_BACKGROUND = 0xF00F1423;
+const uint32_t OVERLAY_BORDER = 0xFF6496C8;
+const uint32_t OVERLAY_WHITE = 0xFFFFFFFF;
+const uint32_t OVERLAY_LIGHT_GRAY = 0xFFC8C8C8;
+const uint32_t OVERLAY_GREEN = 0xFF78FF78;
+const uint32_t OVERLAY_YELLOW = 0xFFFFDC64;
+const uint32_t OVERLAY_ORANGE = 0xFFFFA500;
+const uint32_t OVERLAY_RED = 0xFFFF7878;
+const uint32_t OVERLAY_CYAN = 0xFF64C8FF;
+
+// Main window colors
+const uint32_t MAIN_BACKGROUND = 0xFF1E1E1E;
+const uint32_t MAIN_WHITE = 0xFFF0F0F0;
+const uint32_t MAIN_GRAY = 0xFFB4B4B4;
+const uint32_t MAIN_GREEN = 0xFF64C864;
+const uint32_t MAIN_YELLOW = 0xFFFFDC64;
+const uint32_t MAIN_RED = 0xFFFF6464;
+
+const DisplayFontSpec& displayFontSpec(DisplayFont font) {
+    static const DisplayFontSpec specs[FONT_COUNT] = {
+        { L"Consolas", 15, true },   // FONT_OVERLAY_HEADER
+        { L"Consolas", 13, true },   // FONT_OVERLAY_COORD
+        { L"Consolas", 12, false },  // FONT_OVERLAY_INFO
+        { L"Consolas", 11, false },  // FONT_OVERLAY_SMALL
+        { L"Segoe UI", 14, true },   // FONT_MAIN_HEADER
+        { L"Segoe UI", 12, false },  // FONT_MAIN_NORMAL
+        { L"Segoe UI", 10, false },  // FONT_MAIN_SMALL
+        { L"Segoe UI", 11, false },  // FONT_MAIN_TABLE
+        { L"Segoe UI", 10, true },   // FONT_MAIN_ERROR
+    };
+    return specs[font];
+}
+
+// Items carry their text inline; room for a full list up front avoids copying them on growth
+static const size_t DISPLAY_LIST_RESERVE = 64;
+
+bool operator==(const DisplayItem& a, const DisplayItem& b) {
+    return a.kind == b.kind && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height
+        && a.color == b.color && a.font == b.font && a.penWidth == b.penWidth
+        && a.text.size() == b.text.size() && std::equal(a.text.begin(), a.text.end(), b.text.begin());
+}
+
+static void addFill(DisplayList& list, int x, int y, int width, int height, uint32_t color) {
+    DisplayItem item = {};
+    item.kind = DISPLAY_FILL_RECT;
+    item.x = x;
+    item.y = y;
+    item.width = width;
+    item.height = height;
+    item.color = color;
+    item.bounds = { x, y, x + width, y + height };
+    list.push_back(item);
+}
+
+static void addFrame(DisplayList& list, int x, int y, int width, int height, int penWidth, uint32_t color) {
+    DisplayItem item = {};
+    item.kind = DISPLAY_FRAME_RECT;
+    item.x = x;
+    item.y = y;
+    item.width = width;
+    item.height = height;
+    item.penWidth = penWidth;
+    item.color = color;
+    int half = (penWidth + 1) / 2;
+    item.bounds = { x - half, y - half, x + width + half + 1, y + height + half + 1 };
+    list.push_back(item);
+}
+
+// Text runs are invalidated as horizontal bands from their origin to the right edge,
+// one line height per line of text, since glyph extents are only known to the renderer
+static void addText(DisplayList& list, int x, int y, int right, const wchar_t* text,
+    DisplayFont font, uint32_t color) {
+    list.emplace_back();
+    DisplayItem& item = list.back();
+    item.kind = DISPLAY_TEXT;
+    item.x = x;
+    item.y = y;
+    item.color = color;
+    item.font = font;
+    item.text.text(text);
+
+    int lines = 1 + (int)std::count(item.text.begin(), item.text.end(), L'\n');
+    int lineHeight = (int)std::ceil(displayFontSpec(font).size * 1.6);
+    item.bounds = { x, y, right, y + lines * lineHeight };
+}
+
+static void addText(DisplayList& list, int x, int y, int right, const WideFormatBuffer& text,
+    DisplayFont font, uint32_t color) {
+    addText(list, x, y, right, text.c_str(), font, color);
+}
+
+static void addText(DisplayList& list, int x, int y, int right, const std::wstring& text,
+    DisplayFont font, uint32_t color) {
+    addText(list, x, y, right, text.c_str(), font, color);
+}
+
+static void addWrappedText(DisplayList& list, int x, int y, int width, int height, const std::wstring& text,
+    DisplayFont font, uint32_t color) {
+    DisplayItem item = {};
+    item.kind = DISPLAY_WRAPPED_TEXT;
+    item.x = x;
+    item.y = y;
+    item.width = width;
+    item.height = height;
+    item.color = color;
+    item.font = font;
+    item.text.text(text);
+    item.bounds = { x, y, x + width, y + height };
+    list.push_back(item);
+}
+
+DisplayList buildOverlayDisplayList(const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates, const SolverConfig& config, int width, int height) {
+    DisplayList list;
+    list.reserve(DISPLAY_LIST_RESERVE);
+
+    // Dark background, border and grip indicator in the top-left corner
+    addFill(list, 0, 0, width, height, OVERLAY_BACKGROUND);
+    addFrame(list, 1, 1, width - 2, height - 2, 2, OVERLAY_BORDER);
+    addFill(list, 3, 3, 8, 8, OVERLAY_BORDER);
+
+    int y = 12;
+    int x = 18; // Slightly more margin to account for grip
+
+    addText(list, x, y, width, L"Stronghold Finder", FONT_OVERLAY_HEADER, OVERLAY_WHITE);
+    y += 22;
+
+    // Status line
+    if (state.f4PressedFirst && state.distanceKeyPresses > 0) {
+        WideFormatBuffer text;
+        text.text(L"Dist: ").fixed(state.calculatedDistance, 0)
+            .text(L" blocks (x").integer(state.distanceKeyPresses).text(L")");
+        addText(list, x, y, width, text, FONT_OVERLAY_SMALL, OVERLAY_YELLOW);
+        y += 18;
+    }
+    else if (state.tabPressedFirst) {
+        addText(list, x, y, width, L"Distance calculation skipped", FONT_OVERLAY_SMALL, OVERLAY_LIGHT_GRAY);
+        y += 18;
+    }
+    else if (state.capturePhase == 0) {
+        addText(list, x, y, width, L"Press hotkeys to start", FONT_OVERLAY_SMALL, OVERLAY_LIGHT_GRAY);
+        y += 18;
+    }
+
+    // Show validation error if present
+    if (state.distanceValidationFailed) {
+        addText(list, x, y, width, L"⚠ DISTANCE MISMATCH!", FONT_OVERLAY_SMALL, OVERLAY_RED);
+        y += 18;
+    }
+
+    // Show current phase
+    if (state.capturePhase == 1) {
+        addText(list, x, y, width, L"→ Press direction key at 2nd point", FONT_OVERLAY_SMALL, OVERLAY_ORANGE);
+        y += 18;
+    }
+    else if (state.capturePhase == 2 && !candidates.empty()) {
+        WideFormatBuffer text;
+        text.text(L"Direction: ").fixed(state.lastAngle, 1).text(L"°");
+        addText(list, x, y, width, text, FONT_OVERLAY_INFO, OVERLAY_LIGHT_GRAY);
+        y += 22;
+
+        addText(list, x, y, width, L"Overworld      Nether      Prob", FONT_OVERLAY_SMALL, OVERLAY_LIGHT_GRAY);
+        y += 16;
+
+        // Show top stronghold locations (6 by default for the smaller window)
+        int maxCandidates = std::min(config.overlayCandidates, (int)candidates.size());
+        for (int i = 0; i < maxCandidates; i++) {
+            const auto& candidate = candidates[i];
+
+            // Color coding based on probability
+            uint32_t color;
+            if (i == 0) {
+                color = state.distanceValidationFailed ? OVERLAY_RED : OVERLAY_GREEN;
+            }
+            else if (candidate.conditionalProb > 0.1) {
+                color = OVERLAY_YELLOW;
+            }
+            else {
+                color = OVERLAY_LIGHT_GRAY;
+            }
+
+            WideFormatBuffer coordText;
+            coordText.integer(candidate.projectionX, 5).text(L",").integer(candidate.projectionZ, 5);
+
+            WideFormatBuffer netherText;
+            netherText.integer(candidate.netherX, 4).text(L",").integer(candidate.netherZ, 4);
+
+            WideFormatBuffer probText;
+            probText.fixed(candidate.conditionalProb * 100.0, 0).text(L"%");
+
+            addText(list, x, y, x + 110, coordText, FONT_OVERLAY_COORD, color);
+            addText(list, x + 110, y, x + 200, netherText, FONT_OVERLAY_COORD, OVERLAY_CYAN);
+            addText(list, x + 200, y, i == 0 ? x + 240 : width, probText, FONT_OVERLAY_COORD, color);
+
+            // Show distance for top candidate
+            if (i == 0) {
+                WideFormatBuffer distText;
+                distText.text(L" ").integer(candidate.distance).text(L"m");
+                addText(list, x + 240, y + 1, width, distText, FONT_OVERLAY_SMALL, OVERLAY_LIGHT_GRAY);
+            }
+
+            y += 20;
+        }
+
+        y += 8;
+        addText(list, x, y, width, L"Drag to move • Reset with hotkey", FONT_OVERLAY_SMALL, OVERLAY_LIGHT_GRAY);
+    }
+    else if (state.capturePhase == 0 && state.f4PressedFirst) {
+        addText(list, x, y, width, L"→ Now press direction key twice", FONT_OVERLAY_SMALL, OVERLAY_ORANGE);
+    }
+
+    return list;
+}
+
+DisplayList buildMainDisplayList(const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates, const RoutePlan& route,
+    const std::vector<ThrowRecommendation>& nextThrows, const SolverConfig& config, const MainWindowLabels& labels,
+    int width, int height) {
+    DisplayList list;
+    list.reserve(DISPLAY_LIST_RESERVE);
+    addFill(list, 0, 0, width, height, MAIN_BACKGROUND);
+
+    int marginX = 15;
+    int y = 15;
+
+    addText(list, marginX, y, width, L"Minecraft Stronghold Finder", FONT_MAIN_HEADER, MAIN_WHITE);
+    y += 35;
+
+    // Hotkey configuration section
+    addText(list, marginX, y, width, L"Hotkey Settings:", FONT_MAIN_NORMAL, MAIN_WHITE);
+    y += 20;
+
+    // Direction hotkey
+    std::wstring directionText = L"Direction Key: " + labels.directionKeyName;
+    if (labels.waitingForDirectionKey) {
+        directionText += L" (Press new key...)";
+    }
+    addText(list, marginX, y, width, directionText, FONT_MAIN_NORMAL,
+        labels.waitingForDirectionKey ? MAIN_YELLOW : MAIN_GRAY);
+    y += 20;
+
+    // Distance hotkey
+    std::wstring distanceText = L"Distance Key: " + labels.distanceKeyName;
+    if (labels.waitingForDistanceKey) {
+        distanceText += L" (Press new key...)";
+    }
+    addText(list, marginX, y, width, distanceText, FONT_MAIN_NORMAL,
+        labels.waitingForDistanceKey ? MAIN_YELLOW : MAIN_GRAY);
+    y += 20;
+
+    // Confirm hotkey, pressed at the stronghold to log where it was
+    std::wstring confirmText = L"Confirm Key: " + labels.confirmKeyName;
+    if (labels.waitingForConfirmKey) {
+        confirmText += L" (Press new key...)";
+    }
+    addText(list, marginX, y, width, confirmText, FONT_MAIN_NORMAL,
+        labels.waitingForConfirmKey ? MAIN_YELLOW : MAIN_GRAY);
+    y += 30;
+
+    WideFormatBuffer positionText;
+    positionText.text(L"Current Position:\n")
+        .text(L"X: ").integer(state.latestCoords.x).text(L"\n")
+        .text(L"Y: ").integer(state.latestCoords.y).text(L"\n")
+        .text(L"Z: ").integer(state.latestCoords.z).text(L"\n");
+    addText(list, marginX, y, width, positionText, FONT_MAIN_NORMAL, MAIN_GRAY);
+    y += 85;
+
+    // Distance info
+    if (state.f4PressedFirst && state.distanceKeyPresses > 0) {
+        WideFormatBuffer distInfoText;
+        distInfoText.text(labels.distanceKeyName).text(L" Distance Calculation:\n")
+            .text(L"Key presses: ").integer(state.distanceKeyPresses).text(L"\n")
+            .text(L"Calculated distance: ").fixed(state.calculatedDistance, 0).text(L" blocks\n");
+        addText(list, marginX, y, width, distInfoText, FONT_MAIN_NORMAL, MAIN_YELLOW);
+        y += 55;
+    }
+    else if (state.tabPressedFirst) {
+        std::wstring skipText = labels.distanceKeyName + L" key disabled (" + labels.directionKeyName + L" was pressed first)\n";
+        addText(list, marginX, y, width, skipText, FONT_MAIN_NORMAL, MAIN_GRAY);
+        y += 20;
+    }
+
+    // Show validation error in main window
+    if (state.distanceValidationFailed && !state.validationErrorMessage.empty()) {
+        addWrappedText(list, marginX, y, 450, 60, state.validationErrorMessage, FONT_MAIN_ERROR, MAIN_RED);
+        y += 65;
+    }
+
+    // Rejected config.ini values; the previous values stay in effect
+    if (!labels.configError.empty()) {
+        addWrappedText(list, marginX, y, 450, 40, labels.configError, FONT_MAIN_ERROR, MAIN_RED);
+        y += 45;
+    }
+
+    if (state.capturePhase == 0) {
+        if (!state.f4PressedFirst && !state.tabPressedFirst) {
+            std::wstring instrText = L"Instructions:\n"
+                L"1. Press " + labels.distanceKeyName + L" multiple times for distance calculation\n"
+                L"2. Press " + labels.directionKeyName + L" twice for direction calculation\n"
+                L"   (or press " + labels.directionKeyName + L" first to skip distance)";
+            addText(list, marginX, y, width, instrText, FONT_MAIN_NORMAL, MAIN_WHITE);
+        }
+        else if (state.tabPressedFirst) {
+            std::wstring skipInstrText = labels.directionKeyName + L" pressed first - distance calculation skipped.\n"
+                L"Press " + labels.directionKeyName + L" again for direction calculation.";
+            addText(list, marginX, y, width, skipInstrText, FONT_MAIN_NORMAL, MAIN_WHITE);
+        }
+        else if (state.f4PressedFirst) {
+            std::wstring distInstrText = L"Distance calculated! Now press " + labels.directionKeyName + L" twice for direction.";
+            addText(list, marginX, y, width, distInstrText, FONT_MAIN_NORMAL, MAIN_GREEN);
+        }
+    }
+    else if (state.capturePhase == 1) {
+        WideFormatBuffer firstText;
+        firstText.text(L"First point captured: (").integer(state.coord1.x).text(L", ").integer(state.coord1.z).text(L")\n")
+            .text(L"Press ").text(labels.directionKeyName).text(L" at second point to calculate direction.");
+        addText(list, marginX, y, width, firstText, FONT_MAIN_NORMAL, MAIN_YELLOW);
+    }
+    else if (state.capturePhase == 2) {
+        WideFormatBuffer angleText;
+        angleText.text(L"Eye Direction: ").fixed(state.lastAngle, 1).text(L"°\n");
+
+        if (!candidates.empty()) {
+            angleText.text(L"\nStronghold Locations (Overworld / Nether):");
+        }
+        else {
+            angleText.text(L"\nNo strongholds found in this direction.");
+        }
+
+        addText(list, marginX, y, width, angleText, FONT_MAIN_NORMAL,
+            state.distanceValidationFailed ? MAIN_RED : MAIN_GREEN);
+
+        if (!candidates.empty()) {
+            y += 55;
+
+            // Table header
+            addText(list, marginX, y, width, L"Rank  Overworld Coords    Nether Coords      Probability  Distance",
+                FONT_MAIN_SMALL, MAIN_GRAY);
+            y += 20;
+
+            // Show detailed candidate list
+            int maxCandidates = std::min(config.mainWindowCandidates, (int)candidates.size());
+            for (int i = 0; i < maxCandidates; i++) {
+                const auto& candidate = candidates[i];
+
+                WideFormatBuffer rowText;
+                rowText.text(L"#").integer(i + 1).text(L"   (")
+                    .integer(candidate.projectionX, 5).text(L",").integer(candidate.projectionZ, 5).text(L")   (")
+                    .integer(candidate.netherX, 4).text(L",").integer(candidate.netherZ, 4).text(L")      ")
+                    .fixed(candidate.conditionalProb * 100.0, 1, 5).text(L"%     ")
+                    .integer(candidate.distance).text(L"m");
+
+                uint32_t color;
+                if (i == 0) {
+                    color = state.distanceValidationFailed ? MAIN_RED : MAIN_GREEN;
+                }
+                else if (candidate.conditionalProb > 0.1) {
+                    color = MAIN_YELLOW;
+                }
+                else {
+                    color = MAIN_GRAY;
+                }
+
+                addText(list, marginX, y, width, rowText, FONT_MAIN_TABLE, color);
+                y += 18;
+            }
+
+            y += 10;
+
+            // Suggested visiting order, nether legs marked
+            if (!route.stops.empty()) {
+                WideFormatBuffer routeText;
+                routeText.text(L"Route:");
+                int maxStops = std::min(6, (int)route.stops.size());
+                for (int i = 0; i < maxStops; i++) {
+                    const auto& stop = route.stops[i];
+                    routeText.text(i == 0 ? L" " : L" → ").text(L"#").integer(stop.candidateIndex + 1);
+                    if (stop.viaNether) routeText.text(L" (nether)");
+                }
+                if (maxStops < (int)route.stops.size()) routeText.text(L" …");
+                routeText.text(L"   expected ").fixed(route.expectedCost, 0).text(L" blocks");
+                addText(list, marginX, y, width, routeText, FONT_MAIN_SMALL, MAIN_GRAY);
+                y += 18;
+            }
+
+            // Still ambiguous: where another throw helps most
+            if (!nextThrows.empty()) {
+                const auto& best = nextThrows[0];
+                WideFormatBuffer throwText;
+                throwText.text(L"Next throw: (").integer(best.x).text(L", ").integer(best.z).text(L"), ")
+                    .fixed(best.walkDistance, 0).text(L" blocks away, +").fixed(best.expectedGain, 1).text(L" bits");
+                addText(list, marginX, y, width, throwText, FONT_MAIN_SMALL, MAIN_YELLOW);
+                y += 18;
+            }
+
+            std::wstring resetText = L"Top locations copied to clipboard. Press " + labels.directionKeyName + L" to reset.";
+            addText(list, marginX, y, width, resetText, FONT_MAIN_NORMAL, MAIN_WHITE);
+        }
+    }
+
+    return list;
+}
+
+static bool rectsTouch(const DisplayRect& a, const DisplayRect& b) {
+    return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+}
+
+std::vector<DisplayRect> diffDisplayLists(const DisplayList& previous, const DisplayList& next) {
+    std::vector<DisplayRect> dirty;
+    std::vector<bool> matched(next.size(), false);
+
+    // Items present in both lists are unchanged; everything else is dirty where it was and where it is
+    for (const auto& item : previous) {
+        bool found = false;
+        for (size_t j = 0; j < next.size(); j++) {
+            if (!matched[j] && next[j] == item) {
+                matched[j] = true;
+                found = true;
+                break;
+            }
+        }
+        if (!found) dirty.push_back(item.bounds);
+    }
+    for (size_t j = 0; j < next.size(); j++) {
+        if (!matched[j]) dirty.push_back(next[j].bounds);
+    }
+
+    // Merge overlapping rectangles until none touch
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirty.size() && !merged; i++) {
+            for (size_t j = i + 1; j < dirty.size(); j++) {
+                if (rectsTouch(dirty[i], dirty[j])) {
+                    dirty[i].left = std::min(dirty[i].left, dirty[j].left);
+                    dirty[i].top = std::min(dirty[i].top, dirty[j].top);
+                    dirty[i].right = std::max(dirty[i].right, dirty[j].right);
+                    dirty[i].bottom = std::max(dirty[i].bottom, dirty[j].bottom);
+                    dirty.erase(dirty.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return dirty;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#define NOMINMAX
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "app_state.h"
+#include "route_planner.h"
+#include "throw_recommender.h"
+#include "solver_config.h"
+#include "number_format.h"
+
+// Retained display lists for the overlay and the main window. The builders turn
+// appState and the candidate list into text runs and rectangles without touching
+// Win32, so layout and diffing can be checked headlessly.
+
+enum DisplayFont {
+    FONT_OVERLAY_HEADER,
+    FONT_OVERLAY_COORD,
+    FONT_OVERLAY_INFO,
+    FONT_OVERLAY_SMALL,
+    FONT_MAIN_HEADER,
+    FONT_MAIN_NORMAL,
+    FONT_MAIN_SMALL,
+    FONT_MAIN_TABLE,
+    FONT_MAIN_ERROR,
+    FONT_COUNT
+};
+
+struct DisplayFontSpec {
+    const wchar_t* family;
+    float size;     // Pixels
+    bool bold;
+};
+
+// Font used to draw a DisplayFont
+const DisplayFontSpec& displayFontSpec(DisplayFont font);
+
+enum DisplayItemKind {
+    DISPLAY_FILL_RECT,
+    DISPLAY_FRAME_RECT,
+    DISPLAY_TEXT,
+    DISPLAY_WRAPPED_TEXT
+};
+
+// Text of a display item, held inline so building a list allocates nothing per text
+// run. The longest run (a main window table row) is about 75 characters; longer text is cut.
+const size_t DISPLAY_TEXT_CAPACITY = 128;
+typedef FormatBuffer<wchar_t, DISPLAY_TEXT_CAPACITY> DisplayText;
+
+struct DisplayRect {
+    int left, top, right, bottom;
+};
+
+struct DisplayItem {
+    DisplayItemKind kind;
+    DisplayRect bounds;     // Area the item may touch, used for invalidation
+    int x, y;               // Text origin or rectangle position
+    int width, height;      // Rectangle size or wrap box
+    uint32_t color;         // 0xAARRGGBB
+    DisplayFont font;
+    int penWidth;           // Frame rectangles only
+    DisplayText text;
+};
+
+typedef std::vector<DisplayItem> DisplayList;
+
+bool operator==(const DisplayItem& a, const DisplayItem& b);
+inline bool operator!=(const DisplayItem& a, const DisplayItem& b) { return !(a == b); }
+
+// Main window inputs that do not live in appState
+struct MainWindowLabels {
+    std::wstring directionKeyName;
+    std::wstring distanceKeyName;
+    bool waitingForDirectionKey;
+    bool waitingForDistanceKey;
+    std::wstring confirmKeyName;
+    bool waitingForConfirmKey;
+    std::wstring configError;       // First config.ini problem, empty when it loaded cleanly
+};
+
+// config gives the number of candidate rows shown
+DisplayList buildOverlayDisplayList(const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates, const SolverConfig& config, int width, int height);
+
+DisplayList buildMainDisplayList(const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates, const RoutePlan& route,
+    const std::vector<ThrowRecommendation>& nextThrows, const SolverConfig& config, const MainWindowLabels& labels,
+    int width, int height);
+
+// Rectangles that must be repainted to go from previous to next, overlapping areas merged
+std::vector<DisplayRect> diffDisplayLists(const DisplayList& previous, const DisplayList& next);
@@ -0,0 +1,152 @@
+// Checks diffDisplayLists on unchanged, moved, added and removed items and on an F4
+// press in the real overlay layout, then times building and diffing both windows.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 display_list_benchmark.cpp display_list.cpp number_format.cpp -o display_list_benchmark
+#define NOMINMAX
+#include "display_list.h"
+#include <chrono>
+#include <iostream>
+
+const int OVERLAY_WIDTH = 380;
+const int OVERLAY_HEIGHT = 320;
+const int MAIN_WIDTH = 500;
+const int MAIN_HEIGHT = 700;
+const int BENCHMARK_FRAMES = 20000;
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+static bool sameRect(const DisplayRect& a, const DisplayRect& b) {
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+static bool covers(const std::vector<DisplayRect>& dirty, const DisplayRect& rect) {
+    for (const auto& d : dirty) {
+        if (d.left <= rect.left && d.top <= rect.top && d.right >= rect.right && d.bottom >= rect.bottom) return true;
+    }
+    return false;
+}
+
+static DisplayItem textItem(int x, int y, const wchar_t* text) {
+    DisplayItem item = {};
+    item.kind = DISPLAY_TEXT;
+    item.x = x;
+    item.y = y;
+    item.color = 0xFFFFFFFF;
+    item.font = FONT_OVERLAY_COORD;
+    item.text.text(text);
+    item.bounds = { x, y, x + 100, y + 30 };
+    return item;
+}
+
+static void checkSyntheticLists() {
+    DisplayList previous = { textItem(10, 10, L"a"), textItem(10, 40, L"b"), textItem(10, 70, L"c") };
+
+    check(diffDisplayLists(previous, previous).empty(), "unchanged list has no dirty rectangles");
+
+    // Same items in another order are still unchanged
+    DisplayList reordered = { previous[2], previous[0], previous[1] };
+    check(diffDisplayLists(previous, reordered).empty(), "reordered list has no dirty rectangles");
+
+    // A moved item is dirty where it was and where it is; far apart they stay separate
+    DisplayList moved = previous;
+    moved[0] = textItem(10, 200, L"a");
+    auto dirty = diffDisplayLists(previous, moved);
+    check(dirty.size() == 2, "moved item gives two rectangles");
+    check(covers(dirty, previous[0].bounds) && covers(dirty, moved[0].bounds), "moved item covers old and new bounds");
+
+    DisplayList added = previous;
+    added.push_back(textItem(200, 200, L"d"));
+    dirty = diffDisplayLists(previous, added);
+    check(dirty.size() == 1 && sameRect(dirty[0], added.back().bounds), "added item gives exactly its bounds");
+
+    DisplayList removed = { previous[0], previous[2] };
+    dirty = diffDisplayLists(previous, removed);
+    check(dirty.size() == 1 && sameRect(dirty[0], previous[1].bounds), "removed item gives exactly its bounds");
+
+    // Touching changes merge into one rectangle; the unchanged item above them stays out
+    DisplayList recolored = previous;
+    recolored[1].color = 0xFFFF0000;
+    recolored[2].text.clear();
+    recolored[2].text.text(L"C");
+    dirty = diffDisplayLists(previous, recolored);
+    check(dirty.size() == 1 && dirty[0].top == 40 && dirty[0].bottom == 100, "touching changes merge into one rectangle");
+}
+
+static std::vector<StrongholdCandidate> sampleCandidates() {
+    std::vector<StrongholdCandidate> candidates;
+    for (int i = 0; i < 10; i++) {
+        StrongholdCandidate candidate = {};
+        candidate.projectionX = 1200 + 37 * i;
+        candidate.projectionZ = -2400 + 53 * i;
+        candidate.netherX = candidate.projectionX / 8;
+        candidate.netherZ = candidate.projectionZ / 8;
+        candidate.conditionalProb = 0.4 / (i + 1);
+        candidate.distance = 2600 + 10 * i;
+        candidate.bounds = L"(1024, -2560) to (1536, -2048)";
+        candidates.push_back(candidate);
+    }
+    return candidates;
+}
+
+static void checkOverlayF4Press() {
+    ApplicationState state;
+    state.f4PressedFirst = true;
+    state.distanceKeyPresses = 2;
+    state.calculatedDistance = 1400.0;
+    SolverConfig config;
+    std::vector<StrongholdCandidate> candidates;
+
+    DisplayList previous = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    check(diffDisplayLists(previous, buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT)).empty(),
+        "rebuilt overlay is unchanged");
+
+    // Another F4 press only changes the distance line
+    state.distanceKeyPresses = 3;
+    state.calculatedDistance = 1600.0;
+    auto dirty = diffDisplayLists(previous, buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT));
+    check(dirty.size() == 1, "F4 press dirties one rectangle");
+    check(!dirty.empty() && (dirty[0].bottom - dirty[0].top) * 4 < OVERLAY_HEIGHT, "F4 press dirties a single band, not the window");
+}
+
+int main() {
+    checkSyntheticLists();
+    checkOverlayF4Press();
+
+    // A result on screen while the player keeps moving: the position lines change every frame
+    ApplicationState state;
+    state.capturePhase = 2;
+    state.lastAngle = 123.4;
+    SolverConfig config;
+    std::vector<StrongholdCandidate> candidates = sampleCandidates();
+    RoutePlan route;
+    std::vector<ThrowRecommendation> nextThrows;
+    MainWindowLabels labels = { L"TAB", L"F4", false, false, L"F7", false, L"" };
+
+    DisplayList overlay = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    DisplayList main = buildMainDisplayList(state, candidates, route, nextThrows, config, labels, MAIN_WIDTH, MAIN_HEIGHT);
+    size_t dirtyRects = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+        state.latestCoords = { frame, 64, -frame };
+        DisplayList nextOverlay = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+        DisplayList nextMain = buildMainDisplayList(state, candidates, route, nextThrows, config, labels, MAIN_WIDTH, MAIN_HEIGHT);
+        dirtyRects += diffDisplayLists(overlay, nextOverlay).size() + diffDisplayLists(main, nextMain).size();
+        overlay.swap(nextOverlay);
+        main.swap(nextMain);
+    }
+    double frameUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+        / BENCHMARK_FRAMES;
+
+    std::cout << "Built and diffed both windows in " << frameUs << " us per frame ("
+        << overlay.size() << " overlay and " << main.size() << " main window items), "
+        << (double)dirtyRects / BENCHMARK_FRAMES << " dirty rectangles per frame\n";
+    std::cout << (ok ? "All display list checks passed\n" : "Display list checks FAILED\n");
+    return ok ? 0 : 1;
+}
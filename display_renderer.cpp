@@ -0,0 +1,179 @@
+#define NOMINMAX
+#include "display_renderer.h"
+
+// Fonts and brushes are created on first use instead of on every WM_PAINT
+static std::unique_ptr<FontFamily> fontFamilies[FONT_COUNT];
+static std::unique_ptr<Font> fonts[FONT_COUNT];
+static std::map<uint32_t, std::unique_ptr<SolidBrush>> brushes;
+
+static Color colorFromArgb(uint32_t argb) {
+    return Color((BYTE)(argb >> 24), (BYTE)(argb >> 16), (BYTE)(argb >> 8), (BYTE)argb);
+}
+
+static Font* GetDisplayFont(DisplayFont font) {
+    if (!fonts[font]) {
+        const DisplayFontSpec& spec = displayFontSpec(font);
+        fontFamilies[font] = std::make_unique<FontFamily>(spec.family);
+        fonts[font] = std::make_unique<Font>(fontFamilies[font].get(), spec.size,
+            spec.bold ? FontStyleBold : FontStyleRegular, UnitPixel);
+    }
+    return fonts[font].get();
+}
+
+static SolidBrush* GetDisplayBrush(uint32_t color) {
+    auto& brush = brushes[color];
+    if (!brush) {
+        brush = std::make_unique<SolidBrush>(colorFromArgb(color));
+    }
+    return brush.get();
+}
+
+static bool intersects(const DisplayRect& bounds, const RECT& clip) {
+    return bounds.left < clip.right && clip.left < bounds.right
+        && bounds.top < clip.bottom && clip.top < bounds.bottom;
+}
+
+void PaintDisplayList(Graphics& graphics, const DisplayList& list, const RECT& clip) {
+    graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+
+    for (const auto& item : list) {
+        if (!intersects(item.bounds, clip)) continue;
+
+        switch (item.kind) {
+        case DISPLAY_FILL_RECT:
+            // Fills replace the pixels like Graphics::Clear instead of blending
+            graphics.SetCompositingMode(CompositingModeSourceCopy);
+            graphics.FillRectangle(GetDisplayBrush(item.color), item.x, item.y, item.width, item.height);
+            graphics.SetCompositingMode(CompositingModeSourceOver);
+            break;
+
+        case DISPLAY_FRAME_RECT:
+        {
+            Pen pen(colorFromArgb(item.color), (REAL)item.penWidth);
+            graphics.DrawRectangle(&pen, item.x, item.y, item.width, item.height);
+        }
+        break;
+
+        case DISPLAY_TEXT:
+            graphics.DrawString(item.text.c_str(), -1, GetDisplayFont(item.font),
+                PointF((REAL)item.x, (REAL)item.y), GetDisplayBrush(item.color));
+            break;
+
+        case DISPLAY_WRAPPED_TEXT:
+        {
+            RectF layoutRect((REAL)item.x, (REAL)item.y, (REAL)item.width, (REAL)item.height);
+            graphics.DrawString(item.text.c_str(), -1, GetDisplayFont(item.font),
+                layoutRect, nullptr, GetDisplayBrush(item.color));
+        }
+        break;
+        }
+    }
+}
+
+void InvalidateDisplayListChanges(HWND hWnd, DisplayList& retained, DisplayList next) {
+    for (const auto& rect : diffDisplayLists(retained, next)) {
+        RECT dirty = { rect.left, rect.top, rect.right, rect.bottom };
+        InvalidateRect(hWnd, &dirty, FALSE);
+    }
+    retained = std::move(next);
+}
+
+void BuildGlyphAtlas(GlyphAtlas& atlas, const DisplayFont* atlasFonts, int fontCount) {
+    std::wstring characters;
+    for (wchar_t ch = 0x20; ch < 0x7F; ch++) {
+        characters += ch;
+    }
+    characters += GLYPH_EXTRA_CHARS;
+
+    SolidBrush whiteBrush(Color(255, 255, 255, 255));
+    StringFormat format(StringFormat::GenericTypographic());
+    format.SetFormatFlags(format.GetFormatFlags() | StringFormatFlagsMeasureTrailingSpaces);
+
+    for (int f = 0; f < fontCount; f++) {
+        DisplayFont displayFont = atlasFonts[f];
+        Font* font = GetDisplayFont(displayFont);
+
+        // Wide enough for fallback symbols, which are drawn from another font
+        int cellHeight = (int)std::ceil(displayFontSpec(displayFont).size * 2);
+        int cellWidth = cellHeight * 2;
+        int pad = cellHeight / 4;
+        Bitmap bitmap(cellWidth, cellHeight, PixelFormat32bppARGB);
+        Graphics graphics(&bitmap);
+        graphics.SetTextRenderingHint(TextRenderingHintAntiAlias);
+
+        // DrawString at a point without a typographic format adds leading padding;
+        // keep it so atlas text lands where GDI+ text used to
+        RectF defaultBox, typographicBox;
+        graphics.MeasureString(L"0", 1, font, PointF(0, 0), &defaultBox);
+        graphics.MeasureString(L"0", 1, font, PointF(0, 0), &format, &typographicBox);
+        atlas.setFontMetrics(displayFont, (defaultBox.Width - typographicBox.Width) / 2, font->GetHeight(&graphics));
+
+        std::vector<uint8_t> mask;
+        for (wchar_t ch : characters) {
+            graphics.Clear(Color(0, 0, 0, 0));
+            graphics.DrawString(&ch, 1, font, PointF((REAL)pad, 0), &format, &whiteBrush);
+
+            RectF box;
+            graphics.MeasureString(&ch, 1, font, PointF(0, 0), &format, &box);
+
+            BitmapData data;
+            Rect lockRect(0, 0, cellWidth, cellHeight);
+            bitmap.LockBits(&lockRect, ImageLockModeRead, PixelFormat32bppARGB, &data);
+            const ARGB* pixels = static_cast<const ARGB*>(data.Scan0);
+            int stride = data.Stride / sizeof(ARGB);
+
+            // Trim to the covered pixels so blits skip empty space
+            int minX = cellWidth, minY = cellHeight, maxX = -1, maxY = -1;
+            for (int y = 0; y < cellHeight; y++) {
+                for (int x = 0; x < cellWidth; x++) {
+                    if (pixels[y * stride + x] >> 24) {
+                        minX = std::min(minX, x);
+                        maxX = std::max(maxX, x);
+                        minY = std::min(minY, y);
+                        maxY = std::max(maxY, y);
+                    }
+                }
+            }
+
+            if (maxX < 0) {
+                // Blank glyph such as the space, only the advance matters
+                atlas.addGlyph(displayFont, ch, 0, 0, 0, 0, box.Width, nullptr);
+            }
+            else {
+                int width = maxX - minX + 1;
+                int height = maxY - minY + 1;
+                mask.assign((size_t)width * height, 0);
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        mask[(size_t)y * width + x] = (uint8_t)(pixels[(minY + y) * stride + minX + x] >> 24);
+                    }
+                }
+                atlas.addGlyph(displayFont, ch, width, height, minX - pad, minY, box.Width, mask.data());
+            }
+
+            bitmap.UnlockBits(&data);
+        }
+    }
+}
+
+void PaintPixelBuffer(HDC hdc, const PixelBuffer& buffer) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = buffer.width;
+    info.bmiHeader.biHeight = -buffer.height; // Top-down rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    // BeginPaint already clipped the DC to the update region
+    SetDIBitsToDevice(hdc, 0, 0, buffer.width, buffer.height, 0, 0, 0, buffer.height,
+        buffer.pixels.data(), &info, DIB_RGB_COLORS);
+}
+
+void ReleaseDisplayResources() {
+    for (int i = 0; i < FONT_COUNT; i++) {
+        fonts[i].reset();
+        fontFamilies[i].reset();
+    }
+    brushes.clear();
+}
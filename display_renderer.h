@@ -0,0 +1,21 @@
+#pragma once
+#define NOMINMAX
+#include "common.h"
+#include "display_list.h"
+#include "glyph_atlas.h"
+
+// Draw the items of a display list that intersect the clip rectangle
+void PaintDisplayList(Graphics& graphics, const DisplayList& list, const RECT& clip);
+
+// Invalidate the parts of hWnd that differ between the retained and the new list,
+// then retain the new list for the next WM_PAINT
+void InvalidateDisplayListChanges(HWND hWnd, DisplayList& retained, DisplayList next);
+
+// Rasterize printable ASCII and GLYPH_EXTRA_CHARS for the given fonts into the atlas
+void BuildGlyphAtlas(GlyphAtlas& atlas, const DisplayFont* atlasFonts, int fontCount);
+
+// Copy a premultiplied pixel buffer to the device at the origin
+void PaintPixelBuffer(HDC hdc, const PixelBuffer& buffer);
+
+// Release cached fonts and brushes, must run before GdiplusShutdown
+void ReleaseDisplayResources();
@@ -1,9 +1,7 @@
 #pragma once
 #define NOMINMAX
 #include "common.h"
-
-// Constants
-const int DISTANCE_KEY_TIMEOUT_MS = 2000; // 2 seconds timeout between presses
+#include "capture_state_machine.h"
 
 // Function to handle F4 key press for distance calculation
-void handleDistanceKey();
\ No newline at end of file
+void handleDistanceKey(HWND hWnd);
\ No newline at end of file
@@ -0,0 +1,142 @@
+#define NOMINMAX
+#include "distance_estimator.h"
+#include "solver_config.h"
+#include <algorithm>
+#include <cmath>
+
+// Base probability that a press was missed or registered twice
+const double BASE_MISCOUNT_PROBABILITY = 0.02;
+// Cap for the total probability assigned to neighbouring counts
+const double MAX_MISCOUNT_PROBABILITY = 0.5;
+
+// Standard normal cumulative distribution
+static double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+static DistanceLikelihood::CountHypothesis makeHypothesis(int presses, double weight) {
+    DistanceLikelihood::CountHypothesis hypothesis;
+    hypothesis.presses = presses;
+    hypothesis.weight = weight;
+    hypothesis.minDistance = DISTANCE_FORMULA_CONSTANT / (presses + 0.5);
+    hypothesis.maxDistance = std::min(MAX_ESTIMATED_DISTANCE, DISTANCE_FORMULA_CONSTANT / (presses - 0.5));
+    return hypothesis;
+}
+
+DistanceLikelihood DistanceLikelihood::fromPresses(const std::vector<double>& pressTimesMs) {
+    DistanceLikelihood likelihood;
+    int count = (int)pressTimesMs.size();
+    if (count == 0) return likelihood;
+    likelihood.presses = count;
+
+    // Interval statistics: very short gaps hint at a doubled press,
+    // irregular cadence hints at a press that did not register
+    std::vector<double> intervals;
+    for (int i = 1; i < count; i++) {
+        intervals.push_back(pressTimesMs[i] - pressTimesMs[i - 1]);
+    }
+
+    double extraProbability = 0.0;
+    double missedProbability = BASE_MISCOUNT_PROBABILITY;
+
+    if (!intervals.empty()) {
+        int shortIntervals = 0;
+        double mean = 0.0;
+        for (double interval : intervals) {
+            if (interval < MIN_DELIBERATE_PRESS_MS) shortIntervals++;
+            mean += interval;
+        }
+        mean /= intervals.size();
+        extraProbability = BASE_MISCOUNT_PROBABILITY + 0.5 * shortIntervals / (double)intervals.size();
+
+        if (intervals.size() >= 2 && mean > 0) {
+            double variance = 0.0;
+            for (double interval : intervals) {
+                variance += (interval - mean) * (interval - mean);
+            }
+            variance /= intervals.size();
+            double coefficientOfVariation = std::sqrt(variance) / mean;
+            missedProbability += 0.2 * std::min(1.0, coefficientOfVariation);
+        }
+    }
+
+    double totalMiscount = extraProbability + missedProbability;
+    if (totalMiscount > MAX_MISCOUNT_PROBABILITY) {
+        extraProbability *= MAX_MISCOUNT_PROBABILITY / totalMiscount;
+        missedProbability *= MAX_MISCOUNT_PROBABILITY / totalMiscount;
+    }
+
+    double exactProbability = 1.0 - extraProbability - missedProbability;
+    likelihood.hypotheses.push_back(makeHypothesis(count, exactProbability));
+    likelihood.hypotheses.push_back(makeHypothesis(count + 1, missedProbability));
+    if (count > 1 && extraProbability > 0) {
+        likelihood.hypotheses.push_back(makeHypothesis(count - 1, extraProbability));
+    }
+    else {
+        // A single press has no lower neighbour, fold its weight back in
+        likelihood.hypotheses[0].weight += extraProbability;
+    }
+
+    return likelihood;
+}
+
+double DistanceLikelihood::nominalDistance() const {
+    if (presses <= 0) return 0.0;
+    return DISTANCE_FORMULA_CONSTANT / presses;
+}
+
+double DistanceLikelihood::density(double distance) const {
+    double total = 0.0;
+    for (const auto& hypothesis : hypotheses) {
+        double width = hypothesis.maxDistance - hypothesis.minDistance;
+        if (width <= 0) continue;
+
+        // Uniform over the count bin, blurred by the measurement noise at the edges
+        double inBin = normalCdf((distance - hypothesis.minDistance) / solverConfig.f4DistanceStdDev)
+            - normalCdf((distance - hypothesis.maxDistance) / solverConfig.f4DistanceStdDev);
+        total += hypothesis.weight * inBin / width;
+    }
+    return total;
+}
+
+double DistanceLikelihood::minDistance() const {
+    double result = MAX_ESTIMATED_DISTANCE;
+    for (const auto& hypothesis : hypotheses) {
+        result = std::min(result, hypothesis.minDistance);
+    }
+    return std::max(0.0, result - 3.0 * solverConfig.f4DistanceStdDev);
+}
+
+double DistanceLikelihood::maxDistance() const {
+    double result = 0.0;
+    for (const auto& hypothesis : hypotheses) {
+        result = std::max(result, hypothesis.maxDistance);
+    }
+    return result + 3.0 * solverConfig.f4DistanceStdDev;
+}
+
+std::vector<DistanceSample> DistanceLikelihood::samples(double maxSpacing) const {
+    std::vector<DistanceSample> result;
+    if (!isValid() || maxSpacing <= 0) return result;
+
+    double lo = minDistance();
+    double hi = maxDistance();
+    int count = std::max(5, (int)std::ceil((hi - lo) / maxSpacing));
+    double step = (hi - lo) / count;
+
+    double totalWeight = 0.0;
+    for (int i = 0; i < count; i++) {
+        double distance = lo + (i + 0.5) * step;
+        double weight = density(distance) * step;
+        if (weight <= 0) continue;
+        result.push_back({ distance, weight });
+        totalWeight += weight;
+    }
+
+    if (totalWeight > 0) {
+        for (auto& sample : result) {
+            sample.weight /= totalWeight;
+        }
+    }
+    return result;
+}
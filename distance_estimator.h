@@ -0,0 +1,58 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+
+// Press-count distance formula: distance = 3655 / (presses / 2)
+const double DISTANCE_FORMULA_CONSTANT = 3655.0 * 2.0;
+// Standard deviation for F4 distance measurements (in blocks)
+const double F4_DISTANCE_STD_DEV = 25.0; // Adjustable based on F4 precision
+// Presses closer together than this are treated as possible double registrations
+const double MIN_DELIBERATE_PRESS_MS = 40.0;
+// Upper bound for the single-press distance bin
+const double MAX_ESTIMATED_DISTANCE = 10000.0;
+
+struct DistanceSample {
+    double distance;
+    double weight;
+};
+
+// Likelihood over the true stronghold distance given an F4 press sequence.
+// The press count is the rounded value of 7310 / distance, so each count covers
+// a bin of distances rather than a single value. Timing irregularities widen the
+// estimate by mixing in the neighbouring counts (missed or doubled presses).
+class DistanceLikelihood {
+public:
+    struct CountHypothesis {
+        int presses;
+        double weight;
+        double minDistance;
+        double maxDistance;
+    };
+
+    DistanceLikelihood() = default;
+
+    // Build from press timestamps in milliseconds (oldest first)
+    static DistanceLikelihood fromPresses(const std::vector<double>& pressTimesMs);
+
+    bool isValid() const { return !hypotheses.empty(); }
+    int pressCount() const { return presses; }
+
+    // Point estimate matching the classic 3655 / (presses / 2) display value
+    double nominalDistance() const;
+
+    // Probability density of the true distance (normalized over all distances)
+    double density(double distance) const;
+
+    // Smallest and largest distance with non-negligible density
+    double minDistance() const;
+    double maxDistance() const;
+
+    // Quadrature points over the support, weights sum to 1
+    std::vector<DistanceSample> samples(double maxSpacing) const;
+
+    const std::vector<CountHypothesis>& countHypotheses() const { return hypotheses; }
+
+private:
+    int presses = 0;
+    std::vector<CountHypothesis> hypotheses;
+};
@@ -0,0 +1,285 @@
+#define NOMINMAX
+#include "first_throw_table.h"
+#include "stronghold_calculator.h"
+#include "number_format.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FirstThrowTable firstThrowTable;
+
+const int FIRST_THROW_GRID_SIZE = 2 * FIRST_THROW_TABLE_RADIUS / FIRST_THROW_POSITION_STEP + 1;
+const size_t FIRST_THROW_HEADER_BYTES = 24;
+const size_t FIRST_THROW_SLOT_BYTES = 6;
+
+static size_t slotOffset(int xIndex, int zIndex, int angleBin, int k) {
+    size_t entry = ((size_t)zIndex * FIRST_THROW_GRID_SIZE + xIndex) * FIRST_THROW_ANGLE_BINS + angleBin;
+    return FIRST_THROW_HEADER_BYTES + (entry * FIRST_THROW_TOP_K + k) * FIRST_THROW_SLOT_BYTES;
+}
+
+static void put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+    put16(out, (uint16_t)value);
+    put16(out, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* data) {
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* data) {
+    return get16(data) | ((uint32_t)get16(data + 2) << 16);
+}
+
+bool buildFirstThrowTable(const std::string& path, void (*onProgress)(int done, int total)) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::vector<uint8_t> header;
+    put32(header, FIRST_THROW_TABLE_MAGIC);
+    put32(header, (uint32_t)FIRST_THROW_TABLE_RADIUS);
+    put32(header, (uint32_t)FIRST_THROW_POSITION_STEP);
+    put32(header, (uint32_t)FIRST_THROW_ANGLE_BINS);
+    put32(header, (uint32_t)FIRST_THROW_TOP_K);
+    put32(header, firstThrowConfigFingerprint(solverConfig));
+    file.write((const char*)header.data(), header.size());
+
+    // Same state the capture logic leaves for a throw without F4
+    appState = ApplicationState();
+    std::vector<uint8_t> entries;
+    int total = FIRST_THROW_GRID_SIZE * FIRST_THROW_GRID_SIZE;
+    for (int zIndex = 0; zIndex < FIRST_THROW_GRID_SIZE; zIndex++) {
+        for (int xIndex = 0; xIndex < FIRST_THROW_GRID_SIZE; xIndex++) {
+            int playerX = xIndex * FIRST_THROW_POSITION_STEP - FIRST_THROW_TABLE_RADIUS;
+            int playerZ = zIndex * FIRST_THROW_POSITION_STEP - FIRST_THROW_TABLE_RADIUS;
+
+            entries.clear();
+            for (int angleBin = 0; angleBin < FIRST_THROW_ANGLE_BINS; angleBin++) {
+                calculateStrongholdLocationWithDistance(playerX, playerZ, angleBin * 360.0 / FIRST_THROW_ANGLE_BINS);
+
+                int stored = 0;
+                for (const auto& candidate : strongholdCandidates) {
+                    if (stored == FIRST_THROW_TOP_K) break;
+                    int cellX, cellZ;
+                    if (!strongholdCellIndexAt(candidate.cellCenterX, cellX) || !strongholdCellIndexAt(candidate.cellCenterZ, cellZ)) continue;
+                    put16(entries, (uint16_t)(int16_t)cellX);
+                    put16(entries, (uint16_t)(int16_t)cellZ);
+                    put16(entries, (uint16_t)std::lround(std::min(1.0, candidate.conditionalProb) * 65535.0));
+                    stored++;
+                }
+                for (; stored < FIRST_THROW_TOP_K; stored++) {
+                    put16(entries, 0);
+                    put16(entries, 0);
+                    put16(entries, 0);
+                }
+            }
+            file.write((const char*)entries.data(), entries.size());
+
+            if (onProgress) onProgress(zIndex * FIRST_THROW_GRID_SIZE + xIndex + 1, total);
+        }
+    }
+    strongholdCandidates.clear();
+    return file.good();
+}
+
+#ifdef _WIN32
+static bool mapFile(HANDLE file, const uint8_t*& data, size_t& size, void*& mappingHandle) {
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    data = (const uint8_t*)view;
+    size = (size_t)fileSize.QuadPart;
+    mappingHandle = mapping;
+    return true;
+}
+
+bool FirstThrowTable::open(const std::string& path) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+    return mapFile(file, data, size, mappingHandle) && validate();
+}
+
+bool FirstThrowTable::open(const std::wstring& path) {
+    close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    fileHandle = file;
+    return mapFile(file, data, size, mappingHandle) && validate();
+}
+
+void FirstThrowTable::close() {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+#else
+bool FirstThrowTable::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    data = (const uint8_t*)view;
+    size = (size_t)info.st_size;
+    return validate();
+}
+
+void FirstThrowTable::close() {
+    if (data) munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+}
+#endif
+
+// Reject tables built with other grid constants or cut short
+bool FirstThrowTable::validate() {
+    bool valid = size == slotOffset(0, FIRST_THROW_GRID_SIZE, 0, 0)
+        && get32(data) == FIRST_THROW_TABLE_MAGIC
+        && get32(data + 4) == (uint32_t)FIRST_THROW_TABLE_RADIUS
+        && get32(data + 8) == (uint32_t)FIRST_THROW_POSITION_STEP
+        && get32(data + 12) == (uint32_t)FIRST_THROW_ANGLE_BINS
+        && get32(data + 16) == (uint32_t)FIRST_THROW_TOP_K;
+    if (!valid) {
+        close();
+        return false;
+    }
+    configFingerprint = get32(data + 20);
+    return true;
+}
+
+FirstThrowSlot FirstThrowTable::slot(int xIndex, int zIndex, int angleBin, int k) const {
+    const uint8_t* bytes = data + slotOffset(xIndex, zIndex, angleBin, k);
+    return { (int16_t)get16(bytes), (int16_t)get16(bytes + 2), get16(bytes + 4) };
+}
+
+bool FirstThrowTable::lookup(double playerX, double playerZ, double eyeAngle,
+    std::vector<StrongholdCandidate>& candidates) const {
+    // A table built with other solver settings would answer for the old ones
+    if (!data || configFingerprint != firstThrowConfigFingerprint(solverConfig)) return false;
+
+    double gridX = (playerX + FIRST_THROW_TABLE_RADIUS) / FIRST_THROW_POSITION_STEP;
+    double gridZ = (playerZ + FIRST_THROW_TABLE_RADIUS) / FIRST_THROW_POSITION_STEP;
+    if (gridX < 0 || gridZ < 0 || gridX > FIRST_THROW_GRID_SIZE - 1 || gridZ > FIRST_THROW_GRID_SIZE - 1) return false;
+
+    double gridAngle = eyeAngle / 360.0 * FIRST_THROW_ANGLE_BINS;
+    gridAngle -= std::floor(gridAngle / FIRST_THROW_ANGLE_BINS) * FIRST_THROW_ANGLE_BINS;
+
+    int x0 = std::min((int)gridX, FIRST_THROW_GRID_SIZE - 2);
+    int z0 = std::min((int)gridZ, FIRST_THROW_GRID_SIZE - 2);
+    int a0 = std::min((int)gridAngle, FIRST_THROW_ANGLE_BINS - 1);
+    double fx = gridX - x0, fz = gridZ - z0, fa = gridAngle - a0;
+
+    // Trilinear blend of the eight surrounding entries, merged by cell
+    struct Blend {
+        int cellX, cellZ;
+        double probability;
+    };
+    Blend blended[8 * FIRST_THROW_TOP_K];
+    int blendCount = 0;
+    for (int corner = 0; corner < 8; corner++) {
+        int dx = corner & 1, dz = (corner >> 1) & 1, da = corner >> 2;
+        double weight = (dx ? fx : 1 - fx) * (dz ? fz : 1 - fz) * (da ? fa : 1 - fa);
+        if (weight <= 0) continue;
+        int angleBin = (a0 + da) % FIRST_THROW_ANGLE_BINS;
+        for (int k = 0; k < FIRST_THROW_TOP_K; k++) {
+            FirstThrowSlot entry = slot(x0 + dx, z0 + dz, angleBin, k);
+            if (entry.probability == 0) break;
+            double probability = weight * entry.probability / 65535.0;
+            int i = 0;
+            while (i < blendCount && (blended[i].cellX != entry.cellX || blended[i].cellZ != entry.cellZ)) i++;
+            if (i == blendCount) blended[blendCount++] = { entry.cellX, entry.cellZ, 0.0 };
+            blended[i].probability += probability;
+        }
+    }
+    std::sort(blended, blended + blendCount, [](const Blend& a, const Blend& b) { return a.probability > b.probability; });
+    double blendedMass = 0.0;
+    for (int i = 0; i < blendCount; i++) {
+        blendedMass += blended[i].probability;
+    }
+    blendCount = std::min(blendCount, FIRST_THROW_TOP_K);
+
+    // Each stored probability is off by up to half a step, so a closer race than one
+    // step between the top two cells could go either way
+    if (blendCount == 0) return false;
+    if (blendCount > 1 && blended[0].probability - blended[1].probability <= FIRST_THROW_QUANTIZATION) return false;
+
+    // Candidates are placed like the live solver does: the cell center projected on the actual ray
+    candidates.clear();
+    double eyeStartX = playerX + 0.5;
+    double eyeStartZ = playerZ + 0.5;
+    double angleRad = eyeAngle * M_PI / 180.0;
+    double dirX = std::sin(angleRad);
+    double dirZ = -std::cos(angleRad);
+    trimStrongholdCellCache();
+    for (int i = 0; i < blendCount; i++) {
+        const StrongholdCell* cell = strongholdCellAt(blended[i].cellX, blended[i].cellZ);
+        if (!cell) continue;
+
+        double t = std::max(0.0, (cell->centerX - eyeStartX) * dirX + (cell->centerZ - eyeStartZ) * dirZ);
+        double projectionX = std::max(cell->xMin, std::min(cell->xMax, eyeStartX + t * dirX));
+        double projectionZ = std::max(cell->zMin, std::min(cell->zMax, eyeStartZ + t * dirZ));
+
+        StrongholdCandidate candidate;
+        candidate.projectionX = (int)std::round(projectionX);
+        candidate.projectionZ = (int)std::round(projectionZ);
+        candidate.netherX = (int)std::round(projectionX / 8.0);
+        candidate.netherZ = (int)std::round(projectionZ / 8.0);
+        candidate.cellCenterX = cell->centerX;
+        candidate.cellCenterZ = cell->centerZ;
+        candidate.rawProb = blended[i].probability;
+        candidate.conditionalProb = blended[i].probability;
+        candidate.distance = (int)std::round(std::sqrt((projectionX - playerX) * (projectionX - playerX)
+            + (projectionZ - playerZ) * (projectionZ - playerZ)));
+        candidate.distanceFromOrigin = (int)std::round(cell->distance);
+        candidate.distanceRange = cell->distanceRange;
+
+        WideFormatBuffer text;
+        text.text(L"(").integer((int)cell->xMin).text(L", ").integer((int)cell->zMin)
+            .text(L") to (").integer((int)cell->xMax).text(L", ").integer((int)cell->zMax).text(L")");
+        candidate.bounds = text.str();
+
+        candidates.push_back(candidate);
+    }
+
+    // Corners disagree on which cells they hold, so the cut to the top cells drops part of
+    // the blend. Renormalise the kept cells to the mass of every blended entry; what the
+    // solves gave to cells outside their stored top ones stays unassigned, as in a live answer.
+    double keptMass = 0.0;
+    for (const auto& candidate : candidates) {
+        keptMass += candidate.conditionalProb;
+    }
+    for (auto& candidate : candidates) {
+        candidate.conditionalProb *= std::min(1.0, blendedMass) / keptMass;
+    }
+    return !candidates.empty();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#define NOMINMAX
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "app_state.h"
+
+// Precomputed answers for throws without an F4 distance made near spawn. The
+// table holds the top candidates of the double solver on a grid of player
+// positions and eye angles; a lookup interpolates the eight surrounding grid
+// entries instead of solving. The file is memory-mapped read-only and written
+// little-endian, which is also the byte order of every supported platform. A
+// table is only used while the solver settings it was built with are in effect.
+
+const uint32_t FIRST_THROW_TABLE_MAGIC = 0x31545446;   // "FTT1"
+const int FIRST_THROW_TABLE_RADIUS = 256;       // Blocks covered on each side of the origin
+const int FIRST_THROW_POSITION_STEP = 32;       // Blocks between grid positions
+const int FIRST_THROW_ANGLE_BINS = 720;         // Eye angles per position, 0.5 degrees apart
+const int FIRST_THROW_TOP_K = 8;                // Candidates stored per grid entry
+const double FIRST_THROW_QUANTIZATION = 1.0 / 65535.0;  // Stored probability step
+
+// Top candidates of the solve for one grid position and angle, sorted by probability
+struct FirstThrowSlot {
+    int16_t cellX, cellZ;       // Lattice index of the cell
+    uint16_t probability;       // Conditional probability scaled by 65535, 0 for an unused slot
+};
+
+class FirstThrowTable {
+public:
+    FirstThrowTable() {}
+    ~FirstThrowTable() { close(); }
+    FirstThrowTable(const FirstThrowTable&) = delete;
+    FirstThrowTable& operator=(const FirstThrowTable&) = delete;
+
+    // Map a table written by buildFirstThrowTable; false if missing or not a valid table
+    bool open(const std::string& path);
+#ifdef _WIN32
+    bool open(const std::wstring& path);
+#endif
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    // Candidates for a throw from the player position at the eye angle (degrees, as
+    // angleBetween), with probabilities renormalised over the blended cells. False when
+    // the position is outside the table or the top two cells are within the
+    // quantization error of each other, so the full solve should decide.
+    bool lookup(double playerX, double playerZ, double eyeAngle, std::vector<StrongholdCandidate>& candidates) const;
+
+private:
+    bool validate();
+    FirstThrowSlot slot(int xIndex, int zIndex, int angleBin, int k) const;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uint32_t configFingerprint = 0;     // Of the solverConfig the table was built with
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// Table used by solveCapturedThrow, empty unless the GUI found a table file
+extern FirstThrowTable firstThrowTable;
+
+// Solve every grid entry with the double solver and write the table. Uses appState
+// and strongholdCandidates. onProgress, if set, is called after each grid position.
+bool buildFirstThrowTable(const std::string& path, void (*onProgress)(int done, int total) = nullptr);
@@ -0,0 +1,99 @@
+// Builds the first-throw lookup table and checks it against the live solver.
+// Copy the built table to %APPDATA%\MinecraftStrongholdFinder\first_throw_table.bin
+// for the GUI to use it. Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 first_throw_table_tool.cpp first_throw_table.cpp stronghold_calculator.cpp
+//       fixed_point_solver.cpp cell_lattice.cpp ring_prior.cpp distance_estimator.cpp solver_config.cpp number_format.cpp trace.cpp
+//       metrics.cpp -o first_throw_table
+#define NOMINMAX
+#include "first_throw_table.h"
+#include "stronghold_calculator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+// Throws sampled by check
+const int CHECK_THROWS = 2000;
+
+static void printProgress(int done, int total) {
+    if (done % 17 == 0 || done == total) {
+        std::cerr << "\r" << done << "/" << total << " positions" << std::flush;
+    }
+}
+
+// Compare table lookups with live solves for random throws inside the table
+static int check(const std::string& path) {
+    FirstThrowTable table;
+    if (!table.open(path)) {
+        std::cerr << "Could not open table " << path << "\n";
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> position(-FIRST_THROW_TABLE_RADIUS, FIRST_THROW_TABLE_RADIUS);
+    std::uniform_real_distribution<double> angle(0.0, 360.0);
+
+    int answered = 0, sameTop = 0, topInTable = 0;
+    double lookupSeconds = 0, solveSeconds = 0, probabilityError = 0;
+    std::vector<StrongholdCandidate> looked;
+    for (int i = 0; i < CHECK_THROWS; i++) {
+        int playerX = (int)position(rng), playerZ = (int)position(rng);
+        double eyeAngle = angle(rng);
+
+        auto start = std::chrono::steady_clock::now();
+        bool found = table.lookup(playerX, playerZ, eyeAngle, looked);
+        auto middle = std::chrono::steady_clock::now();
+        calculateStrongholdLocationWithDistance(playerX, playerZ, eyeAngle);
+        auto end = std::chrono::steady_clock::now();
+        lookupSeconds += std::chrono::duration<double>(middle - start).count();
+        solveSeconds += std::chrono::duration<double>(end - middle).count();
+
+        if (!found || strongholdCandidates.empty()) continue;
+        answered++;
+        const StrongholdCandidate& live = strongholdCandidates[0];
+        if (looked[0].cellCenterX == live.cellCenterX && looked[0].cellCenterZ == live.cellCenterZ) sameTop++;
+        for (const auto& candidate : looked) {
+            if (candidate.cellCenterX == live.cellCenterX && candidate.cellCenterZ == live.cellCenterZ) {
+                topInTable++;
+                probabilityError += std::abs(candidate.conditionalProb - live.conditionalProb);
+                break;
+            }
+        }
+    }
+
+    // Throws the table declines fall back to the full solve
+    std::cout << "Answered from table: " << answered * 100.0 / CHECK_THROWS << "%\n"
+        << "Same top cell: " << sameTop * 100.0 / std::max(1, answered) << "% of answered\n"
+        << "Live top cell in table answer: " << topInTable * 100.0 / std::max(1, answered) << "% of answered\n"
+        << "Mean top probability error: " << probabilityError / std::max(1, topInTable) << "\n"
+        << "Lookup: " << lookupSeconds * 1e6 / CHECK_THROWS << " us, solve: "
+        << solveSeconds * 1e6 / CHECK_THROWS << " us\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 2 ? argv[1] : "";
+    if (command == "build") {
+        auto start = std::chrono::steady_clock::now();
+        if (!buildFirstThrowTable(argv[2], printProgress)) {
+            std::cerr << "\nCould not write " << argv[2] << "\n";
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "\nWrote " << argv[2] << " in " << seconds << "s\n";
+        return 0;
+    }
+    if (command == "check") {
+        return check(argv[2]);
+    }
+
+    std::cerr << "Usage: first_throw_table build <table.bin>\n"
+        << "       first_throw_table check <table.bin>\n";
+    return 1;
+}
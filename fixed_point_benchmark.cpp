@@ -0,0 +1,152 @@
+// Times the fixed-point solver against the double solver on the same random throws,
+// checks that fixed-point results repeat bit for bit, and solves throws at the edges
+// of the 48.16 input range (run a -fsanitize=undefined build to catch overflow).
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 fixed_point_benchmark.cpp fixed_point_solver.cpp stronghold_calculator.cpp
+//       first_throw_table.cpp cell_lattice.cpp ring_prior.cpp distance_estimator.cpp solver_config.cpp
+//       number_format.cpp trace.cpp metrics.cpp -o fixed_point_benchmark
+#define NOMINMAX
+#include "fixed_point_solver.h"
+#include "stronghold_calculator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+const int BENCHMARK_THROWS = 300;
+const int BENCHMARK_ROUNDS = 40;
+
+struct BenchmarkThrow {
+    int playerX, playerZ;
+    int directionX, directionZ;     // Capture delta between the two direction key presses
+    double angle;
+    double f4Distance;              // 0 without F4
+};
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+static std::vector<BenchmarkThrow> randomThrows(bool withF4) {
+    std::vector<BenchmarkThrow> throws;
+    uint32_t state = withF4 ? 777 : 12345;
+    auto next = [&](int range) {
+        state = state * 1664525u + 1013904223u;
+        return (int)(state >> 8) % (2 * range + 1) - range;
+    };
+    for (int i = 0; i < BENCHMARK_THROWS; i++) {
+        BenchmarkThrow t;
+        t.playerX = next(2000);
+        t.playerZ = next(2000);
+        t.directionX = next(40);
+        t.directionZ = next(40);
+        if (t.directionX == 0 && t.directionZ == 0) t.directionZ = 1;
+        t.angle = angleBetween(0, 0, t.directionX, t.directionZ);
+        t.f4Distance = withF4 ? 800 + std::abs(next(1200)) : 0.0;
+        throws.push_back(t);
+    }
+    return throws;
+}
+
+static void setF4(double distance) {
+    appState = ApplicationState();
+    appState.f4PressedFirst = distance > 0;
+    appState.calculatedDistance = distance;
+}
+
+// Microseconds per solve in the fastest round, which is the least disturbed by the machine
+static double timeSolver(const std::vector<BenchmarkThrow>& throws, bool fixedPoint, size_t& candidates) {
+    candidates = 0;
+    double fastestUs = 0.0;
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& t : throws) {
+            setF4(t.f4Distance);
+            if (fixedPoint) {
+                calculateStrongholdLocationFixedPoint(t.playerX, t.playerZ, t.directionX, t.directionZ);
+            }
+            else {
+                calculateStrongholdLocationWithDistance(t.playerX, t.playerZ, t.angle);
+            }
+            candidates += strongholdCandidates.size();
+        }
+        double roundUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+            / throws.size();
+        fastestUs = round == 0 ? roundUs : std::min(fastestUs, roundUs);
+    }
+    return fastestUs;
+}
+
+static bool sameCandidates(const std::vector<StrongholdCandidate>& a, const std::vector<StrongholdCandidate>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].projectionX != b[i].projectionX || a[i].projectionZ != b[i].projectionZ
+            || a[i].rawProb != b[i].rawProb || a[i].distance != b[i].distance) return false;
+    }
+    return true;
+}
+
+static void checkRepeatable(const std::vector<BenchmarkThrow>& throws) {
+    bool repeatable = true;
+    for (const auto& t : throws) {
+        setF4(t.f4Distance);
+        calculateStrongholdLocationFixedPoint(t.playerX, t.playerZ, t.directionX, t.directionZ);
+        std::vector<StrongholdCandidate> first = strongholdCandidates;
+        calculateStrongholdLocationFixedPoint(t.playerX, t.playerZ, t.directionX, t.directionZ);
+        repeatable = repeatable && sameCandidates(first, strongholdCandidates);
+    }
+    check(repeatable, "fixed-point results repeat bit for bit");
+}
+
+static void checkInputRange() {
+    // Throws near the world border, with and without F4, find cells and sane distances
+    setF4(0);
+    calculateStrongholdLocationFixedPoint(FIXED_MAX_COORDINATE - 1000, -(FIXED_MAX_COORDINATE - 1000), -3, 4);
+    check(!strongholdCandidates.empty() && strongholdCandidates[0].distanceFromOrigin > 42000000,
+        "throw at the world border finds far cells");
+    setF4(20000.0);
+    calculateStrongholdLocationFixedPoint(FIXED_MAX_COORDINATE, FIXED_MAX_COORDINATE, -1, -1);
+    check(!strongholdCandidates.empty() && std::abs(strongholdCandidates[0].distance - 20000) < 600,
+        "long F4 throw at the world border lands near its distance");
+
+    // Beyond the range: no candidates, and an F4 distance no sample can use is a mismatch
+    setF4(0);
+    calculateStrongholdLocationFixedPoint(FIXED_MAX_COORDINATE + 1, 0, 1, 0);
+    check(strongholdCandidates.empty(), "player beyond the world border gives no candidates");
+    setF4(1e15);
+    calculateStrongholdLocationFixedPoint(100, 100, 1, 0);
+    check(strongholdCandidates.empty() && appState.distanceValidationFailed, "F4 distance beyond range is a mismatch");
+}
+
+int main() {
+    for (bool withF4 : { false, true }) {
+        std::vector<BenchmarkThrow> throws = randomThrows(withF4);
+        size_t doubleCandidates, fixedCandidates;
+        // Warm the lattice tiles and sample tables before timing
+        timeSolver(throws, false, doubleCandidates);
+        timeSolver(throws, true, fixedCandidates);
+
+        double doubleUs = timeSolver(throws, false, doubleCandidates);
+        double fixedUs = timeSolver(throws, true, fixedCandidates);
+        std::cout << BENCHMARK_THROWS << " throws " << (withF4 ? "with F4" : "without F4") << ": double "
+            << doubleUs << " us, fixed point " << fixedUs << " us per solve ("
+            << 100.0 * fixedUs / doubleUs << "% of the double time), "
+            << (double)doubleCandidates / (BENCHMARK_ROUNDS * BENCHMARK_THROWS) << " and "
+            << (double)fixedCandidates / (BENCHMARK_ROUNDS * BENCHMARK_THROWS) << " candidates\n";
+        checkRepeatable(throws);
+    }
+    checkInputRange();
+
+    std::cout << (ok ? "All fixed-point checks passed\n" : "Fixed-point checks FAILED\n");
+    return ok ? 0 : 1;
+}
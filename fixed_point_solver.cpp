@@ -0,0 +1,362 @@
+#define NOMINMAX
+#include "fixed_point_solver.h"
+#include "stronghold_calculator.h"
+#include "cell_lattice.h"
+#include "number_format.h"
+#include "trace.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// Gaussian weight of a sample k half standard deviations from the center, Q16.
+// Shared by the angle samples and the fallback F4 distance samples.
+static const int64_t SAMPLE_WEIGHTS[] = { 65536, 57835, 39750, 21276, 8869, 2879, 728, 143 };
+static_assert(sizeof(SAMPLE_WEIGHTS) / sizeof(SAMPLE_WEIGHTS[0]) == MAX_SOLVER_SAMPLES / 2 + 1, "one weight per sample offset");
+
+// Fractional bits of the sample angles while their rotations are built
+const int SAMPLE_ANGLE_BITS = 32;
+
+const int64_t FIXED_ONE = (int64_t)1 << FIXED_POSITION_BITS;
+const int64_t VIRTUAL_CELL_PRIOR = 838861; // 0.05 in Q24
+
+// Accumulator slots reserved per solve, enough for a typical throw's ray hits and exact F4 points
+const size_t ACCUMULATOR_RESERVE = 256;
+
+// The double estimate is within a few units of the root; the integer corrections make
+// the result exact whatever the rounding of the conversion and sqrt
+uint64_t integerSqrt(uint64_t value) {
+    uint64_t result = std::min((uint64_t)std::sqrt((double)value), (uint64_t)0xFFFFFFFFu);
+    while (result * result > value) result--;
+    while (result < 0xFFFFFFFFu && (result + 1) * (result + 1) <= value) result++;
+    return result;
+}
+
+// Divide by 2^bits, rounding half away from zero
+static int64_t roundShift(int64_t value, int bits) {
+    int64_t half = (int64_t)1 << (bits - 1);
+    return value >= 0 ? (value + half) >> bits : -((-value + half) >> bits);
+}
+
+static int64_t roundDivide(int64_t value, int64_t divisor) {
+    return value >= 0 ? (value + divisor / 2) / divisor : -((-value + divisor / 2) / divisor);
+}
+
+// Squares overflow from 2^31.5 (about 46000 blocks); longer vectors are halved until
+// they fit, which only drops bits far below a block
+static int64_t fixedLength(int64_t x, int64_t z) {
+    uint64_t absX = (uint64_t)(x < 0 ? -x : x), absZ = (uint64_t)(z < 0 ? -z : z);
+    int shift = 0;
+    while (absX >= ((uint64_t)1 << 31) || absZ >= ((uint64_t)1 << 31)) {
+        absX >>= 1;
+        absZ >>= 1;
+        shift++;
+    }
+    return (int64_t)(integerSqrt(absX * absX + absZ * absZ) << shift);
+}
+
+// cos and sin in Q30 of an angle in Q32 radians (at most ~0.7), by Taylor series in
+// integers so the table does not depend on libm
+static void fixedCosSin(int64_t angle, int64_t& cosQ30, int64_t& sinQ30) {
+    int64_t square = roundShift(angle * angle, SAMPLE_ANGLE_BITS);
+    int64_t sum = angle, term = angle;
+    for (int n = 1; term != 0; n++) {
+        term = -roundDivide(roundShift(term * square, SAMPLE_ANGLE_BITS), (int64_t)(2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    sinQ30 = roundShift(sum, SAMPLE_ANGLE_BITS - FIXED_DIRECTION_BITS);
+
+    sum = term = (int64_t)1 << SAMPLE_ANGLE_BITS;
+    for (int n = 1; term != 0; n++) {
+        term = -roundDivide(roundShift(term * square, SAMPLE_ANGLE_BITS), (int64_t)(2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    cosQ30 = roundShift(sum, SAMPLE_ANGLE_BITS - FIXED_DIRECTION_BITS);
+}
+
+// Rotations of the angle samples (angleStdDev / 2 apart), rebuilt when the configured
+// sample count or standard deviation changes
+struct SampleRotations {
+    int count = 0;
+    double angleStdDev = 0.0;
+    std::vector<int64_t> cosQ30, sinQ30, weights;
+};
+
+static const SampleRotations& sampleRotations(const SolverConfig& config) {
+    static SampleRotations rotations;
+    if (rotations.count == config.angleSamples && rotations.angleStdDev == config.angleStdDev) return rotations;
+
+    rotations.count = config.angleSamples;
+    rotations.angleStdDev = config.angleStdDev;
+    rotations.cosQ30.assign(rotations.count, 0);
+    rotations.sinQ30.assign(rotations.count, 0);
+    rotations.weights.assign(rotations.count, 0);
+    for (int i = 0; i < rotations.count; i++) {
+        int offset = i - rotations.count / 2;
+        double degrees = offset * (config.angleStdDev / 2.0);
+        int64_t angle = std::llround(degrees * (M_PI / 180.0) * (double)((int64_t)1 << SAMPLE_ANGLE_BITS));
+        fixedCosSin(angle, rotations.cosQ30[i], rotations.sinQ30[i]);
+        rotations.weights[i] = SAMPLE_WEIGHTS[std::abs(offset)];
+    }
+    return rotations;
+}
+
+struct FixedCellAccumulator {
+    const StrongholdCell* cell;     // nullptr for an exact F4 point outside every cell
+    int64_t pointX, pointZ;         // Cell center, or the exact F4 point for virtual cells
+    int64_t xMin, xMax, zMin, zMax; // Cell bounds, converted once per sector cell
+    uint64_t weight;                // Sum of sample weights; times the prior once the sums are complete
+    int64_t sumX, sumZ;
+    int64_t projections;
+};
+
+static FixedCellAccumulator cellAccumulator(const StrongholdCell* cell, int64_t centerX, int64_t centerZ) {
+    return { cell, centerX, centerZ, (int64_t)cell->xMin * FIXED_ONE, (int64_t)cell->xMax * FIXED_ONE,
+        (int64_t)cell->zMin * FIXED_ONE, (int64_t)cell->zMax * FIXED_ONE, 0, 0, 0, 0 };
+}
+
+void calculateStrongholdLocationFixedPoint(int playerX, int playerZ, int directionX, int directionZ) {
+    TRACE_SPAN("solve");
+    ScopedLatency latency(metrics.solveLatency);
+    const SolverConfig& config = solverConfig;
+    const SampleRotations& rotations = sampleRotations(config);
+    int64_t cellMargin = std::llround(config.f4CellMargin * FIXED_ONE);
+    strongholdCandidates.clear();
+    appState.distanceValidationFailed = false;
+    appState.validationErrorMessage = L"";
+    if (std::abs((int64_t)playerX) > FIXED_MAX_COORDINATE || std::abs((int64_t)playerZ) > FIXED_MAX_COORDINATE) return;
+
+    // BEDROCK FIX: Eye of ender starts flying from (playerX + 0.5, playerZ + 0.5)
+    int64_t eyeStartX = (int64_t)playerX * FIXED_ONE + FIXED_ONE / 2;
+    int64_t eyeStartZ = (int64_t)playerZ * FIXED_ONE + FIXED_ONE / 2;
+
+    // Unit direction in Q30. A zero vector points +Z, like angleBetween's atan2(0, -0).
+    int64_t dirX = directionX, dirZ = directionZ;
+    if (dirX == 0 && dirZ == 0) dirZ = 1;
+    while (std::abs(dirX) >= (1 << 16) || std::abs(dirZ) >= (1 << 16)) {
+        dirX /= 2;
+        dirZ /= 2;
+    }
+    int64_t lengthQ14 = (int64_t)integerSqrt((uint64_t)(dirX * dirX + dirZ * dirZ) << 28);
+    int64_t unitX = dirX * ((int64_t)1 << 44) / lengthQ14;
+    int64_t unitZ = dirZ * ((int64_t)1 << 44) / lengthQ14;
+
+    // Distance samples, quantized to Q16 blocks and Q16 weights relative to the largest;
+    // samples past FIXED_MAX_DISTANCE would overflow below and can reach no cell anyway
+    int64_t maxDistance = (int64_t)FIXED_MAX_DISTANCE * FIXED_ONE;
+    bool useTargetDistance = appState.f4PressedFirst && appState.calculatedDistance > 0;
+    std::vector<std::pair<int64_t, int64_t>> distanceSamples;
+    distanceSamples.reserve(MAX_SOLVER_SAMPLES);
+    if (useTargetDistance) {
+        if (appState.distanceLikelihood.isValid()) {
+            std::vector<DistanceSample> samples = appState.distanceLikelihood.samples(config.distanceSampleSpacing);
+            double maxWeight = 0.0;
+            for (const auto& sample : samples) {
+                maxWeight = std::max(maxWeight, sample.weight);
+            }
+            for (const auto& sample : samples) {
+                if (!(sample.distance >= 0 && sample.distance <= FIXED_MAX_DISTANCE)) continue;
+                distanceSamples.push_back({ (int64_t)std::llround(sample.distance * FIXED_ONE),
+                    (int64_t)std::llround(sample.weight / maxWeight * FIXED_ONE) });
+            }
+        }
+        else if (appState.calculatedDistance <= FIXED_MAX_DISTANCE) {
+            int64_t center = (int64_t)std::llround(appState.calculatedDistance * FIXED_ONE);
+            int64_t spacing = (int64_t)std::llround(config.f4DistanceStdDev / 2.0 * FIXED_ONE);
+            for (int i = 0; i < config.distanceSamples; i++) {
+                int offset = i - config.distanceSamples / 2;
+                int64_t distance = std::max((int64_t)0, center + offset * spacing);
+                if (distance > maxDistance) continue;
+                distanceSamples.push_back({ distance, SAMPLE_WEIGHTS[std::abs(offset)] });
+            }
+        }
+    }
+
+    // Sector cells take the first slots; every ray hit and exact F4 point gets its own.
+    // Sorting by position before conversion brings the slots of one cell or point together
+    // and keeps the order independent of where cells live in memory.
+    std::vector<FixedCellAccumulator> accumulators;
+    accumulators.reserve(ACCUMULATOR_RESERVE);
+    auto accumulate = [](FixedCellAccumulator& entry, uint64_t weight, int64_t projectionX, int64_t projectionZ) {
+        entry.weight += weight;
+        entry.sumX += projectionX;
+        entry.sumZ += projectionZ;
+        entry.projections++;
+    };
+
+    trimStrongholdCellCache();
+    std::vector<const StrongholdCell*> nearbyCells;
+
+    // F4 samples can only reach the cells around their annulus sector; collect those once.
+    // The sector is a superset and the margin test below decides, so results do not
+    // depend on the floating-point angle used to find it.
+    std::vector<const StrongholdCell*> sectorCells;
+    if (useTargetDistance && !distanceSamples.empty()) {
+        int64_t minSample = distanceSamples[0].first, maxSample = minSample;
+        for (const auto& sample : distanceSamples) {
+            minSample = std::min(minSample, sample.first);
+            maxSample = std::max(maxSample, sample.first);
+        }
+        double angle = std::atan2((double)dirX, -(double)dirZ) * 180.0 / M_PI;
+        double halfAngle = (rotations.count / 2) * (config.angleStdDev / 2.0) + 0.01;
+        strongholdCellsInWedge((double)eyeStartX / FIXED_ONE, (double)eyeStartZ / FIXED_ONE, angle, halfAngle,
+            (double)minSample / FIXED_ONE, (double)maxSample / FIXED_ONE, config.f4CellMargin + 1.0, sectorCells);
+        for (const StrongholdCell* cell : sectorCells) {
+            accumulators.push_back(cellAccumulator(cell, (int64_t)cell->centerX * FIXED_ONE, (int64_t)cell->centerZ * FIXED_ONE));
+        }
+    }
+
+    // fixedLength(d) > cellMargin exactly when the squared length exceeds this
+    int64_t marginSquared = (cellMargin + 1) * (cellMargin + 1) - 1;
+
+    bool anySampleHitCell = false;
+    for (int a = 0; a < rotations.count; a++) {
+        int64_t dx = roundShift(unitX * rotations.cosQ30[a] - unitZ * rotations.sinQ30[a], FIXED_DIRECTION_BITS);
+        int64_t dz = roundShift(unitZ * rotations.cosQ30[a] + unitX * rotations.sinQ30[a], FIXED_DIRECTION_BITS);
+        int64_t angleWeight = rotations.weights[a];
+
+        if (useTargetDistance) {
+            for (const auto& sample : distanceSamples) {
+                int64_t combinedWeight = (angleWeight * sample.second) >> FIXED_WEIGHT_BITS;
+                int64_t exactX = eyeStartX + roundShift(sample.first * dx, FIXED_DIRECTION_BITS);
+                int64_t exactZ = eyeStartZ + roundShift(sample.first * dz, FIXED_DIRECTION_BITS);
+
+                // Margin test in integers against the sector's cells
+                bool hitAnyCell = false;
+                for (size_t slot = 0; slot < sectorCells.size(); slot++) {
+                    FixedCellAccumulator& entry = accumulators[slot];
+                    int64_t clampedX = std::max(entry.xMin, std::min(entry.xMax, exactX));
+                    int64_t clampedZ = std::max(entry.zMin, std::min(entry.zMax, exactZ));
+                    int64_t offsetX = clampedX - exactX, offsetZ = clampedZ - exactZ;
+                    if (std::abs(offsetX) > cellMargin || std::abs(offsetZ) > cellMargin) continue;
+                    if (offsetX * offsetX + offsetZ * offsetZ > marginSquared) continue;
+
+                    hitAnyCell = true;
+                    accumulate(entry, (uint64_t)combinedWeight, clampedX, clampedZ);
+                }
+
+                anySampleHitCell = anySampleHitCell || hitAnyCell;
+
+                // Exact F4 points that don't hit any cell become standalone candidates
+                if (!hitAnyCell) {
+                    accumulators.push_back({ nullptr, exactX, exactZ, exactX, exactX, exactZ, exactZ, 0, 0, 0, 0 });
+                    accumulate(accumulators.back(), (uint64_t)combinedWeight, exactX, exactZ);
+                }
+            }
+        }
+        else {
+            // Ray cast from the eye start; cells whose center projects inside them are hit
+            strongholdCellsAlongRay((double)eyeStartX / FIXED_ONE, (double)eyeStartZ / FIXED_ONE,
+                (double)dx / ((int64_t)1 << FIXED_DIRECTION_BITS), (double)dz / ((int64_t)1 << FIXED_DIRECTION_BITS),
+                config.maxRayDistance, nearbyCells);
+            for (const StrongholdCell* cell : nearbyCells) {
+                int64_t centerX = (int64_t)(cell->centerX * FIXED_ONE);
+                int64_t centerZ = (int64_t)(cell->centerZ * FIXED_ONE);
+                int64_t t = roundShift((centerX - eyeStartX) * dx + (centerZ - eyeStartZ) * dz, FIXED_DIRECTION_BITS);
+                if (t <= 0) continue;
+
+                int64_t projectionX = eyeStartX + roundShift(t * dx, FIXED_DIRECTION_BITS);
+                int64_t projectionZ = eyeStartZ + roundShift(t * dz, FIXED_DIRECTION_BITS);
+                if (projectionX < (int64_t)cell->xMin * FIXED_ONE || projectionX > (int64_t)cell->xMax * FIXED_ONE ||
+                    projectionZ < (int64_t)cell->zMin * FIXED_ONE || projectionZ > (int64_t)cell->zMax * FIXED_ONE) {
+                    continue;
+                }
+
+                accumulators.push_back(cellAccumulator(cell, centerX, centerZ));
+                accumulate(accumulators.back(), (uint64_t)angleWeight, projectionX, projectionZ);
+            }
+        }
+    }
+
+    // Convert accumulated likelihoods to candidates
+    TRACE_SPAN("format candidates");
+    std::sort(accumulators.begin(), accumulators.end(), [](const FixedCellAccumulator& a, const FixedCellAccumulator& b) {
+        return a.pointX != b.pointX ? a.pointX < b.pointX : a.pointZ < b.pointZ;
+    });
+    // Fold the slots of each cell or exact point into one. Integer sums do not depend on
+    // the order, and an exact point never sits at a cell center since it would hit the cell.
+    size_t merged = 0;
+    for (size_t i = 0; i < accumulators.size(); i++) {
+        const FixedCellAccumulator& entry = accumulators[i];
+        if (merged > 0) {
+            FixedCellAccumulator& previous = accumulators[merged - 1];
+            if (entry.pointX == previous.pointX && entry.pointZ == previous.pointZ) {
+                previous.weight += entry.weight;
+                previous.sumX += entry.sumX;
+                previous.sumZ += entry.sumZ;
+                previous.projections += entry.projections;
+                continue;
+            }
+        }
+        accumulators[merged++] = entry;
+    }
+    accumulators.resize(merged);
+
+    // Each cell's prior is converted once, and sum(weight * prior) == sum(weight) * prior
+    for (FixedCellAccumulator& entry : accumulators) {
+        entry.weight *= entry.cell ? (uint64_t)std::llround(entry.cell->prob * (1 << FIXED_PRIOR_BITS)) : VIRTUAL_CELL_PRIOR;
+    }
+    uint64_t totalWeight = 0;
+    for (const FixedCellAccumulator& entry : accumulators) {
+        if (entry.weight == 0 || entry.projections == 0) continue;
+
+        int64_t avgX = roundDivide(entry.sumX, entry.projections);
+        int64_t avgZ = roundDivide(entry.sumZ, entry.projections);
+        int64_t distanceToProjection = fixedLength(avgX - (int64_t)playerX * FIXED_ONE, avgZ - (int64_t)playerZ * FIXED_ONE);
+
+        StrongholdCandidate candidate;
+        candidate.projectionX = (int)roundShift(avgX, FIXED_POSITION_BITS);
+        candidate.projectionZ = (int)roundShift(avgZ, FIXED_POSITION_BITS);
+        candidate.netherX = (int)roundShift(avgX, FIXED_POSITION_BITS + 3);
+        candidate.netherZ = (int)roundShift(avgZ, FIXED_POSITION_BITS + 3);
+        candidate.rawProb = (double)entry.weight;
+        candidate.distance = (int)roundShift(distanceToProjection, FIXED_POSITION_BITS);
+
+        if (entry.cell) {
+            candidate.cellCenterX = entry.cell->centerX;
+            candidate.cellCenterZ = entry.cell->centerZ;
+            candidate.distanceFromOrigin = (int)std::llround(entry.cell->distance);
+            candidate.distanceRange = entry.cell->distanceRange;
+
+            WideFormatBuffer text;
+            text.text(L"(").integer((int)entry.cell->xMin).text(L", ").integer((int)entry.cell->zMin)
+                .text(L") to (").integer((int)entry.cell->xMax).text(L", ").integer((int)entry.cell->zMax).text(L")");
+            candidate.bounds = text.str();
+        }
+        else {
+            int64_t originDistance = roundShift(fixedLength(entry.pointX, entry.pointZ), FIXED_POSITION_BITS);
+            candidate.cellCenterX = (double)entry.pointX / FIXED_ONE;
+            candidate.cellCenterZ = (double)entry.pointZ / FIXED_ONE;
+            candidate.distanceFromOrigin = (int)originDistance;
+            candidate.distanceRange = (int)((originDistance + 50) / 100 * 100);
+            candidate.bounds = L"Exact F4 distance point";
+        }
+
+        strongholdCandidates.push_back(candidate);
+        totalWeight += entry.weight;
+    }
+
+    for (auto& candidate : strongholdCandidates) {
+        candidate.conditionalProb = totalWeight > 0 ? candidate.rawProb / (double)totalWeight : 0.0;
+    }
+
+    // Highest likelihood first; exact ties ordered by position so the order is total
+    std::sort(strongholdCandidates.begin(), strongholdCandidates.end(),
+        [](const StrongholdCandidate& a, const StrongholdCandidate& b) {
+            if (a.rawProb != b.rawProb) return a.rawProb > b.rawProb;
+            if (a.projectionX != b.projectionX) return a.projectionX < b.projectionX;
+            return a.projectionZ < b.projectionZ;
+        });
+
+    if (useTargetDistance && !anySampleHitCell) {
+        appState.distanceValidationFailed = true;
+        appState.validationErrorMessage = F4_DISTANCE_MISMATCH_MESSAGE;
+    }
+
+    metrics.solves.add();
+    metrics.solveCandidates.record((double)strongholdCandidates.size());
+    if (appState.distanceValidationFailed) {
+        metrics.distanceValidationFailures.add();
+    }
+}
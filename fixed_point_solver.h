@@ -0,0 +1,29 @@
+#pragma once
+#define NOMINMAX
+#include <cstdint>
+#include "app_state.h"
+
+// Deterministic variant of calculateStrongholdLocationWithDistance. Positions are
+// 48.16 fixed-point blocks, directions Q30 unit vectors rotated by sample angles
+// computed in integers, and likelihoods are integers summed exactly, so the result does
+// not depend on libm or on the order cells are visited. Only the F4 press
+// likelihood is computed in floating point; its samples are rounded to 16 bits
+// before use.
+
+const int FIXED_POSITION_BITS = 16;     // Fractional bits of block positions
+const int FIXED_DIRECTION_BITS = 30;    // Fractional bits of unit direction vectors
+const int FIXED_WEIGHT_BITS = 16;       // Fractional bits of sample weights
+const int FIXED_PRIOR_BITS = 24;        // Fractional bits of cell priors
+
+// Input range that keeps every 48.16 product within 64 bits. Distances times a Q30
+// direction need distance < 2^15 blocks; positions stay far below 2^47.
+const int FIXED_MAX_COORDINATE = 30000000;     // World border
+const double FIXED_MAX_DISTANCE = 30000.0;     // Longest F4 sample, MaxRayDistance's upper bound
+
+// Solve a throw from (playerX, playerZ) towards the integer direction (directionX, directionZ).
+// rawProb of each candidate holds its integer likelihood. A player outside
+// FIXED_MAX_COORDINATE gives no candidates; F4 samples past FIXED_MAX_DISTANCE are skipped.
+void calculateStrongholdLocationFixedPoint(int playerX, int playerZ, int directionX, int directionZ);
+
+// Floor square root of a 64-bit integer
+uint64_t integerSqrt(uint64_t value);
@@ -0,0 +1,87 @@
+// Compares the wstringstream row path with FormatBuffer for the main window table row.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 format_benchmark.cpp number_format.cpp metrics.cpp -o format_benchmark
+#define NOMINMAX
+#include "number_format.h"
+#include "metrics.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+const int BENCHMARK_ROWS = 200000;
+
+struct BenchmarkRow {
+    int projectionX, projectionZ;
+    int netherX, netherZ;
+    double conditionalProb;
+    int distance;
+};
+
+static std::wstring streamRow(int rank, const BenchmarkRow& row) {
+    std::wstringstream ss;
+    ss << L"#" << rank << L"   ("
+        << std::setw(5) << row.projectionX << L"," << std::setw(5) << row.projectionZ << L")   ("
+        << std::setw(4) << row.netherX << L"," << std::setw(4) << row.netherZ << L")      "
+        << std::fixed << std::setprecision(1) << std::setw(5)
+        << (row.conditionalProb * 100.0) << L"%     "
+        << row.distance << L"m";
+    return ss.str();
+}
+
+static void bufferRow(WideFormatBuffer& text, int rank, const BenchmarkRow& row) {
+    text.clear();
+    text.text(L"#").integer(rank).text(L"   (")
+        .integer(row.projectionX, 5).text(L",").integer(row.projectionZ, 5).text(L")   (")
+        .integer(row.netherX, 4).text(L",").integer(row.netherZ, 4).text(L")      ")
+        .fixed(row.conditionalProb * 100.0, 1, 5).text(L"%     ")
+        .integer(row.distance).text(L"m");
+}
+
+int main() {
+    std::vector<BenchmarkRow> rows;
+    for (int i = 0; i < 64; i++) {
+        int x = (i * 7919) % 6000 - 3000;
+        int z = (i * 104729) % 6000 - 3000;
+        rows.push_back({ x, z, x / 8, z / 8, (i % 17) / 17.0, 500 + i * 31 });
+    }
+
+    // Both paths must produce the same text
+    for (size_t i = 0; i < rows.size(); i++) {
+        WideFormatBuffer text;
+        bufferRow(text, (int)i + 1, rows[i]);
+        if (text.str() != streamRow((int)i + 1, rows[i])) {
+            std::wcerr << L"Mismatch on row " << i << L": " << text.c_str() << L"\n";
+            return 1;
+        }
+    }
+
+    size_t checksum = 0;
+
+    uint64_t allocationsBefore = allocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ROWS; i++) {
+        checksum += streamRow(i % 10 + 1, rows[i % rows.size()]).size();
+    }
+    double streamNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    uint64_t streamAllocations = allocationCount() - allocationsBefore;
+
+    allocationsBefore = allocationCount();
+    start = std::chrono::steady_clock::now();
+    WideFormatBuffer text;
+    for (int i = 0; i < BENCHMARK_ROWS; i++) {
+        bufferRow(text, i % 10 + 1, rows[i % rows.size()]);
+        checksum += text.size();
+    }
+    double bufferNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    uint64_t bufferAllocations = allocationCount() - allocationsBefore;
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "wstringstream: " << (streamNs / BENCHMARK_ROWS) << " ns/row, "
+        << ((double)streamAllocations / BENCHMARK_ROWS) << " allocations/row\n"
+        << "FormatBuffer:  " << (bufferNs / BENCHMARK_ROWS) << " ns/row, "
+        << ((double)bufferAllocations / BENCHMARK_ROWS) << " allocations/row\n"
+        << "(checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,201 @@
+#define NOMINMAX
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+GlyphAtlas::GlyphAtlas() : asciiIndex(FONT_COUNT * 128, -1) {
+    for (int i = 0; i < FONT_COUNT; i++) {
+        fontOriginX[i] = 0.0f;
+        fontLineHeight[i] = displayFontSpec((DisplayFont)i).size;
+    }
+}
+
+void GlyphAtlas::setFontMetrics(DisplayFont font, float originX, float lineHeight) {
+    fontOriginX[font] = originX;
+    fontLineHeight[font] = lineHeight;
+}
+
+void GlyphAtlas::addGlyph(DisplayFont font, wchar_t ch, int width, int height, int offsetX, int offsetY,
+    float advance, const uint8_t* mask) {
+    int stride = width;
+    width = std::min(width, GLYPH_ATLAS_WIDTH);
+
+    // Start a new shelf when the glyph does not fit on the current one
+    if (shelfX + width > GLYPH_ATLAS_WIDTH) {
+        shelfY += shelfHeight + 1;
+        shelfX = 0;
+        shelfHeight = 0;
+    }
+    shelfHeight = std::max(shelfHeight, height);
+    if ((int)(coverage.size() / GLYPH_ATLAS_WIDTH) < shelfY + shelfHeight) {
+        coverage.resize((size_t)(shelfY + shelfHeight) * GLYPH_ATLAS_WIDTH, 0);
+    }
+
+    Glyph glyph;
+    glyph.atlasX = shelfX;
+    glyph.atlasY = shelfY;
+    glyph.width = width;
+    glyph.height = height;
+    glyph.offsetX = offsetX;
+    glyph.offsetY = offsetY;
+    glyph.advance = advance;
+
+    for (int row = 0; row < height; row++) {
+        std::memcpy(&coverage[(size_t)(shelfY + row) * GLYPH_ATLAS_WIDTH + shelfX], mask + (size_t)row * stride, width);
+    }
+    shelfX += width + 1;
+
+    int index = (int)glyphs.size();
+    glyphs.push_back(glyph);
+    if (ch < 128) {
+        asciiIndex[font * 128 + ch] = index;
+    }
+    else {
+        extraIndex.push_back({ font, ch, index });
+    }
+}
+
+const Glyph* GlyphAtlas::findGlyph(DisplayFont font, wchar_t ch) const {
+    if (ch < 128) {
+        int index = asciiIndex[font * 128 + ch];
+        return index >= 0 ? &glyphs[index] : nullptr;
+    }
+    for (const auto& key : extraIndex) {
+        if (key.font == font && key.ch == ch) return &glyphs[key.index];
+    }
+    return nullptr;
+}
+
+bool GlyphAtlas::supports(DisplayFont font, const std::wstring& text) const {
+    for (wchar_t ch : text) {
+        if (ch != L'\n' && !findGlyph(font, ch)) return false;
+    }
+    return true;
+}
+
+void PixelBuffer::resize(int newWidth, int newHeight) {
+    width = std::max(0, newWidth);
+    height = std::max(0, newHeight);
+    pixels.assign((size_t)width * height, 0);
+}
+
+static uint32_t premultiply(uint32_t argb) {
+    uint32_t a = argb >> 24;
+    uint32_t r = ((argb >> 16) & 0xFF) * a / 255;
+    uint32_t g = ((argb >> 8) & 0xFF) * a / 255;
+    uint32_t b = (argb & 0xFF) * a / 255;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Source-over blend of a premultiplied color scaled by an 8-bit coverage
+static uint32_t blend(uint32_t dst, uint32_t src, uint32_t cover) {
+    uint32_t sa = ((src >> 24) * cover + 127) / 255;
+    uint32_t inv = 255 - sa;
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t s = (((src >> shift) & 0xFF) * cover + 127) / 255;
+        uint32_t d = (dst >> shift) & 0xFF;
+        result |= std::min(255u, s + (d * inv + 127) / 255) << shift;
+    }
+    return result;
+}
+
+static DisplayRect intersect(const DisplayRect& a, const DisplayRect& b) {
+    return { std::max(a.left, b.left), std::max(a.top, b.top), std::min(a.right, b.right), std::min(a.bottom, b.bottom) };
+}
+
+// Fills replace pixels, matching Graphics::Clear
+static void fillRect(PixelBuffer& buffer, int x, int y, int width, int height, uint32_t color, const DisplayRect& clip) {
+    DisplayRect area = intersect({ x, y, x + width, y + height }, clip);
+    uint32_t pixel = premultiply(color);
+    for (int row = area.top; row < area.bottom; row++) {
+        std::fill(&buffer.pixels[(size_t)row * buffer.width + area.left],
+            &buffer.pixels[(size_t)row * buffer.width + std::max(area.left, area.right)], pixel);
+    }
+}
+
+static void blendRect(PixelBuffer& buffer, int x, int y, int width, int height, uint32_t color, const DisplayRect& clip) {
+    DisplayRect area = intersect({ x, y, x + width, y + height }, clip);
+    uint32_t pixel = premultiply(color);
+    for (int row = area.top; row < area.bottom; row++) {
+        uint32_t* line = &buffer.pixels[(size_t)row * buffer.width];
+        for (int col = area.left; col < area.right; col++) {
+            line[col] = blend(line[col], pixel, 255);
+        }
+    }
+}
+
+// Pen is centered on the rectangle outline, like GDI+ DrawRectangle
+static void frameRect(PixelBuffer& buffer, const DisplayItem& item, const DisplayRect& clip) {
+    int pen = std::max(1, item.penWidth);
+    int half = pen / 2;
+    int left = item.x - half, top = item.y - half;
+    int right = item.x + item.width - half, bottom = item.y + item.height - half;
+    blendRect(buffer, left, top, item.width + pen, pen, item.color, clip);
+    blendRect(buffer, left, bottom, item.width + pen, pen, item.color, clip);
+    blendRect(buffer, left, top + pen, pen, bottom - top - pen, item.color, clip);
+    blendRect(buffer, right, top + pen, pen, bottom - top - pen, item.color, clip);
+}
+
+static bool drawText(PixelBuffer& buffer, const GlyphAtlas& atlas, const DisplayItem& item, const DisplayRect& clip) {
+    uint32_t pixel = premultiply(item.color);
+    bool complete = true;
+    float penX = item.x + atlas.originX(item.font);
+    int baseY = item.y;
+
+    for (wchar_t ch : item.text) {
+        if (ch == L'\n') {
+            penX = item.x + atlas.originX(item.font);
+            baseY += (int)std::lround(atlas.lineHeight(item.font));
+            continue;
+        }
+
+        const Glyph* glyph = atlas.findGlyph(item.font, ch);
+        if (!glyph) {
+            complete = false;
+            continue;
+        }
+
+        int glyphX = (int)std::lround(penX) + glyph->offsetX;
+        int glyphY = baseY + glyph->offsetY;
+        DisplayRect area = intersect({ glyphX, glyphY, glyphX + glyph->width, glyphY + glyph->height }, clip);
+
+        for (int row = area.top; row < area.bottom; row++) {
+            const uint8_t* mask = atlas.coverageRow(glyph->atlasY + row - glyphY) + glyph->atlasX;
+            uint32_t* line = &buffer.pixels[(size_t)row * buffer.width];
+            for (int col = area.left; col < area.right; col++) {
+                uint32_t cover = mask[col - glyphX];
+                if (cover) line[col] = blend(line[col], pixel, cover);
+            }
+        }
+        penX += glyph->advance;
+    }
+    return complete;
+}
+
+bool renderDisplayList(PixelBuffer& buffer, const GlyphAtlas& atlas, const DisplayList& list, const DisplayRect& clip) {
+    DisplayRect area = intersect(clip, { 0, 0, buffer.width, buffer.height });
+    if (area.left >= area.right || area.top >= area.bottom) return true;
+
+    bool complete = true;
+    for (const auto& item : list) {
+        DisplayRect itemArea = intersect(item.bounds, area);
+        if (itemArea.left >= itemArea.right || itemArea.top >= itemArea.bottom) continue;
+
+        switch (item.kind) {
+        case DISPLAY_FILL_RECT:
+            fillRect(buffer, item.x, item.y, item.width, item.height, item.color, area);
+            break;
+        case DISPLAY_FRAME_RECT:
+            frameRect(buffer, item, area);
+            break;
+        case DISPLAY_TEXT:
+        case DISPLAY_WRAPPED_TEXT:
+            // Wrapped text is not laid out here; the overlay never uses it
+            if (item.kind == DISPLAY_WRAPPED_TEXT || !drawText(buffer, atlas, item, area)) complete = false;
+            break;
+        }
+    }
+    return complete;
+}
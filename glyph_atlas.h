@@ -0,0 +1,73 @@
+#pragma once
+#define NOMINMAX
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "display_list.h"
+
+// Software text renderer for the overlay. Glyph coverage masks are rasterized once
+// (by the platform layer) into a single 8-bit atlas, then blitted into a premultiplied
+// ARGB pixel buffer. Nothing here depends on Win32, so rendering can run in memory.
+
+const int GLYPH_ATLAS_WIDTH = 512;
+
+// Characters the overlay needs beyond printable ASCII
+const wchar_t GLYPH_EXTRA_CHARS[] = L"°→•⚠";
+
+struct Glyph {
+    int atlasX, atlasY;     // Top-left of the coverage mask in the atlas
+    int width, height;      // Mask size
+    int offsetX, offsetY;   // Mask position relative to the pen position
+    float advance;          // Pen advance after this glyph
+};
+
+class GlyphAtlas {
+public:
+    GlyphAtlas();
+
+    // Per-font metrics: x offset of the first glyph and distance between lines
+    void setFontMetrics(DisplayFont font, float originX, float lineHeight);
+
+    // Copy a coverage mask (width * height bytes, row-major) into the atlas
+    void addGlyph(DisplayFont font, wchar_t ch, int width, int height, int offsetX, int offsetY,
+        float advance, const uint8_t* coverage);
+
+    const Glyph* findGlyph(DisplayFont font, wchar_t ch) const;
+    bool supports(DisplayFont font, const std::wstring& text) const;
+    bool empty() const { return glyphs.empty(); }
+
+    float originX(DisplayFont font) const { return fontOriginX[font]; }
+    float lineHeight(DisplayFont font) const { return fontLineHeight[font]; }
+
+    const uint8_t* coverageRow(int atlasY) const { return &coverage[(size_t)atlasY * GLYPH_ATLAS_WIDTH]; }
+
+private:
+    struct GlyphKey {
+        DisplayFont font;
+        wchar_t ch;
+        int index;
+    };
+
+    std::vector<uint8_t> coverage;          // GLYPH_ATLAS_WIDTH bytes per row
+    std::vector<Glyph> glyphs;
+    std::vector<int> asciiIndex;            // FONT_COUNT * 128, -1 when missing
+    std::vector<GlyphKey> extraIndex;       // Non-ASCII glyphs, searched linearly
+    float fontOriginX[FONT_COUNT];
+    float fontLineHeight[FONT_COUNT];
+
+    // Shelf packer state
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+};
+
+// Premultiplied 0xAARRGGBB pixels, top-down rows
+struct PixelBuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+
+    void resize(int newWidth, int newHeight);
+};
+
+// Render the display list items that intersect the clip rectangle. Returns false if
+// a text item used a glyph missing from the atlas (the rest is still rendered).
+bool renderDisplayList(PixelBuffer& buffer, const GlyphAtlas& atlas, const DisplayList& list, const DisplayRect& clip);
@@ -0,0 +1,257 @@
+// Checks the glyph atlas renderer and times overlay frames rendered in memory.
+// Everywhere it checks glyph placement against the atlas masks and that repainting
+// only the rectangles diffDisplayLists returns gives the same pixels as a full frame.
+// On Windows it also renders the overlay with the old GDI+ DrawString path and
+// compares the two pixel by pixel. Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 glyph_atlas_benchmark.cpp glyph_atlas.cpp display_list.cpp number_format.cpp -o glyph_atlas_benchmark
+// or with the GDI+ comparison:
+//   cl /std:c++17 /EHsc /O2 /DUNICODE glyph_atlas_benchmark.cpp glyph_atlas.cpp display_list.cpp
+//      display_renderer.cpp number_format.cpp
+#define NOMINMAX
+#ifdef _WIN32
+#include "display_renderer.h"
+#endif
+#include "glyph_atlas.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+const int OVERLAY_WIDTH = 380;
+const int OVERLAY_HEIGHT = 320;
+const int BENCHMARK_FRAMES = 2000;
+
+// GDI+ and the atlas antialias glyph edges differently; beyond these the atlas text
+// has moved or lost glyphs rather than shading edges differently
+const double MAX_MEAN_CHANNEL_DIFFERENCE = 4.0;
+const double MAX_FAR_OFF_PIXELS = 0.01;     // Fraction of pixels off by more than FAR_OFF_DIFFERENCE
+const int FAR_OFF_DIFFERENCE = 96;
+
+static const DisplayFont overlayFonts[] = {
+    FONT_OVERLAY_HEADER, FONT_OVERLAY_COORD, FONT_OVERLAY_INFO, FONT_OVERLAY_SMALL
+};
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+// Deterministic masks narrower than the advance, so neighbouring glyphs never overlap
+static void buildSyntheticAtlas(GlyphAtlas& atlas) {
+    std::wstring characters;
+    for (wchar_t ch = 0x20; ch < 0x7F; ch++) {
+        characters += ch;
+    }
+    characters += GLYPH_EXTRA_CHARS;
+
+    std::vector<uint8_t> mask;
+    for (DisplayFont font : overlayFonts) {
+        atlas.setFontMetrics(font, 1.5f, displayFontSpec(font).size * 1.25f);
+        for (wchar_t ch : characters) {
+            int width = 4 + ch % 4, height = 8 + ch % 3;
+            mask.assign((size_t)width * height, 0);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    mask[(size_t)y * width + x] = (uint8_t)(1 + (x * 31 + y * 17 + ch * 7) % 255);
+                }
+            }
+            atlas.addGlyph(font, ch, width, height, ch % 2, 2, 8.25f, mask.data());
+        }
+    }
+}
+
+// Opaque white text on a transparent buffer: every channel of a covered pixel is its coverage
+static void checkGlyphPlacement(const GlyphAtlas& atlas) {
+    DisplayList list(1);
+    DisplayItem& item = list[0];
+    item.kind = DISPLAY_TEXT;
+    item.x = 7;
+    item.y = 5;
+    item.color = 0xFFFFFFFF;
+    item.font = FONT_OVERLAY_COORD;
+    item.text.text(L"-1234,567\n°→•⚠ Ab");
+    item.bounds = { 0, 0, 200, 100 };
+
+    PixelBuffer buffer;
+    buffer.resize(200, 100);
+    check(renderDisplayList(buffer, atlas, list, { 0, 0, 200, 100 }), "every glyph is in the atlas");
+
+    PixelBuffer expected;
+    expected.resize(200, 100);
+    float penX = item.x + atlas.originX(item.font);
+    int baseY = item.y;
+    for (wchar_t ch : item.text) {
+        if (ch == L'\n') {
+            penX = item.x + atlas.originX(item.font);
+            baseY += (int)std::lround(atlas.lineHeight(item.font));
+            continue;
+        }
+        const Glyph* glyph = atlas.findGlyph(item.font, ch);
+        int glyphX = (int)std::lround(penX) + glyph->offsetX;
+        int glyphY = baseY + glyph->offsetY;
+        for (int row = 0; row < glyph->height; row++) {
+            for (int col = 0; col < glyph->width; col++) {
+                uint32_t cover = atlas.coverageRow(glyph->atlasY + row)[glyph->atlasX + col];
+                expected.pixels[(size_t)(glyphY + row) * expected.width + glyphX + col] = cover * 0x01010101u;
+            }
+        }
+        penX += glyph->advance;
+    }
+    check(buffer.pixels == expected.pixels, "glyphs land at their pen positions with their coverage");
+}
+
+static std::vector<StrongholdCandidate> sampleCandidates() {
+    std::vector<StrongholdCandidate> candidates;
+    for (int i = 0; i < 10; i++) {
+        StrongholdCandidate candidate = {};
+        candidate.projectionX = 1200 + 37 * i;
+        candidate.projectionZ = -2400 + 53 * i;
+        candidate.netherX = candidate.projectionX / 8;
+        candidate.netherZ = candidate.projectionZ / 8;
+        candidate.conditionalProb = 0.4 / (i + 1);
+        candidate.distance = 2600 + 10 * i;
+        candidates.push_back(candidate);
+    }
+    return candidates;
+}
+
+// The overlay after the player's second direction key, with six candidate rows
+static ApplicationState resultState() {
+    ApplicationState state;
+    state.f4PressedFirst = true;
+    state.distanceKeyPresses = 2;
+    state.calculatedDistance = 1400.0;
+    state.capturePhase = 2;
+    state.lastAngle = 123.4;
+    return state;
+}
+
+// WM_PAINT keeps the buffer and renders only the invalidated rectangles
+static void checkPartialRepaint(const GlyphAtlas& atlas) {
+    SolverConfig config;
+    std::vector<StrongholdCandidate> candidates = sampleCandidates();
+    ApplicationState state = resultState();
+    DisplayList previous = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    state.distanceKeyPresses = 3;
+    state.calculatedDistance = 1600.0;
+    candidates[0].conditionalProb = 0.5;
+    DisplayList next = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+
+    PixelBuffer retained, full;
+    retained.resize(OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    full.resize(OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    renderDisplayList(retained, atlas, previous, { 0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT });
+    for (const auto& rect : diffDisplayLists(previous, next)) {
+        renderDisplayList(retained, atlas, next, rect);
+    }
+    renderDisplayList(full, atlas, next, { 0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT });
+    check(retained.pixels == full.pixels, "repainting the dirty rectangles matches a full frame");
+}
+
+static void timeFrames(const GlyphAtlas& atlas) {
+    SolverConfig config;
+    std::vector<StrongholdCandidate> candidates = sampleCandidates();
+    ApplicationState state = resultState();
+    DisplayList list = buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    state.distanceKeyPresses = 3;
+    auto dirty = diffDisplayLists(list, buildOverlayDisplayList(state, candidates, config, OVERLAY_WIDTH, OVERLAY_HEIGHT));
+
+    PixelBuffer buffer;
+    buffer.resize(OVERLAY_WIDTH, OVERLAY_HEIGHT);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+        renderDisplayList(buffer, atlas, list, { 0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT });
+    }
+    auto fullEnd = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+        for (const auto& rect : dirty) {
+            renderDisplayList(buffer, atlas, list, rect);
+        }
+    }
+    auto partialEnd = std::chrono::steady_clock::now();
+
+    std::cout << "Full " << OVERLAY_WIDTH << "x" << OVERLAY_HEIGHT << " overlay frame ("
+        << list.size() << " items): " << std::chrono::duration<double, std::micro>(fullEnd - start).count() / BENCHMARK_FRAMES
+        << " us, F4 press repaint: " << std::chrono::duration<double, std::micro>(partialEnd - fullEnd).count() / BENCHMARK_FRAMES
+        << " us\n";
+}
+
+#ifdef _WIN32
+// Render the same overlay frame with PaintDisplayList (DrawString) and the atlas built
+// from the same fonts, and compare premultiplied pixels
+static void compareWithGdiPlus() {
+    GdiplusStartupInput startupInput;
+    ULONG_PTR token;
+    GdiplusStartup(&token, &startupInput, NULL);
+    {
+        GlyphAtlas atlas;
+        BuildGlyphAtlas(atlas, overlayFonts, 4);
+
+        SolverConfig config;
+        DisplayList list = buildOverlayDisplayList(resultState(), sampleCandidates(), config, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+        PixelBuffer buffer;
+        buffer.resize(OVERLAY_WIDTH, OVERLAY_HEIGHT);
+        check(renderDisplayList(buffer, atlas, list, { 0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT }), "the overlay text is in the atlas");
+
+        // The atlas is rasterized with grayscale antialiasing, so draw the reference the same way
+        Bitmap bitmap(OVERLAY_WIDTH, OVERLAY_HEIGHT, PixelFormat32bppPARGB);
+        RECT clip = { 0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT };
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < BENCHMARK_FRAMES / 10; frame++) {
+            Graphics graphics(&bitmap);
+            graphics.SetTextRenderingHint(TextRenderingHintAntiAlias);
+            PaintDisplayList(graphics, list, clip);
+        }
+        double gdiUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+            / (BENCHMARK_FRAMES / 10);
+
+        BitmapData data;
+        Rect lockRect(0, 0, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+        bitmap.LockBits(&lockRect, ImageLockModeRead, PixelFormat32bppPARGB, &data);
+        double totalDifference = 0.0;
+        int farOff = 0;
+        for (int y = 0; y < OVERLAY_HEIGHT; y++) {
+            const uint32_t* reference = (const uint32_t*)((const uint8_t*)data.Scan0 + (size_t)y * data.Stride);
+            for (int x = 0; x < OVERLAY_WIDTH; x++) {
+                uint32_t a = reference[x], b = buffer.pixels[(size_t)y * OVERLAY_WIDTH + x];
+                int worst = 0;
+                for (int shift = 0; shift < 32; shift += 8) {
+                    int difference = std::abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF));
+                    totalDifference += difference;
+                    worst = std::max(worst, difference);
+                }
+                if (worst > FAR_OFF_DIFFERENCE) farOff++;
+            }
+        }
+        bitmap.UnlockBits(&data);
+
+        double pixels = (double)OVERLAY_WIDTH * OVERLAY_HEIGHT;
+        double meanDifference = totalDifference / (pixels * 4);
+        std::cout << "GDI+ DrawString frame: " << gdiUs << " us; atlas differs by " << meanDifference
+            << " per channel on average, " << farOff << " pixels by more than " << FAR_OFF_DIFFERENCE << "\n";
+        check(meanDifference <= MAX_MEAN_CHANNEL_DIFFERENCE, "atlas frame is close to the GDI+ frame on average");
+        check(farOff <= MAX_FAR_OFF_PIXELS * pixels, "few atlas pixels are far from the GDI+ frame");
+    }
+    ReleaseDisplayResources();
+    GdiplusShutdown(token);
+}
+#endif
+
+int main() {
+    GlyphAtlas atlas;
+    buildSyntheticAtlas(atlas);
+    checkGlyphPlacement(atlas);
+    checkPartialRepaint(atlas);
+    timeFrames(atlas);
+#ifdef _WIN32
+    compareWithGdiPlus();
+#endif
+
+    std::cout << (ok ? "All glyph atlas checks passed\n" : "Glyph atlas checks FAILED\n");
+    return ok ? 0 : 1;
+}
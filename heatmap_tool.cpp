@@ -0,0 +1,64 @@
+// Exports the solver posterior as a PGM tile pyramid for inspection.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread heatmap_tool.cpp posterior_heatmap.cpp capture_state_machine.cpp
+//       stronghold_calculator.cpp fixed_point_solver.cpp first_throw_table.cpp cell_lattice.cpp ring_prior.cpp
+//       distance_estimator.cpp solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o heatmap
+#define NOMINMAX
+#include "posterior_heatmap.h"
+#include "capture_state_machine.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: heatmap <output dir> <minX,minZ,maxX,maxZ> <capture_log.txt> [--session]\n"
+            << "Renders the last throw in the log, or every throw combined with --session.\n";
+        return 1;
+    }
+
+    HeatmapRegion region;
+    char comma;
+    std::istringstream regionText(argv[2]);
+    if (!(regionText >> region.minX >> comma >> region.minZ >> comma >> region.maxX >> comma >> region.maxZ)) {
+        std::cerr << "Bad region: " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::ifstream file(argv[3]);
+    if (!file.is_open()) {
+        std::cerr << "Could not open " << argv[3] << "\n";
+        return 1;
+    }
+    bool session = argc > 4 && std::string(argv[4]) == "--session";
+
+    // Replay the log through the capture logic and keep the throw behind every solve
+    std::vector<HeatmapThrow> throws;
+    CaptureStateMachine machine(appState);
+    machine.setRecording(false);
+    for (const auto& event : readCaptureLog(file)) {
+        if (machine.handleEvent(event) & CAPTURE_ACTION_SOLVE) {
+            if (!session) throws.clear();
+            throws.push_back(heatmapThrowFromState(appState));
+        }
+    }
+    if (throws.empty()) {
+        std::cerr << "No solved throws in the log\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int tiles = exportPosteriorPyramid(throws, region, argv[1], (int)std::thread::hardware_concurrency());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (tiles < 0) {
+        std::cerr << "Could not write to " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << tiles << " tiles from " << throws.size() << " throw(s) in " << seconds << "s\n";
+    return 0;
+}
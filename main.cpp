@@ -6,6 +6,7 @@
 #include "distance_calculator.h"
 #include "overlay_window.h"
 #include "main_window.h"
+#include "display_renderer.h"
 
 // Global variables
 HINSTANCE hInst;
@@ -15,6 +16,7 @@ ULONG_PTR gdiplusToken;
 
 // Application state
 ApplicationState appState;
+CaptureStateMachine captureStateMachine(appState);
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     _In_opt_ HINSTANCE hPrevInstance,
@@ -28,9 +30,6 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     GdiplusStartupInput gdiplusStartupInput;
     GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
 
-    // Initialize stronghold cells
-    generateStrongholdCells();
-
     // Register window classes
     MyRegisterClass(hInstance);
     MyRegisterOverlayClass(hInstance);
@@ -46,6 +45,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         DispatchMessage(&msg);
     }
 
+    ReleaseDisplayResources();
     GdiplusShutdown(gdiplusToken);
     return (int)msg.wParam;
 }
@@ -65,7 +65,7 @@ ATOM MyRegisterClass(HINSTANCE hInstance) {
 BOOL InitInstance(HINSTANCE hInstance, int nCmdShow) {
     hInst = hInstance;
     HWND hWnd = CreateWindowW(szWindowClass, szTitle, WS_OVERLAPPEDWINDOW ^ WS_THICKFRAME,
-        CW_USEDEFAULT, 0, 500, 700, nullptr, nullptr, hInstance, nullptr);
+        CW_USEDEFAULT, 0, 500, 720, nullptr, nullptr, hInstance, nullptr);
     if (!hWnd) return FALSE;
 
     ShowWindow(hWnd, nCmdShow);
@@ -4,43 +4,122 @@
 #include "stronghold_calculator.h"
 #include "distance_calculator.h"
 #include "overlay_window.h"
+#include "trace.h"
+#include "metrics.h"
+#include "display_renderer.h"
+#include "repaint_scheduler.h"
+#include "number_format.h"
+#include "route_planner.h"
+#include "throw_recommender.h"
+#include "first_throw_table.h"
+#include "result_sinks.h"
+#include "capture_worker.h"
+#include "session_log.h"
 #include <fstream>
+#include <sstream>
 #include <shlobj.h>
 
+// Metrics are written to metrics.prom on this interval
+const UINT METRICS_TIMER_ID = 1;
+const UINT METRICS_EXPORT_INTERVAL_MS = 10000;
+
+// Fires when coalesced repaints are due
+const UINT REPAINT_TIMER_ID = 2;
+
+// config.ini is checked for changes on this interval and reloaded live
+const UINT CONFIG_TIMER_ID = 3;
+const UINT CONFIG_POLL_INTERVAL_MS = 1000;
+FILETIME configWriteTime = {};
+std::wstring configError;
+
+// Settings as last read from config.ini; the capture worker owns solverConfig itself
+SolverConfig fileSolverConfig;
+
 // Global variables for hotkey customization
 int currentTabHotkey = VK_TAB;
 int currentF4Hotkey = VK_F4;
+int currentConfirmHotkey = VK_F7;    // Pressed at the portal room to log where the stronghold was
 bool waitingForTabHotkey = false;
 bool waitingForF4Hotkey = false;
+bool waitingForConfirmHotkey = false;
+
+// Solve results go to the clipboard, results_log.txt and any listener on the pipe
+const int CLIPBOARD_OPEN_ATTEMPTS = 5;
+const DWORD CLIPBOARD_RETRY_MS = 10;
+const char RESULT_PIPE_NAME[] = "\\\\.\\pipe\\stronghold-results";
+ResultPublisher resultPublisher;
+
+// Every capture, HUD read and solve is kept in session_log.bin across runs
+SessionLogWriter sessionLog;
+
+// Hotkey work runs on the capture worker; it posts this message when a snapshot is ready
+const UINT WM_CAPTURE_SNAPSHOT = WM_APP + 1;
+std::unique_ptr<CaptureWorker> captureWorker;
+std::shared_ptr<const CaptureSnapshot> shownSnapshot = std::make_shared<CaptureSnapshot>();
+
+// Display list currently shown in the main window
+DisplayList mainDisplayList;
+
+// Coalesces overlay and main window updates to the target frame rate
+SteadyRepaintClock repaintClock;
+RepaintScheduler repaintScheduler(repaintClock);
 
 // Configuration file functions
-std::wstring GetConfigFilePath() {
+std::wstring GetAppDataFilePath(const std::wstring& fileName) {
     wchar_t* appDataPath;
     if (SHGetKnownFolderPath(FOLDERID_RoamingAppData, 0, NULL, &appDataPath) == S_OK) {
-        std::wstring configPath = std::wstring(appDataPath) + L"\\MinecraftStrongholdFinder";
+        std::wstring filePath = std::wstring(appDataPath) + L"\\MinecraftStrongholdFinder";
 
         // Create directory if it doesn't exist
-        CreateDirectory(configPath.c_str(), NULL);
+        CreateDirectory(filePath.c_str(), NULL);
 
-        configPath += L"\\config.ini";
+        filePath += L"\\" + fileName;
         CoTaskMemFree(appDataPath);
-        return configPath;
+        return filePath;
     }
 
     // Fallback to current directory if AppData is not available
-    return L"config.ini";
+    return fileName;
+}
+
+std::wstring GetConfigFilePath() {
+    return GetAppDataFilePath(L"config.ini");
+}
+
+// Last write time of config.ini, zero when it does not exist
+FILETIME GetConfigWriteTime() {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(GetConfigFilePath().c_str(), GetFileExInfoStandard, &attributes)) {
+        return FILETIME();
+    }
+    return attributes.ftLastWriteTime;
 }
 
 void SaveHotkeysToFile() {
     std::wstring configPath = GetConfigFilePath();
-    std::wofstream file(configPath);
+    std::vector<ConfigSetting> settings = {
+        { "Hotkeys", "DirectionKey", std::to_string(currentTabHotkey) },
+        { "Hotkeys", "DistanceKey", std::to_string(currentF4Hotkey) },
+        { "Hotkeys", "ConfirmKey", std::to_string(currentConfirmHotkey) },
+    };
+    std::vector<ConfigSetting> solverSettings = solverConfigSettings(fileSolverConfig);
+    settings.insert(settings.end(), solverSettings.begin(), solverSettings.end());
+
+    // Only our keys change; the user's comments and anything we do not know are kept
+    std::ostringstream merged;
+    {
+        std::ifstream existing(configPath);
+        rewriteConfig(existing, merged, settings);
+    }
 
+    std::ofstream file(configPath);
     if (file.is_open()) {
-        file << L"[Hotkeys]\n";
-        file << L"DirectionKey=" << currentTabHotkey << L"\n";
-        file << L"DistanceKey=" << currentF4Hotkey << L"\n";
+        file << merged.str();
         file.close();
     }
+
+    // Our own write is not a change to reload
+    configWriteTime = GetConfigWriteTime();
 }
 
 void LoadHotkeysFromFile() {
@@ -76,6 +155,9 @@ void LoadHotkeysFromFile() {
                     else if (key == L"DistanceKey") {
                         currentF4Hotkey = keyCode;
                     }
+                    else if (key == L"ConfirmKey") {
+                        currentConfirmHotkey = keyCode;
+                    }
                 }
                 catch (const std::exception&) {
                     // Invalid number in config, keep default value
@@ -86,39 +168,206 @@ void LoadHotkeysFromFile() {
     }
 }
 
-void CopyStrongholdResultsToClipboard() {
-    std::wstringstream ss;
-    if (!strongholdCandidates.empty()) {
-        ss << L"Stronghold Locations:\n";
-        int maxForClipboard = std::min(5, (int)strongholdCandidates.size());
-        for (int i = 0; i < maxForClipboard; i++) {
-            const auto& candidate = strongholdCandidates[i];
-            ss << L"#" << (i + 1) << L": Overworld (" << candidate.projectionX
-                << L", " << candidate.projectionZ << L") - Nether ("
-                << candidate.netherX << L", " << candidate.netherZ << L") - "
-                << std::fixed << std::setprecision(1)
-                << (candidate.conditionalProb * 100.0) << L"%\n";
-        }
+// Solver, display and OCR settings; rejected values keep their previous setting.
+// The capture worker picks them up through submitConfig.
+void LoadSolverConfigFromFile() {
+    std::ifstream file(GetConfigFilePath());
+    if (!file.is_open()) return;
+
+    std::vector<std::string> errors;
+    readSolverConfig(file, fileSolverConfig, errors);
+    configError = errors.empty() ? L"" : L"config.ini: " + std::wstring(errors[0].begin(), errors[0].end());
+}
+
+// Apply an edited config.ini without a restart and re-solve the current throw with it
+void ReloadConfigIfChanged(HWND hWnd) {
+    FILETIME writeTime = GetConfigWriteTime();
+    if (CompareFileTime(&writeTime, &configWriteTime) == 0) return;
+    configWriteTime = writeTime;
+
+    int directionKey = currentTabHotkey, distanceKey = currentF4Hotkey, confirmKey = currentConfirmHotkey;
+    LoadHotkeysFromFile();
+    if (currentTabHotkey != directionKey || currentF4Hotkey != distanceKey || currentConfirmHotkey != confirmKey) {
+        RegisterHotkeys(hWnd);
+    }
+    LoadSolverConfigFromFile();
+
+    // The worker re-solves a finished throw and posts a snapshot, which repaints
+    if (captureWorker) {
+        captureWorker->submitConfig(fileSolverConfig);
+    }
+}
+
+// Keep the hotkey session for headless replay (see capture_replay_tool.cpp)
+void SaveCaptureLogToFile() {
+    if (captureStateMachine.eventLog().empty()) return;
+
+    std::ofstream file(GetAppDataFilePath(L"capture_log.txt"));
+    if (file.is_open()) {
+        writeCaptureLog(file, captureStateMachine.eventLog());
+        file.close();
+    }
+}
 
-        // Add warning to clipboard if distance validation failed
-        if (appState.distanceValidationFailed) {
-            ss << L"\nWARNING: Distance mismatch detected!";
+// Dump the recorded trace spans for offline inspection in chrome://tracing
+void SaveTraceToFile() {
+#ifndef DISABLE_TRACE_SPANS
+    std::ofstream file(GetAppDataFilePath(L"trace.json"));
+    if (file.is_open()) {
+        writeChromeTrace(file);
+        file.close();
+    }
+#endif
+}
+
+// Periodic Prometheus-format snapshot of the always-on metrics
+void SaveMetricsToFile() {
+    std::ofstream file(GetAppDataFilePath(L"metrics.prom"));
+    if (file.is_open()) {
+        writePrometheusMetrics(file);
+        file.close();
+    }
+}
+
+// Clipboard is shared with every other process; it is retried briefly when another one holds it
+class ClipboardResultSink : public ResultSink {
+public:
+    const char* name() const override { return "clipboard"; }
+
+    bool publish(const ResultSnapshot& snapshot) override {
+        std::wstring text = formatResultText(snapshot);
+
+        TRACE_SPAN("clipboard");
+        ScopedLatency latency(metrics.clipboardLatency);
+        bool opened = false;
+        for (int attempt = 0; attempt < CLIPBOARD_OPEN_ATTEMPTS && !opened; attempt++) {
+            if (attempt > 0) Sleep(CLIPBOARD_RETRY_MS);
+            opened = OpenClipboard(NULL) != FALSE;
+        }
+        if (!opened) return false;
+
+        EmptyClipboard();
+        bool copied = false;
+        HGLOBAL hGlob = GlobalAlloc(GMEM_MOVEABLE, (text.size() + 1) * sizeof(wchar_t));
+        if (hGlob) {
+            memcpy(GlobalLock(hGlob), text.c_str(), (text.size() + 1) * sizeof(wchar_t));
+            GlobalUnlock(hGlob);
+            copied = SetClipboardData(CF_UNICODETEXT, hGlob) != NULL;
+            if (!copied) GlobalFree(hGlob);
         }
+        CloseClipboard();
+        return copied;
+    }
+};
+
+struct MinecraftHudFrame : HudFrame {
+    std::unique_ptr<Bitmap> bitmap;
+};
+
+// Captures the Minecraft window on the UI thread at the press; the OCR runs on the worker
+class MinecraftFrameSource : public FrameSource {
+public:
+    std::shared_ptr<const HudFrame> grabFrame() override {
+        HWND mcHwnd = FindWindow(NULL, L"Minecraft");
+        if (!mcHwnd) return nullptr;
+        auto frame = std::make_shared<MinecraftHudFrame>();
+        frame->bitmap = BitmapFromHWND(mcHwnd);
+        return frame;
+    }
+
+    bool decodeCoordinates(const HudFrame& frame, Vec3& coords) override {
+        return DecodeShownCoordinates(static_cast<const MinecraftHudFrame&>(frame).bitmap.get(), &coords) != 0;
     }
-    else {
-        ss << L"Angle: " << appState.lastAngle << L"° - No strongholds found";
+};
+
+MinecraftFrameSource minecraftFrames;
+
+void StartResultSinks() {
+    resultPublisher.addSink(std::make_unique<ClipboardResultSink>());
+    resultPublisher.addSink(std::make_unique<FileResultSink>(GetAppDataFilePath(L"results_log.txt")));
+    resultPublisher.addSink(std::make_unique<SocketResultSink>(RESULT_PIPE_NAME));
+}
+
+void StartCaptureWorker(HWND hWnd) {
+    bool logging = sessionLog.open(GetAppDataFilePath(L"session_log.bin"));
+    captureWorker = std::make_unique<CaptureWorker>(captureStateMachine, minecraftFrames,
+        [hWnd] { PostMessage(hWnd, WM_CAPTURE_SNAPSHOT, 0, 0); }, &resultPublisher, logging ? &sessionLog : nullptr);
+}
+
+void SubmitCaptureJob(CaptureEventType type) {
+    if (captureWorker) {
+        captureWorker->submit(type, captureClockMs());
     }
-    std::wstring text = ss.str();
-
-    OpenClipboard(NULL);
-    EmptyClipboard();
-    HGLOBAL hGlob = GlobalAlloc(GMEM_MOVEABLE, (text.size() + 1) * sizeof(wchar_t));
-    if (hGlob) {
-        memcpy(GlobalLock(hGlob), text.c_str(), (text.size() + 1) * sizeof(wchar_t));
-        GlobalUnlock(hGlob);
-        SetClipboardData(CF_UNICODETEXT, hGlob);
+}
+
+// Show the newest snapshot; snapshots the UI did not get to are skipped, their actions kept
+void TakeCaptureSnapshot(HWND hWnd) {
+    unsigned int actions = CAPTURE_ACTION_NONE;
+    std::shared_ptr<const CaptureSnapshot> snapshot = captureWorker->takeSnapshot(actions);
+    if (!snapshot) return;
+    shownSnapshot = snapshot;
+    applyCaptureActions(hWnd, actions);
+}
+
+void applyCaptureActions(HWND hWnd, unsigned int actions) {
+    if (actions & CAPTURE_ACTION_SHOW_OVERLAY) {
+        ShowOverlay();
+    }
+    if (actions & CAPTURE_ACTION_HIDE_OVERLAY) {
+        HideOverlay();
+    }
+
+    unsigned int views = 0;
+    if (actions & CAPTURE_ACTION_UPDATE_OVERLAY) {
+        views |= REPAINT_VIEW_OVERLAY;
+    }
+    if ((actions & CAPTURE_ACTION_REPAINT) && hWnd) {
+        views |= REPAINT_VIEW_MAIN_WINDOW;
     }
-    CloseClipboard();
+    RequestRepaint(hWnd, views);
+}
+
+class WindowRepaintTimer : public RepaintTimer {
+public:
+    explicit WindowRepaintTimer(HWND hWnd) : hWnd(hWnd) {}
+    void arm(unsigned int delayMs) override { SetTimer(hWnd, REPAINT_TIMER_ID, delayMs, NULL); }
+
+private:
+    HWND hWnd;
+};
+
+void ApplyRepaints(HWND hWnd, unsigned int views) {
+    if (views & REPAINT_VIEW_OVERLAY) {
+        UpdateOverlay();
+    }
+    if (views & REPAINT_VIEW_MAIN_WINDOW) {
+        UpdateMainWindow(hWnd);
+    }
+}
+
+void RequestRepaint(HWND hWnd, unsigned int views) {
+    WindowRepaintTimer timer(hWnd);
+    ApplyRepaints(hWnd, repaintScheduler.request(views, timer));
+}
+
+DisplayList BuildMainWindowDisplayList(HWND hWnd) {
+    MainWindowLabels labels;
+    labels.directionKeyName = GetKeyName(currentTabHotkey);
+    labels.distanceKeyName = GetKeyName(currentF4Hotkey);
+    labels.waitingForDirectionKey = waitingForTabHotkey;
+    labels.waitingForDistanceKey = waitingForF4Hotkey;
+    labels.confirmKeyName = GetKeyName(currentConfirmHotkey);
+    labels.waitingForConfirmKey = waitingForConfirmHotkey;
+    labels.configError = configError;
+
+    RECT rect;
+    GetClientRect(hWnd, &rect);
+    return buildMainDisplayList(shownSnapshot->state, shownSnapshot->candidates, shownSnapshot->route,
+        shownSnapshot->nextThrows, shownSnapshot->config, labels, rect.right, rect.bottom);
+}
+
+void UpdateMainWindow(HWND hWnd) {
+    InvalidateDisplayListChanges(hWnd, mainDisplayList, BuildMainWindowDisplayList(hWnd));
 }
 
 std::wstring GetKeyName(int vkCode) {
@@ -165,10 +414,12 @@ void RegisterHotkeys(HWND hWnd) {
     // Unregister existing hotkeys first
     UnregisterHotKey(hWnd, 1);
     UnregisterHotKey(hWnd, 2);
+    UnregisterHotKey(hWnd, 3);
 
     // Register new hotkeys
     RegisterHotKey(hWnd, 1, 0, currentTabHotkey);
     RegisterHotKey(hWnd, 2, 0, currentF4Hotkey);
+    RegisterHotKey(hWnd, 3, 0, currentConfirmHotkey);
 }
 
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
@@ -176,26 +427,38 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     case WM_KEYDOWN:
         if (waitingForTabHotkey) {
             int newKey = (int)wParam;
-            if (newKey != VK_ESCAPE && newKey != currentF4Hotkey) {
+            if (newKey != VK_ESCAPE && newKey != currentF4Hotkey && newKey != currentConfirmHotkey) {
                 currentTabHotkey = newKey;
                 RegisterHotkeys(hWnd);
                 SaveHotkeysToFile(); // Save to file when changed
             }
             waitingForTabHotkey = false;
             SetFocus(hWnd); // Remove focus from any button
-            InvalidateRect(hWnd, NULL, TRUE);
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
             return 0;
         }
         else if (waitingForF4Hotkey) {
             int newKey = (int)wParam;
-            if (newKey != VK_ESCAPE && newKey != currentTabHotkey) {
+            if (newKey != VK_ESCAPE && newKey != currentTabHotkey && newKey != currentConfirmHotkey) {
                 currentF4Hotkey = newKey;
                 RegisterHotkeys(hWnd);
                 SaveHotkeysToFile(); // Save to file when changed
             }
             waitingForF4Hotkey = false;
             SetFocus(hWnd); // Remove focus from any button
-            InvalidateRect(hWnd, NULL, TRUE);
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
+            return 0;
+        }
+        else if (waitingForConfirmHotkey) {
+            int newKey = (int)wParam;
+            if (newKey != VK_ESCAPE && newKey != currentTabHotkey && newKey != currentF4Hotkey) {
+                currentConfirmHotkey = newKey;
+                RegisterHotkeys(hWnd);
+                SaveHotkeysToFile(); // Save to file when changed
+            }
+            waitingForConfirmHotkey = false;
+            SetFocus(hWnd); // Remove focus from any button
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
             return 0;
         }
         break;
@@ -204,260 +467,58 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         if (LOWORD(wParam) == 1001) { // Change Tab hotkey button
             waitingForTabHotkey = true;
             waitingForF4Hotkey = false;
+            waitingForConfirmHotkey = false;
             SetFocus(hWnd); // Set focus to main window to capture keys
-            InvalidateRect(hWnd, NULL, TRUE);
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
         }
         else if (LOWORD(wParam) == 1002) { // Change F4 hotkey button
             waitingForF4Hotkey = true;
             waitingForTabHotkey = false;
+            waitingForConfirmHotkey = false;
             SetFocus(hWnd); // Set focus to main window to capture keys
-            InvalidateRect(hWnd, NULL, TRUE);
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
+        }
+        else if (LOWORD(wParam) == 1003) { // Change confirm hotkey button
+            waitingForConfirmHotkey = true;
+            waitingForTabHotkey = false;
+            waitingForF4Hotkey = false;
+            SetFocus(hWnd); // Set focus to main window to capture keys
+            RequestRepaint(hWnd, REPAINT_VIEW_MAIN_WINDOW);
         }
         break;
 
     case WM_HOTKEY:
     {
         if (wParam == 1) { // Direction hotkey (formerly Tab)
-            HWND mcHwnd = FindWindow(NULL, L"Minecraft");
-            if (mcHwnd && GetShownCoordinates(mcHwnd, &appState.latestCoords)) {
-                if (appState.capturePhase == 0) {
-                    // First press - only mark as direction first if distance wasn't pressed yet
-                    if (appState.distanceKeyPresses == 0) {
-                        appState.tabPressedFirst = true;
-                        ShowOverlay(); // Show overlay when direction key is first pressed
-                    }
-                    appState.coord1 = appState.latestCoords;
-                    appState.capturePhase = 1;
-                }
-                else if (appState.capturePhase == 1) {
-                    appState.coord2 = appState.latestCoords;
-                    appState.lastAngle = angleBetween(appState.coord1.x, appState.coord1.z,
-                        appState.coord2.x, appState.coord2.z);
-                    appState.capturePhase = 2;
-
-                    // Always use distance when distance key was pressed first
-                    double targetDistance = -1;
-                    if (appState.f4PressedFirst && appState.calculatedDistance > 0) {
-                        targetDistance = appState.calculatedDistance;
-                    }
-                    calculateStrongholdLocationWithDistance(appState.coord1.x, appState.coord1.z,
-                        appState.lastAngle, targetDistance);
-
-                    // Copy results to clipboard
-                    CopyStrongholdResultsToClipboard();
-                }
-                else {
-                    // Third press resets everything
-                    appState.capturePhase = 0;
-                    appState.coord1 = { 0, 0, 0 };
-                    appState.coord2 = { 0, 0, 0 };
-                    appState.lastAngle = 0.0;
-                    appState.distanceKeyPresses = 0;
-                    appState.calculatedDistance = 0.0;
-                    strongholdCandidates.clear();
-                    appState.tabPressedFirst = false;
-                    appState.f4PressedFirst = false;
-                    appState.distanceValidationFailed = false;
-                    appState.validationErrorMessage = L"";
-                    HideOverlay(); // Hide overlay when resetting
-                }
-
-                UpdateOverlay();
-                InvalidateRect(hWnd, NULL, TRUE);
-            }
+            SubmitCaptureJob(CAPTURE_EVENT_DIRECTION_KEY);
         }
         else if (wParam == 2) { // Distance hotkey (formerly F4)
-            handleDistanceKey();
+            handleDistanceKey(hWnd);
+        }
+        else if (wParam == 3 && captureWorker) { // Confirm hotkey, at the stronghold
+            captureWorker->submitOutcome(captureClockMs());
         }
     }
     break;
 
+    case WM_CAPTURE_SNAPSHOT:
+        TakeCaptureSnapshot(hWnd);
+        break;
+
     case WM_PAINT:
     {
+        TRACE_SPAN("paint main");
+        ScopedLatency latency(metrics.paintMainLatency);
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hWnd, &ps);
 
-        Graphics graphics(hdc);
-        graphics.SetSmoothingMode(SmoothingModeAntiAlias);
-        graphics.Clear(Color(30, 30, 30));
-
-        FontFamily fontFamily(L"Segoe UI");
-        Font font(&fontFamily, 12, FontStyleRegular, UnitPixel);
-        Font smallFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-        Font tableFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-        Font buttonFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-        SolidBrush whiteBrush(Color(240, 240, 240));
-        SolidBrush grayBrush(Color(180, 180, 180));
-        SolidBrush greenBrush(Color(100, 200, 100));
-        SolidBrush yellowBrush(Color(255, 220, 100));
-        SolidBrush redBrush(Color(255, 100, 100));
-        SolidBrush cyanBrush(Color(100, 200, 255));
-
-        int marginX = 15;
-        int y = 15;
-
-        Font headerFont(&fontFamily, 14, FontStyleBold, UnitPixel);
-        graphics.DrawString(L"Minecraft Stronghold Finder", -1, &headerFont,
-            PointF((REAL)marginX, (REAL)y), &whiteBrush);
-        y += 35;
-
-        // Hotkey configuration section
-        graphics.DrawString(L"Hotkey Settings:", -1, &font,
-            PointF((REAL)marginX, (REAL)y), &whiteBrush);
-        y += 20;
-
-        // Direction hotkey
-        std::wstringstream dirSS;
-        dirSS << L"Direction Key: " << GetKeyName(currentTabHotkey);
-        if (waitingForTabHotkey) {
-            dirSS << L" (Press new key...)";
-        }
-        SolidBrush* dirBrush = waitingForTabHotkey ? &yellowBrush : &grayBrush;
-        graphics.DrawString(dirSS.str().c_str(), -1, &font,
-            PointF((REAL)marginX, (REAL)y), dirBrush);
-        y += 20;
-
-        // Distance hotkey
-        std::wstringstream distSS;
-        distSS << L"Distance Key: " << GetKeyName(currentF4Hotkey);
-        if (waitingForF4Hotkey) {
-            distSS << L" (Press new key...)";
-        }
-        SolidBrush* distKeyBrush = waitingForF4Hotkey ? &yellowBrush : &grayBrush;
-        graphics.DrawString(distSS.str().c_str(), -1, &font,
-            PointF((REAL)marginX, (REAL)y), distKeyBrush);
-        y += 30;
-
-        std::wstringstream ss;
-        ss << L"Current Position:\n"
-            << L"X: " << appState.latestCoords.x << L"\n"
-            << L"Y: " << appState.latestCoords.y << L"\n"
-            << L"Z: " << appState.latestCoords.z << L"\n";
-
-        graphics.DrawString(ss.str().c_str(), -1, &font,
-            PointF((REAL)marginX, (REAL)y), &grayBrush);
-        y += 85;
-
-        // Distance info
-        if (appState.f4PressedFirst && appState.distanceKeyPresses > 0) {
-            std::wstringstream distInfoSS;
-            distInfoSS << GetKeyName(currentF4Hotkey) << L" Distance Calculation:\n"
-                << L"Key presses: " << appState.distanceKeyPresses << L"\n"
-                << L"Calculated distance: " << std::fixed << std::setprecision(0)
-                << appState.calculatedDistance << L" blocks\n";
-            graphics.DrawString(distInfoSS.str().c_str(), -1, &font,
-                PointF((REAL)marginX, (REAL)y), &yellowBrush);
-            y += 55;
-        }
-        else if (appState.tabPressedFirst) {
-            std::wstringstream skipSS;
-            skipSS << GetKeyName(currentF4Hotkey) << L" key disabled (" << GetKeyName(currentTabHotkey) << L" was pressed first)\n";
-            graphics.DrawString(skipSS.str().c_str(), -1, &font,
-                PointF((REAL)marginX, (REAL)y), &grayBrush);
-            y += 20;
-        }
-
-        // Show validation error in main window
-        if (appState.distanceValidationFailed && !appState.validationErrorMessage.empty()) {
-            Font errorFont(&fontFamily, 10, FontStyleBold, UnitPixel);
-            // Word wrap the error message
-            RectF layoutRect((REAL)marginX, (REAL)y, 450.0f, 60.0f);
-            graphics.DrawString(appState.validationErrorMessage.c_str(), -1, &errorFont,
-                layoutRect, nullptr, &redBrush);
-            y += 65;
+        // Paint the retained display list; UpdateMainWindow only invalidates what changed
+        if (mainDisplayList.empty()) {
+            mainDisplayList = BuildMainWindowDisplayList(hWnd);
         }
 
-        if (appState.capturePhase == 0) {
-            if (!appState.f4PressedFirst && !appState.tabPressedFirst) {
-                std::wstringstream instrSS;
-                instrSS << L"Instructions:\n"
-                    << L"1. Press " << GetKeyName(currentF4Hotkey) << L" multiple times for distance calculation\n"
-                    << L"2. Press " << GetKeyName(currentTabHotkey) << L" twice for direction calculation\n"
-                    << L"   (or press " << GetKeyName(currentTabHotkey) << L" first to skip distance)";
-                graphics.DrawString(instrSS.str().c_str(), -1, &font,
-                    PointF((REAL)marginX, (REAL)y), &whiteBrush);
-            }
-            else if (appState.tabPressedFirst) {
-                std::wstringstream skipInstrSS;
-                skipInstrSS << GetKeyName(currentTabHotkey) << L" pressed first - distance calculation skipped.\n"
-                    << L"Press " << GetKeyName(currentTabHotkey) << L" again for direction calculation.";
-                graphics.DrawString(skipInstrSS.str().c_str(), -1, &font,
-                    PointF((REAL)marginX, (REAL)y), &whiteBrush);
-            }
-            else if (appState.f4PressedFirst) {
-                std::wstringstream distInstrSS;
-                distInstrSS << L"Distance calculated! Now press " << GetKeyName(currentTabHotkey) << L" twice for direction.";
-                graphics.DrawString(distInstrSS.str().c_str(), -1, &font,
-                    PointF((REAL)marginX, (REAL)y), &greenBrush);
-            }
-        }
-        else if (appState.capturePhase == 1) {
-            std::wstringstream firstSS;
-            firstSS << L"First point captured: (" << appState.coord1.x << L", " << appState.coord1.z << L")\n"
-                << L"Press " << GetKeyName(currentTabHotkey) << L" at second point to calculate direction.";
-            graphics.DrawString(firstSS.str().c_str(), -1, &font,
-                PointF((REAL)marginX, (REAL)y), &yellowBrush);
-        }
-        else if (appState.capturePhase == 2) {
-            std::wstringstream angleSS;
-            angleSS << L"Eye Direction: " << std::fixed << std::setprecision(1)
-                << appState.lastAngle << L"°\n";
-
-            if (!strongholdCandidates.empty()) {
-                angleSS << L"\nStronghold Locations (Overworld / Nether):";
-            }
-            else {
-                angleSS << L"\nNo strongholds found in this direction.";
-            }
-
-            SolidBrush* angleBrush = appState.distanceValidationFailed ? &redBrush : &greenBrush;
-            graphics.DrawString(angleSS.str().c_str(), -1, &font,
-                PointF((REAL)marginX, (REAL)y), angleBrush);
-
-            if (!strongholdCandidates.empty()) {
-                y += 55;
-
-                // Table header
-                graphics.DrawString(L"Rank  Overworld Coords    Nether Coords      Probability  Distance", -1, &smallFont,
-                    PointF((REAL)marginX, (REAL)y), &grayBrush);
-                y += 20;
-
-                // Show detailed candidate list
-                int maxCandidates = std::min(10, (int)strongholdCandidates.size());
-                for (int i = 0; i < maxCandidates; i++) {
-                    const auto& candidate = strongholdCandidates[i];
-
-                    std::wstringstream candidateSS;
-                    candidateSS << L"#" << (i + 1) << L"   ("
-                        << std::setw(5) << candidate.projectionX << L"," << std::setw(5) << candidate.projectionZ << L")   ("
-                        << std::setw(4) << candidate.netherX << L"," << std::setw(4) << candidate.netherZ << L")      "
-                        << std::fixed << std::setprecision(1) << std::setw(5)
-                        << (candidate.conditionalProb * 100.0) << L"%     "
-                        << candidate.distance << L"m";
-
-                    SolidBrush* brush;
-                    if (i == 0) {
-                        brush = appState.distanceValidationFailed ? &redBrush : &greenBrush;
-                    }
-                    else if (candidate.conditionalProb > 0.1) {
-                        brush = &yellowBrush;
-                    }
-                    else {
-                        brush = &grayBrush;
-                    }
-
-                    graphics.DrawString(candidateSS.str().c_str(), -1, &tableFont,
-                        PointF((REAL)marginX, (REAL)y), brush);
-                    y += 18;
-                }
-
-                y += 10;
-                std::wstringstream resetSS;
-                resetSS << L"Top locations copied to clipboard. Press " << GetKeyName(currentTabHotkey) << L" to reset.";
-                graphics.DrawString(resetSS.str().c_str(), -1, &font,
-                    PointF((REAL)marginX, (REAL)y), &whiteBrush);
-            }
-        }
+        Graphics graphics(hdc);
+        PaintDisplayList(graphics, mainDisplayList, ps.rcPaint);
 
         EndPaint(hWnd, &ps);
     }
@@ -465,8 +526,21 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
     case WM_CREATE:
     {
-        // Load hotkeys from file at startup
+        // Load hotkeys and solver settings from file at startup; a missing file gets the defaults
+        configWriteTime = GetConfigWriteTime();
         LoadHotkeysFromFile();
+        LoadSolverConfigFromFile();
+        if (configWriteTime.dwLowDateTime == 0 && configWriteTime.dwHighDateTime == 0) {
+            SaveHotkeysToFile();
+        }
+        StartResultSinks();
+
+        // Precomputed first throws, if a table was built (first_throw_table_tool)
+        firstThrowTable.open(GetAppDataFilePath(L"first_throw_table.bin"));
+
+        // Solver globals belong to the worker from here on
+        StartCaptureWorker(hWnd);
+        captureWorker->submitConfig(fileSolverConfig);
 
         // Create hotkey change buttons - positioned after hotkey text
         CreateWindow(L"BUTTON", L"Change Direction Key", WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON,
@@ -475,14 +549,44 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         CreateWindow(L"BUTTON", L"Change Distance Key", WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON,
             300, 75, 140, 25, hWnd, (HMENU)1002, GetModuleHandle(NULL), NULL);
 
+        CreateWindow(L"BUTTON", L"Change Confirm Key", WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON,
+            300, 95, 140, 25, hWnd, (HMENU)1003, GetModuleHandle(NULL), NULL);
+
         // Register hotkeys (now using loaded values)
         RegisterHotkeys(hWnd);
+
+        SetTimer(hWnd, METRICS_TIMER_ID, METRICS_EXPORT_INTERVAL_MS, NULL);
+        SetTimer(hWnd, CONFIG_TIMER_ID, CONFIG_POLL_INTERVAL_MS, NULL);
     }
     break;
 
+    case WM_TIMER:
+        if (wParam == METRICS_TIMER_ID) {
+            SaveMetricsToFile();
+        }
+        else if (wParam == CONFIG_TIMER_ID) {
+            ReloadConfigIfChanged(hWnd);
+        }
+        else if (wParam == REPAINT_TIMER_ID) {
+            KillTimer(hWnd, REPAINT_TIMER_ID);
+            WindowRepaintTimer timer(hWnd);
+            ApplyRepaints(hWnd, repaintScheduler.timerFired(timer));
+        }
+        break;
+
     case WM_DESTROY:
+        KillTimer(hWnd, METRICS_TIMER_ID);
+        KillTimer(hWnd, REPAINT_TIMER_ID);
+        KillTimer(hWnd, CONFIG_TIMER_ID);
+        captureWorker->stop();
+        sessionLog.stop();
+        resultPublisher.stop();
+        SaveCaptureLogToFile();
+        SaveTraceToFile();
+        SaveMetricsToFile();
         UnregisterHotKey(hWnd, 1);
         UnregisterHotKey(hWnd, 2);
+        UnregisterHotKey(hWnd, 3);
         if (hOverlayWnd) {
             DestroyWindow(hOverlayWnd);
         }
@@ -1,6 +1,8 @@
 #pragma once
 #define NOMINMAX
 #include "common.h"
+#include "capture_state_machine.h"
+#include "capture_worker.h"
 
 
 // Hotkey customization variables
@@ -16,5 +18,23 @@ void RegisterHotkeys(HWND hWnd);
 // Main window procedure
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 
-// Clipboard utility function
-void CopyStrongholdResultsToClipboard();
\ No newline at end of file
+// Clipboard and the other sinks for the results the capture worker copies
+void StartResultSinks();
+
+// Capture state machine driven by the hotkeys, run by the capture worker
+extern CaptureStateMachine captureStateMachine;
+
+// Queue a key press for the capture worker, timed now
+void SubmitCaptureJob(CaptureEventType type);
+
+// Results on screen, the newest snapshot posted by the capture worker
+extern std::shared_ptr<const CaptureSnapshot> shownSnapshot;
+
+// Execute the overlay and repaint CaptureAction flags of a snapshot
+void applyCaptureActions(HWND hWnd, unsigned int actions);
+
+// Rebuild the main window display list and invalidate only what changed
+void UpdateMainWindow(HWND hWnd);
+
+// Queue RepaintView updates; they are flushed at most once per frame interval
+void RequestRepaint(HWND hWnd, unsigned int views);
\ No newline at end of file
@@ -0,0 +1,109 @@
+#define NOMINMAX
+#include "metrics.h"
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+Metrics metrics;
+
+static std::atomic<uint64_t> allocations{ 0 };
+
+void LogHistogram::record(double value) {
+    int index = 0;
+    if (value > baseValue) {
+        index = (int)std::ceil(std::log2(value / baseValue));
+        if (index > HISTOGRAM_BUCKETS) index = HISTOGRAM_BUCKETS;
+    }
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    if (value > 0) {
+        sumMicro.fetch_add((uint64_t)std::llround(value * 1e6), std::memory_order_relaxed);
+    }
+}
+
+double LogHistogram::bucketBound(int index) const {
+    return std::ldexp(baseValue, index);
+}
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+static void writeCounter(std::ostream& out, const char* name, const char* help, uint64_t value) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " counter\n";
+    out << name << " " << value << "\n";
+}
+
+static void writeHistogram(std::ostream& out, const char* name, const char* help, const LogHistogram& histogram) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " histogram\n";
+
+    // Prometheus buckets are cumulative
+    uint64_t cumulative = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        cumulative += histogram.bucketCount(i);
+        out << name << "_bucket{le=\"" << histogram.bucketBound(i) << "\"} " << cumulative << "\n";
+    }
+    cumulative += histogram.bucketCount(HISTOGRAM_BUCKETS);
+    out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+    out << name << "_sum " << histogram.sum() << "\n";
+    out << name << "_count " << histogram.count() << "\n";
+}
+
+void writePrometheusMetrics(std::ostream& out) {
+    writeCounter(out, "stronghold_ocr_success_total", "HUD coordinate reads that decoded", metrics.ocrSuccess.get());
+    writeCounter(out, "stronghold_ocr_failure_total", "HUD coordinate reads that found no text", metrics.ocrFailure.get());
+    writeCounter(out, "stronghold_distance_validation_failures_total", "Solves flagged with a distance mismatch",
+        metrics.distanceValidationFailures.get());
+    writeCounter(out, "stronghold_solves_total", "Stronghold solves run", metrics.solves.get());
+    writeCounter(out, "stronghold_first_throw_table_hits_total", "Throws answered from the first-throw table",
+        metrics.firstThrowTableHits.get());
+    writeCounter(out, "stronghold_result_sink_failures_total", "Results a sink could not deliver",
+        metrics.resultSinkFailures.get());
+    writeCounter(out, "stronghold_result_sink_drops_total", "Results dropped from a full sink queue",
+        metrics.resultSinkDrops.get());
+    writeCounter(out, "stronghold_superseded_solves_total", "Solves skipped because a newer press reset the throw",
+        metrics.supersededSolves.get());
+    writeCounter(out, "stronghold_session_records_dropped_total", "Session log records dropped from a full writer queue",
+        metrics.sessionRecordsDropped.get());
+    writeCounter(out, "stronghold_allocations_total", "Heap allocations since startup", allocationCount());
+
+    writeHistogram(out, "stronghold_capture_seconds", "Window capture latency", metrics.captureLatency);
+    writeHistogram(out, "stronghold_decode_seconds", "HUD decode latency", metrics.decodeLatency);
+    writeHistogram(out, "stronghold_solve_seconds", "Solver latency", metrics.solveLatency);
+    writeHistogram(out, "stronghold_clipboard_seconds", "Clipboard write latency", metrics.clipboardLatency);
+    writeHistogram(out, "stronghold_paint_main_seconds", "Main window WM_PAINT latency", metrics.paintMainLatency);
+    writeHistogram(out, "stronghold_paint_overlay_seconds", "Overlay WM_PAINT latency", metrics.paintOverlayLatency);
+    writeHistogram(out, "stronghold_solve_candidates", "Candidates produced per solve", metrics.solveCandidates);
+}
+
+#ifndef DISABLE_ALLOCATION_METRICS
+// Counting replacements for the global allocation functions
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (void* memory = std::malloc(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
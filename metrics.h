@@ -0,0 +1,88 @@
+#pragma once
+#define NOMINMAX
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Always-on aggregate metrics. Everything is fixed-size and updated with relaxed
+// atomics, so recording is safe from any thread and never allocates.
+// Define DISABLE_ALLOCATION_METRICS to leave the global operator new untouched.
+
+const int HISTOGRAM_BUCKETS = 24; // Power-of-two buckets above the base value
+
+class MetricCounter {
+public:
+    void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{ 0 };
+};
+
+// Histogram with bucket upper bounds base, 2*base, 4*base, ... plus an overflow bucket
+class LogHistogram {
+public:
+    explicit LogHistogram(double baseValue) : baseValue(baseValue) {}
+
+    void record(double value);
+
+    double bucketBound(int index) const;
+    uint64_t bucketCount(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    double sum() const { return (double)sumMicro.load(std::memory_order_relaxed) / 1e6; }
+
+private:
+    double baseValue;
+    std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS + 1] = {};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sumMicro{ 0 }; // Sum in millionths to stay integral
+};
+
+struct Metrics {
+    MetricCounter ocrSuccess;
+    MetricCounter ocrFailure;
+    MetricCounter distanceValidationFailures;
+    MetricCounter solves;
+    MetricCounter firstThrowTableHits;
+    MetricCounter resultSinkFailures;
+    MetricCounter resultSinkDrops;
+    MetricCounter supersededSolves;
+    MetricCounter sessionRecordsDropped;
+
+    // Per-phase latency in seconds, 1 microsecond resolution at the bottom
+    LogHistogram captureLatency{ 1e-6 };
+    LogHistogram decodeLatency{ 1e-6 };
+    LogHistogram solveLatency{ 1e-6 };
+    LogHistogram clipboardLatency{ 1e-6 };
+    LogHistogram paintMainLatency{ 1e-6 };
+    LogHistogram paintOverlayLatency{ 1e-6 };
+
+    // Number of candidates produced by each solve
+    LogHistogram solveCandidates{ 1.0 };
+};
+
+extern Metrics metrics;
+
+// Heap allocations made by the process since startup
+uint64_t allocationCount();
+
+// Write all metrics in Prometheus text exposition format
+void writePrometheusMetrics(std::ostream& out);
+
+// Records the lifetime of the enclosing scope into a latency histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LogHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        histogram.record(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LogHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,47 @@
+#define NOMINMAX
+#include "mouse_angle.h"
+#include <cmath>
+
+double mouseAngleStdDev(double turnedDegrees, double unitsPerDegree, double eyeAngleStdDev) {
+    // Calibration error scales the whole turn
+    double scaleError = MOUSE_CALIBRATION_ERROR_DEGREES / MOUSE_CALIBRATION_TURN_DEGREES * std::fabs(turnedDegrees);
+
+    // Whole mouse counts, uniformly rounded
+    double countError = unitsPerDegree > 0 ? 1.0 / (unitsPerDegree * std::sqrt(12.0)) : 0.0;
+
+    return std::sqrt(eyeAngleStdDev * eyeAngleStdDev + scaleError * scaleError
+        + MOUSE_HEADING_ERROR_DEGREES * MOUSE_HEADING_ERROR_DEGREES + countError * countError);
+}
+
+double normalizeAngleDegrees(double angle) {
+    angle = std::fmod(angle, 360.0);
+    if (angle < 0) angle += 360.0;
+    return angle;
+}
+
+void MouseDeltaRing::push(int32_t delta) {
+    size_t write = head.load(std::memory_order_relaxed);
+    if (write - tail.load(std::memory_order_acquire) >= MOUSE_DELTA_RING_SIZE) {
+        heldBack.fetch_add(delta, std::memory_order_relaxed);
+        return;
+    }
+    entries[write & (MOUSE_DELTA_RING_SIZE - 1)] = delta;
+    head.store(write + 1, std::memory_order_release);
+}
+
+int64_t MouseDeltaRing::drain(size_t& count) {
+    size_t read = tail.load(std::memory_order_relaxed);
+    size_t end = head.load(std::memory_order_acquire);
+    int64_t total = 0;
+    for (size_t i = read; i != end; i++) {
+        total += entries[i & (MOUSE_DELTA_RING_SIZE - 1)];
+    }
+    tail.store(end, std::memory_order_release);
+    count = end - read;
+    return total + heldBack.exchange(0, std::memory_order_relaxed);
+}
+
+void MouseDeltaRing::discard() {
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    heldBack.exchange(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#define NOMINMAX
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Uncertainty of a facing angle measured by integrating raw mouse movement
+// (NewCalc.cpp). The angle is the counted movement divided by a sensitivity that
+// was calibrated from a turn the player judged to be 90 degrees, so its error grows
+// with the size of the turn on top of the usual eye-reading error.
+
+const double MOUSE_CALIBRATION_TURN_DEGREES = 90.0;
+const double MOUSE_CALIBRATION_ERROR_DEGREES = 2.0; // Typical miss when judging the calibration turn
+const double MOUSE_HEADING_ERROR_DEGREES = 0.5;     // Lining the crosshair up at the start and end of a turn
+
+// Standard deviation in degrees of a tracked turn of turnedDegrees, measured with
+// unitsPerDegree mouse counts per degree, for an eye read to eyeAngleStdDev degrees
+double mouseAngleStdDev(double turnedDegrees, double unitsPerDegree, double eyeAngleStdDev);
+
+// Facing angle in [0, 360)
+double normalizeAngleDegrees(double angle);
+
+// Raw mouse deltas are read on an input thread and summed on the UI thread. The ring
+// is preallocated, so a high-rate mouse costs no allocations and no locks.
+const size_t MOUSE_DELTA_RING_SIZE = 4096; // Power of two; half a second at 8 kHz between drains
+
+class MouseDeltaRing {
+public:
+    // Producer thread only. Deltas that find the ring full are held back in a running
+    // total that the next drain takes, so the total is never off.
+    void push(int32_t delta);
+
+    // Consumer thread only. Sum of the deltas pushed since the last drain or discard;
+    // count receives the number of ring entries read.
+    int64_t drain(size_t& count);
+
+    // Consumer thread only. Drop everything pushed so far, held-back deltas included,
+    // so a turn that starts now does not count movement from before it.
+    void discard();
+
+private:
+    alignas(64) std::atomic<size_t> head{ 0 };  // Next entry to write, advanced by the producer
+    alignas(64) std::atomic<size_t> tail{ 0 };  // Next entry to read, advanced by the consumer
+    alignas(64) std::atomic<int64_t> heldBack{ 0 }; // Added to by the producer, taken by the consumer
+    int64_t entries[MOUSE_DELTA_RING_SIZE];
+};
+
+// Exact mouse counts over one tracked turn; converted to degrees only when read
+class MouseTurnAccumulator {
+public:
+    void start() { counts = 0; tracking = true; }
+    int64_t stop() { tracking = false; return counts; }
+    void add(int64_t delta) { if (tracking) counts += delta; }
+
+    bool isTracking() const { return tracking; }
+    int64_t turnCounts() const { return counts; }
+    double turnDegrees(double unitsPerDegree) const { return unitsPerDegree > 0 ? counts / unitsPerDegree : 0.0; }
+
+private:
+    int64_t counts = 0;
+    bool tracking = false;
+};
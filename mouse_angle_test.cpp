@@ -0,0 +1,152 @@
+// Drives MouseDeltaRing and MouseTurnAccumulator the way NewCalc.cpp's MouseAngleTracker
+// does (a drain on every timer tick, discard when a turn starts) and checks that a
+// tracked turn counts exactly its own movement, however much the mouse moved before.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread mouse_angle_test.cpp mouse_angle.cpp -o mouse_angle_test
+#define NOMINMAX
+#include "mouse_angle.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+// MouseAngleTracker without the raw input thread
+class SimulatedTracker {
+public:
+    void tick() {
+        size_t count;
+        turn.add(ring.drain(count));
+    }
+    void startTracking() {
+        ring.discard();
+        turn.start();
+    }
+    int64_t stopTracking() {
+        tick();
+        return turn.stop();
+    }
+
+    MouseDeltaRing ring;
+    MouseTurnAccumulator turn;
+};
+
+// A 900-count turn as 90 packets of 10
+static void pushTurn(MouseDeltaRing& ring) {
+    for (int i = 0; i < 90; i++) {
+        ring.push(10);
+    }
+}
+
+// Far more idle movement than the ring holds, with no tick to drain it, then a turn
+static void checkIdleOverflowThenTrack() {
+    static SimulatedTracker tracker;
+    for (int i = 0; i < 100000; i++) {
+        tracker.ring.push(i % 3 == 0 ? -2 : 3);
+    }
+    tracker.startTracking();
+    pushTurn(tracker.ring);
+    check(tracker.stopTracking() == 900, "turn after an overflowing idle period counts only the turn");
+
+    // The next turn starts clean too
+    tracker.startTracking();
+    pushTurn(tracker.ring);
+    check(tracker.stopTracking() == 900, "second turn counts only its own movement");
+}
+
+// Idle movement drained by the timer while nothing is tracked is ignored
+static void checkIdleTicksThenTrack() {
+    static SimulatedTracker tracker;
+    for (int tick = 0; tick < 100; tick++) {
+        for (int i = 0; i < 500; i++) {
+            tracker.ring.push(7);
+        }
+        tracker.tick();
+    }
+    check(tracker.turn.turnCounts() == 0, "idle ticks count nothing");
+    tracker.startTracking();
+    pushTurn(tracker.ring);
+    tracker.tick();
+    check(tracker.turn.turnCounts() == 900, "live readout shows the turn");
+    check(tracker.stopTracking() == 900, "turn after idle ticks counts only the turn");
+}
+
+// A turn that overflows the ring is still exact when it stops, without a later push
+static void checkOverflowingTurn() {
+    static SimulatedTracker tracker;
+    tracker.startTracking();
+    int64_t pushed = 0;
+    for (int i = 0; i < 3 * (int)MOUSE_DELTA_RING_SIZE; i++) {
+        int32_t delta = i % 5 - 1;
+        tracker.ring.push(delta);
+        pushed += delta;
+    }
+    check(tracker.stopTracking() == pushed, "overflowing turn is exact at stop");
+}
+
+// Movement on another thread while the timer drains it is counted exactly once. The
+// producer pauses while a turn starts and stops, so every delta is clearly inside or
+// outside the turn.
+enum ProducerCommand { PRODUCER_IDLE, PRODUCER_TRACK, PRODUCER_PAUSE };
+
+static void checkConcurrentProducer() {
+    static SimulatedTracker tracker;
+    std::atomic<int> command{ PRODUCER_IDLE }, acknowledged{ PRODUCER_IDLE };
+    std::atomic<bool> done{ false };
+    std::atomic<int64_t> pushedWhileTracking{ 0 };
+    std::thread producer([&] {
+        while (!done) {
+            int current = command;
+            acknowledged = current;
+            if (current == PRODUCER_IDLE) {
+                tracker.ring.push(1000);
+            }
+            else if (current == PRODUCER_TRACK) {
+                tracker.ring.push(1);
+                pushedWhileTracking++;
+            }
+        }
+    });
+    auto pauseProducer = [&] {
+        command = PRODUCER_PAUSE;
+        while (acknowledged != PRODUCER_PAUSE) std::this_thread::yield();
+    };
+
+    bool exact = true;
+    for (int turn = 0; turn < 200; turn++) {
+        // Idle: the producer floods the ring with movement that must not be counted
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        pauseProducer();
+        tracker.startTracking();
+        pushedWhileTracking = 0;
+        command = PRODUCER_TRACK;
+        for (int tick = 0; tick < 4; tick++) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            tracker.tick();
+        }
+        pauseProducer();
+        exact = exact && tracker.stopTracking() == pushedWhileTracking;
+        command = PRODUCER_IDLE;
+    }
+    done = true;
+    producer.join();
+    check(exact, "turns with a concurrent producer count only their own movement");
+}
+
+int main() {
+    checkIdleOverflowThenTrack();
+    checkIdleTicksThenTrack();
+    checkOverflowingTurn();
+    checkConcurrentProducer();
+
+    std::cout << (ok ? "All mouse angle checks passed\n" : "Mouse angle checks FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+// Feeds synthetic high-rate mouse deltas through MouseDeltaRing and checks that the
+// drained total matches what was pushed.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread mouse_delta_benchmark.cpp mouse_angle.cpp -o mouse_delta_benchmark
+// Pass a drain interval in microseconds (default 1000); long intervals overrun the ring.
+#define NOMINMAX
+#include "mouse_angle.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+const int BENCHMARK_DELTAS = 20000000;
+const int BENCHMARK_RUNS = 2;
+
+int main(int argc, char** argv) {
+    int drainIntervalUs = argc > 1 ? std::atoi(argv[1]) : 1000;
+    bool ok = true;
+
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        static MouseDeltaRing ring;
+        MouseTurnAccumulator turn;
+        turn.start();
+
+        std::atomic<bool> done{ false };
+        int64_t pushed = 0;
+        auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] {
+            // Deterministic deltas of both signs, like a hand sweeping left and right
+            uint32_t state = 12345;
+            for (int i = 0; i < BENCHMARK_DELTAS; i++) {
+                state = state * 1664525u + 1013904223u;
+                int32_t delta = (int32_t)(state >> 27) - 15;
+                pushed += delta;
+                ring.push(delta);
+            }
+            done = true;
+        });
+
+        size_t drains = 0, entries = 0;
+        while (!done) {
+            size_t count;
+            turn.add(ring.drain(count));
+            entries += count;
+            drains++;
+            if (drainIntervalUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(drainIntervalUs));
+        }
+        producer.join();
+
+        // The last drain also takes any deltas the full ring held back
+        size_t count;
+        turn.add(ring.drain(count));
+        entries += count;
+        drains++;
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        int64_t counted = turn.stop();
+        ok = ok && counted == pushed;
+        std::cout << "Run " << run + 1 << ": " << BENCHMARK_DELTAS / seconds / 1e6 << "M deltas/s, "
+            << drains << " drains, " << (double)entries / drains << " entries per drain, "
+            << BENCHMARK_DELTAS - (int64_t)entries << " held back by a full ring, total "
+            << counted << (counted == pushed ? " (exact)" : " (MISMATCH)") << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#define NOMINMAX
+#include "neighbor_strongholds.h"
+#include "cell_lattice.h"
+#include "ring_prior.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+
+static PredictedStronghold makePrediction(const ConfirmedStronghold& confirmed, double x, double z,
+    double radius, double probability) {
+    PredictedStronghold prediction;
+    prediction.x = (int)std::round(x);
+    prediction.z = (int)std::round(z);
+    prediction.netherX = (int)std::round(x / 8.0);
+    prediction.netherZ = (int)std::round(z / 8.0);
+    prediction.distance = (int)std::round(std::sqrt((x - confirmed.x) * (x - confirmed.x) + (z - confirmed.z) * (z - confirmed.z)));
+    prediction.radius = radius;
+    prediction.probability = probability;
+    return prediction;
+}
+
+static const StrongholdCell* cellContaining(double x, double z) {
+    int xIndex, zIndex;
+    if (!strongholdCellIndexAt(x, xIndex) || !strongholdCellIndexAt(z, zIndex)) return nullptr;
+    return strongholdCellAt(xIndex, zIndex);
+}
+
+// Cells nearest first; each holds the nearest other stronghold if it holds one and no
+// nearer cell does
+static void predictBedrock(const ConfirmedStronghold& confirmed, const std::vector<const StrongholdCell*>& knownCells,
+    std::vector<const StrongholdCell*>& cells, std::vector<PredictedStronghold>& result) {
+    strongholdCellsNear(confirmed.x, confirmed.z, NEIGHBOR_SEARCH_RADIUS, cells);
+    auto squaredDistance = [&](const StrongholdCell* cell) {
+        return (cell->centerX - confirmed.x) * (cell->centerX - confirmed.x)
+            + (cell->centerZ - confirmed.z) * (cell->centerZ - confirmed.z);
+    };
+    std::sort(cells.begin(), cells.end(), [&](const StrongholdCell* a, const StrongholdCell* b) {
+        return squaredDistance(a) < squaredDistance(b);
+    });
+
+    double cellRadius = STRONGHOLD_CELL_SIZE * std::sqrt(0.5);
+    double noneNearer = 1.0;
+    for (const StrongholdCell* cell : cells) {
+        // Cells of confirmed strongholds are already known
+        if (std::find(knownCells.begin(), knownCells.end(), cell) != knownCells.end()) continue;
+        double prior = std::min(1.0, cell->prob);
+        result.push_back(makePrediction(confirmed, cell->centerX, cell->centerZ, cellRadius, prior * noneNearer));
+        noneNearer *= 1.0 - prior;
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const PredictedStronghold& a, const PredictedStronghold& b) {
+        return a.probability > b.probability;
+    });
+}
+
+// The other slots of the confirmed stronghold's ring, at the middle of the ring
+static void predictJava(const ConfirmedStronghold& confirmed, const std::vector<ConfirmedStronghold>& known,
+    std::vector<PredictedStronghold>& result) {
+    int ring = javaRingAt(std::sqrt(confirmed.x * confirmed.x + confirmed.z * confirmed.z));
+    if (ring < 0) return;
+    const JavaRing& ringInfo = javaRing(ring);
+    double middle = (ringInfo.minDistance + ringInfo.maxDistance) / 2.0;
+    double radius = JAVA_RING_WIDTH / 2.0;
+    double bearing = std::atan2(confirmed.x, -confirmed.z);
+
+    for (int slot = 1; slot < ringInfo.strongholds; slot++) {
+        double slotBearing = bearing + slot * 2.0 * M_PI / ringInfo.strongholds;
+        double x = middle * std::sin(slotBearing);
+        double z = -middle * std::cos(slotBearing);
+
+        bool isKnown = false;
+        for (const auto& other : known) {
+            if ((other.x - x) * (other.x - x) + (other.z - z) * (other.z - z) <= radius * radius) isKnown = true;
+        }
+        if (!isKnown) result.push_back(makePrediction(confirmed, x, z, radius, 1.0));
+    }
+
+    std::sort(result.begin(), result.end(), [](const PredictedStronghold& a, const PredictedStronghold& b) {
+        return a.distance < b.distance;
+    });
+}
+
+std::vector<PredictedStronghold> predictNeighborStrongholds(const ConfirmedStronghold& confirmed,
+    const SolverConfig& config, int maxResults) {
+    return predictNeighborStrongholds(std::vector<ConfirmedStronghold>{ confirmed }, config, maxResults)[0];
+}
+
+std::vector<std::vector<PredictedStronghold>> predictNeighborStrongholds(
+    const std::vector<ConfirmedStronghold>& confirmed, const SolverConfig& config, int maxResults) {
+    TRACE_SPAN("neighbor prediction");
+    std::vector<std::vector<PredictedStronghold>> results(confirmed.size());
+
+    if (config.edition == EDITION_JAVA) {
+        for (size_t i = 0; i < confirmed.size(); i++) {
+            predictJava(confirmed[i], confirmed, results[i]);
+        }
+    }
+    else {
+        trimStrongholdCellCache();
+        std::vector<const StrongholdCell*> knownCells;
+        for (const auto& stronghold : confirmed) {
+            const StrongholdCell* cell = cellContaining(stronghold.x, stronghold.z);
+            if (cell) knownCells.push_back(cell);
+        }
+
+        std::vector<const StrongholdCell*> cells;
+        for (size_t i = 0; i < confirmed.size(); i++) {
+            predictBedrock(confirmed[i], knownCells, cells, results[i]);
+        }
+    }
+
+    for (auto& result : results) {
+        if ((int)result.size() > maxResults) result.resize(std::max(0, maxResults));
+    }
+    return results;
+}
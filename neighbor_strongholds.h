@@ -0,0 +1,36 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "solver_config.h"
+
+// Strongholds near one that has been reached, from the placement rules alone.
+// Bedrock: every other lattice cell holds a stronghold with its prior, independently,
+// and a cell holds at most one, so a candidate cell is ranked by the chance that it holds
+// the nearest other stronghold. Java: the strongholds of a ring are evenly spaced in
+// angle, so the confirmed one fixes where every other stronghold of its ring lies.
+// Uses the cell lattice, so it runs on the solver thread like the solver.
+
+const double NEIGHBOR_SEARCH_RADIUS = 3000.0;   // Bedrock cells within this many blocks are considered
+const int NEIGHBOR_MAX_RESULTS = 8;
+
+struct ConfirmedStronghold {
+    double x, z;            // Overworld block position
+};
+
+struct PredictedStronghold {
+    int x, z;               // Most likely position: cell center or ring slot
+    int netherX, netherZ;
+    int distance;           // Blocks from the confirmed stronghold
+    double radius;          // Blocks the stronghold may lie from (x, z)
+    double probability;     // Bedrock: holds the nearest other stronghold; Java: 1
+};
+
+// Likely neighbours of confirmed, most likely first (Java: nearest first)
+std::vector<PredictedStronghold> predictNeighborStrongholds(const ConfirmedStronghold& confirmed,
+    const SolverConfig& config, int maxResults = NEIGHBOR_MAX_RESULTS);
+
+// One result list per confirmed stronghold. Every confirmed stronghold is known, so none
+// of them is predicted as a neighbour of another.
+std::vector<std::vector<PredictedStronghold>> predictNeighborStrongholds(
+    const std::vector<ConfirmedStronghold>& confirmed, const SolverConfig& config,
+    int maxResults = NEIGHBOR_MAX_RESULTS);
@@ -0,0 +1,80 @@
+// Lists the likely strongholds around confirmed stronghold positions.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 neighbor_tool.cpp neighbor_strongholds.cpp cell_lattice.cpp ring_prior.cpp
+//       stronghold_calculator.cpp fixed_point_solver.cpp first_throw_table.cpp distance_estimator.cpp
+//       solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o neighbor_strongholds
+#define NOMINMAX
+#include "neighbor_strongholds.h"
+#include "app_state.h"
+#include "number_format.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+int main(int argc, char** argv) {
+    SolverConfig config;
+    int maxResults = NEIGHBOR_MAX_RESULTS;
+    int argument = 1;
+    for (; argument < argc && std::strncmp(argv[argument], "--", 2) == 0; argument++) {
+        std::string option = argv[argument];
+        if (option == "--java") {
+            config.edition = EDITION_JAVA;
+        }
+        else if (option == "--count" && argument + 1 < argc) {
+            maxResults = std::atoi(argv[++argument]);
+        }
+        else {
+            argument = argc;
+        }
+    }
+    if (argument >= argc) {
+        std::cerr << "Usage: neighbor_strongholds [--java] [--count N] <x,z>...\n";
+        return 1;
+    }
+
+    std::vector<ConfirmedStronghold> confirmed;
+    for (; argument < argc; argument++) {
+        ConfirmedStronghold stronghold = { 0, 0 };
+        char comma;
+        std::istringstream ss(argv[argument]);
+        if (!(ss >> stronghold.x >> comma >> stronghold.z)) {
+            std::cerr << "Bad position: " << argv[argument] << "\n";
+            return 1;
+        }
+        confirmed.push_back(stronghold);
+    }
+
+    // The first query also builds the lattice tiles and the ring index it touches
+    auto start = std::chrono::steady_clock::now();
+    auto results = predictNeighborStrongholds(confirmed, config, maxResults);
+    auto firstEnd = std::chrono::steady_clock::now();
+    predictNeighborStrongholds(confirmed, config, maxResults);
+    auto secondEnd = std::chrono::steady_clock::now();
+    double firstUs = std::chrono::duration<double, std::micro>(firstEnd - start).count();
+    double secondUs = std::chrono::duration<double, std::micro>(secondEnd - firstEnd).count();
+
+    for (size_t i = 0; i < confirmed.size(); i++) {
+        NarrowFormatBuffer header;
+        header.text("Around (").integer((long long)std::round(confirmed[i].x)).text(", ")
+            .integer((long long)std::round(confirmed[i].z)).text("):");
+        std::cout << header.c_str() << (results[i].empty() ? " nothing predicted" : "") << "\n";
+        for (const auto& prediction : results[i]) {
+            NarrowFormatBuffer line;
+            line.text("  (").integer(prediction.x).text(", ").integer(prediction.z)
+                .text(") nether (").integer(prediction.netherX).text(", ").integer(prediction.netherZ)
+                .text(") ").integer(prediction.distance).text(" blocks, +-").integer((long long)prediction.radius)
+                .text(" ").fixed(prediction.probability * 100.0, 1).text("%");
+            std::cout << line.c_str() << "\n";
+        }
+    }
+    NarrowFormatBuffer timing;
+    timing.text("Answered in ").fixed(firstUs, 1).text(" us, again in ").fixed(secondUs, 1).text(" us");
+    std::cout << timing.c_str() << "\n";
+    return 0;
+}
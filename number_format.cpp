@@ -0,0 +1,23 @@
+#define NOMINMAX
+#include "number_format.h"
+#include <charconv>
+
+static size_t charsWritten(char* out, std::to_chars_result result) {
+    return result.ec == std::errc() ? (size_t)(result.ptr - out) : 0;
+}
+
+size_t formatIntegerChars(char* out, size_t capacity, long long value) {
+    return charsWritten(out, std::to_chars(out, out + capacity, value));
+}
+
+size_t formatFixedChars(char* out, size_t capacity, double value, int precision) {
+    return charsWritten(out, std::to_chars(out, out + capacity, value, std::chars_format::fixed, precision));
+}
+
+size_t formatGeneralChars(char* out, size_t capacity, double value) {
+    return charsWritten(out, std::to_chars(out, out + capacity, value, std::chars_format::general, 6));
+}
+
+size_t formatShortestChars(char* out, size_t capacity, double value) {
+    return charsWritten(out, std::to_chars(out, out + capacity, value));
+}
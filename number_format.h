@@ -0,0 +1,86 @@
+#pragma once
+#define NOMINMAX
+#include <cstddef>
+#include <string>
+
+// Stream-free number formatting for candidate rows. Numbers are converted with
+// std::to_chars into a fixed-size buffer on the stack, so building a row needs no
+// heap allocation and no locale lookups. Output matches the iostream manipulators
+// it replaces (setw right-aligns, std::fixed with setprecision, default precision).
+
+const size_t FORMAT_BUFFER_CAPACITY = 256;
+
+// Narrow conversions; return the number of chars written (0 if they did not fit)
+size_t formatIntegerChars(char* out, size_t capacity, long long value);
+size_t formatFixedChars(char* out, size_t capacity, double value, int precision);
+size_t formatGeneralChars(char* out, size_t capacity, double value);
+// Shortest text that reads back as exactly the same double
+size_t formatShortestChars(char* out, size_t capacity, double value);
+
+template <typename Char, size_t Capacity = FORMAT_BUFFER_CAPACITY>
+class FormatBuffer {
+public:
+    FormatBuffer() { data[0] = 0; }
+
+    FormatBuffer& text(const Char* s) {
+        while (*s) put(*s++);
+        return *this;
+    }
+    FormatBuffer& text(const std::basic_string<Char>& s) {
+        for (Char ch : s) put(ch);
+        return *this;
+    }
+
+    // Right-aligned in at least width characters, like std::setw
+    FormatBuffer& integer(long long value, int width = 0) {
+        char digits[32];
+        return pad(digits, formatIntegerChars(digits, sizeof(digits), value), width);
+    }
+    // Like std::fixed << std::setprecision(precision)
+    FormatBuffer& fixed(double value, int precision, int width = 0) {
+        char digits[64];
+        return pad(digits, formatFixedChars(digits, sizeof(digits), value, precision), width);
+    }
+    // Like an unmodified stream (6 significant digits)
+    FormatBuffer& general(double value, int width = 0) {
+        char digits[32];
+        return pad(digits, formatGeneralChars(digits, sizeof(digits), value), width);
+    }
+
+    const Char* c_str() const { return data; }
+    size_t size() const { return length; }
+    const Char* begin() const { return data; }
+    const Char* end() const { return data + length; }
+    bool truncated() const { return overflow; }
+    std::basic_string<Char> str() const { return std::basic_string<Char>(data, length); }
+
+    void clear() {
+        length = 0;
+        overflow = false;
+        data[0] = 0;
+    }
+
+private:
+    Char data[Capacity];
+    size_t length = 0;
+    bool overflow = false;
+
+    void put(Char ch) {
+        if (length + 1 < Capacity) {
+            data[length++] = ch;
+            data[length] = 0;
+        }
+        else {
+            overflow = true;
+        }
+    }
+
+    FormatBuffer& pad(const char* digits, size_t count, int width) {
+        for (int i = (int)count; i < width; i++) put(Char(' '));
+        for (size_t i = 0; i < count; i++) put(Char(digits[i]));
+        return *this;
+    }
+};
+
+typedef FormatBuffer<wchar_t> WideFormatBuffer;
+typedef FormatBuffer<char> NarrowFormatBuffer;
@@ -0,0 +1,226 @@
+#define NOMINMAX
+#include "posterior_heatmap.h"
+#include "stronghold_calculator.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <thread>
+
+const double NEGATIVE_INFINITY = -std::numeric_limits<double>::infinity();
+
+HeatmapThrow heatmapThrowFromState(const ApplicationState& state) {
+    HeatmapThrow result;
+    result.eyeX = state.coord1.x + 0.5;
+    result.eyeZ = state.coord1.z + 0.5;
+    result.angle = state.lastAngle;
+    result.useDistance = state.f4PressedFirst && state.calculatedDistance > 0;
+    result.distance = state.calculatedDistance;
+    result.distanceLikelihood = state.distanceLikelihood;
+    return result;
+}
+
+static double logCellPrior(const StrongholdCell* cell) {
+    const double cellArea = (double)STRONGHOLD_CELL_SIZE * STRONGHOLD_CELL_SIZE;
+    return std::log((cell ? cell->prob : HEATMAP_GAP_PRIOR) / cellArea);
+}
+
+static double logPrior(double x, double z) {
+    int xIndex, zIndex;
+    if (strongholdCellIndexAt(x, xIndex) && strongholdCellIndexAt(z, zIndex)) {
+        return logCellPrior(strongholdCellAt(xIndex, zIndex));
+    }
+    return logCellPrior(nullptr);
+}
+
+// Adds the log likelihood of every throw to the log prior. Does not touch the cell lattice.
+static double addLogLikelihood(const std::vector<HeatmapThrow>& throws, double x, double z, double result) {
+    for (const auto& eyeThrow : throws) {
+        double error = angleBetween(eyeThrow.eyeX, eyeThrow.eyeZ, x, z) - eyeThrow.angle;
+        error = std::fmod(error + 540.0, 360.0) - 180.0;
+        result += -0.5 * (error / solverConfig.angleStdDev) * (error / solverConfig.angleStdDev);
+
+        if (eyeThrow.useDistance) {
+            double distance = std::sqrt((x - eyeThrow.eyeX) * (x - eyeThrow.eyeX) + (z - eyeThrow.eyeZ) * (z - eyeThrow.eyeZ));
+            if (eyeThrow.distanceLikelihood.isValid()) {
+                double density = eyeThrow.distanceLikelihood.density(distance);
+                if (density <= 0) return NEGATIVE_INFINITY;
+                result += std::log(density);
+            }
+            else {
+                double deviation = (distance - eyeThrow.distance) / solverConfig.f4DistanceStdDev;
+                result += -0.5 * deviation * deviation;
+            }
+        }
+    }
+    return result;
+}
+
+double logPosterior(const std::vector<HeatmapThrow>& throws, double x, double z) {
+    return addLogLikelihood(throws, x, z, logPrior(x, z));
+}
+
+// Position of index in indices, appending it if new
+static int slotOf(std::vector<int>& indices, int index) {
+    auto found = std::find(indices.begin(), indices.end(), index);
+    if (found != indices.end()) return (int)(found - indices.begin());
+    indices.push_back(index);
+    return (int)indices.size() - 1;
+}
+
+// log(exp(a) + exp(b))
+static double logAdd(double a, double b) {
+    if (a == NEGATIVE_INFINITY) return b;
+    if (b == NEGATIVE_INFINITY) return a;
+    double high = std::max(a, b);
+    return high + std::log1p(std::exp(std::min(a, b) - high));
+}
+
+typedef std::vector<float> HeatmapTile; // Log posterior, row-major
+
+struct PyramidWriter {
+    const std::vector<HeatmapThrow>& throws;
+    HeatmapRegion region;
+    std::string directory;
+    int threadCount;
+    double peak;            // Log posterior mapped to white
+    int tilesWritten = 0;
+    bool failed = false;
+
+    bool writeTile(int level, int tileX, int tileZ, const HeatmapTile& tile) {
+        std::filesystem::path path = std::filesystem::path(directory) / std::to_string(level);
+        std::error_code error;
+        std::filesystem::create_directories(path, error);
+        path /= std::to_string(tileX) + "_" + std::to_string(tileZ) + ".pgm";
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+        file << "P5\n" << HEATMAP_TILE_SIZE << " " << HEATMAP_TILE_SIZE << "\n255\n";
+
+        std::vector<unsigned char> row(HEATMAP_TILE_SIZE);
+        for (int z = 0; z < HEATMAP_TILE_SIZE; z++) {
+            for (int x = 0; x < HEATMAP_TILE_SIZE; x++) {
+                double value = tile[z * HEATMAP_TILE_SIZE + x];
+                double level = 1.0 + (value - peak) / HEATMAP_LOG_RANGE;
+                row[x] = (unsigned char)std::lround(255.0 * std::max(0.0, std::min(1.0, level)));
+            }
+            file.write((const char*)row.data(), row.size());
+        }
+        tilesWritten++;
+        return (bool)file;
+    }
+
+    // Level 0: one pixel per block, rows split across threads
+    void renderBlocks(int tileX, int tileZ, HeatmapTile& tile) {
+        TRACE_SPAN("heatmap tile");
+        int originX = region.minX + tileX * HEATMAP_TILE_SIZE;
+        int originZ = region.minZ + tileZ * HEATMAP_TILE_SIZE;
+
+        // The cell lattice cache is not thread-safe, so the log prior of each cell the tile
+        // overlaps is looked up here; the workers only read these tables
+        std::vector<int> columnSlots(HEATMAP_TILE_SIZE, -1), rowSlots(HEATMAP_TILE_SIZE, -1); // -1 in a gap
+        std::vector<int> xIndices, zIndices;
+        for (int i = 0; i < HEATMAP_TILE_SIZE; i++) {
+            int index;
+            if (strongholdCellIndexAt(originX + i + 0.5, index)) columnSlots[i] = slotOf(xIndices, index);
+            if (strongholdCellIndexAt(originZ + i + 0.5, index)) rowSlots[i] = slotOf(zIndices, index);
+        }
+        std::vector<double> cellLogPriors;
+        for (int xIndex : xIndices) {
+            for (int zIndex : zIndices) {
+                cellLogPriors.push_back(logCellPrior(strongholdCellAt(xIndex, zIndex)));
+            }
+        }
+        double gapLogPrior = logCellPrior(nullptr);
+
+        auto worker = [&](int first, int step) {
+            for (int z = first; z < HEATMAP_TILE_SIZE; z += step) {
+                for (int x = 0; x < HEATMAP_TILE_SIZE; x++) {
+                    int blockX = originX + x, blockZ = originZ + z;
+                    bool inside = blockX < region.maxX && blockZ < region.maxZ;
+                    double prior = columnSlots[x] >= 0 && rowSlots[z] >= 0
+                        ? cellLogPriors[columnSlots[x] * zIndices.size() + rowSlots[z]] : gapLogPrior;
+                    tile[z * HEATMAP_TILE_SIZE + x] = inside
+                        ? (float)addLogLikelihood(throws, blockX + 0.5, blockZ + 0.5, prior) : (float)NEGATIVE_INFINITY;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount; i++) {
+            threads.emplace_back(worker, i, threadCount);
+        }
+        worker(0, threadCount);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Render a tile and everything below it, writing each tile once complete
+    bool render(int level, int tileX, int tileZ, HeatmapTile& tile) {
+        int span = HEATMAP_TILE_SIZE << level;
+        if (region.minX + tileX * span >= region.maxX || region.minZ + tileZ * span >= region.maxZ) {
+            return false; // Entirely outside the region
+        }
+
+        tile.assign((size_t)HEATMAP_TILE_SIZE * HEATMAP_TILE_SIZE, (float)NEGATIVE_INFINITY);
+        if (level == 0) {
+            renderBlocks(tileX, tileZ, tile);
+        }
+        else {
+            // Each child fills one quadrant; pixels average the probability of 2x2 children pixels
+            HeatmapTile child;
+            int half = HEATMAP_TILE_SIZE / 2;
+            for (int quadrant = 0; quadrant < 4; quadrant++) {
+                int childX = tileX * 2 + (quadrant & 1);
+                int childZ = tileZ * 2 + (quadrant >> 1);
+                if (!render(level - 1, childX, childZ, child) || failed) continue;
+
+                for (int z = 0; z < half; z++) {
+                    for (int x = 0; x < half; x++) {
+                        const float* source = &child[(2 * z) * HEATMAP_TILE_SIZE + 2 * x];
+                        double sum = logAdd(logAdd(source[0], source[1]),
+                            logAdd(source[HEATMAP_TILE_SIZE], source[HEATMAP_TILE_SIZE + 1]));
+                        int targetX = (quadrant & 1) * half + x;
+                        int targetZ = (quadrant >> 1) * half + z;
+                        tile[targetZ * HEATMAP_TILE_SIZE + targetX] = (float)(sum - std::log(4.0));
+                    }
+                }
+            }
+        }
+
+        if (!writeTile(level, tileX, tileZ, tile)) failed = true;
+        return true;
+    }
+};
+
+// Highest log posterior on a coarse grid, used as the white point for every level
+static double estimatePeak(const std::vector<HeatmapThrow>& throws, const HeatmapRegion& region) {
+    double peak = NEGATIVE_INFINITY;
+    for (int i = 0; i < HEATMAP_SCALE_SAMPLES; i++) {
+        for (int j = 0; j < HEATMAP_SCALE_SAMPLES; j++) {
+            double x = region.minX + (region.maxX - region.minX) * (i + 0.5) / HEATMAP_SCALE_SAMPLES;
+            double z = region.minZ + (region.maxZ - region.minZ) * (j + 0.5) / HEATMAP_SCALE_SAMPLES;
+            peak = std::max(peak, logPosterior(throws, x, z));
+        }
+    }
+    return peak;
+}
+
+int exportPosteriorPyramid(const std::vector<HeatmapThrow>& throws, const HeatmapRegion& region,
+    const std::string& directory, int threadCount) {
+    if (region.maxX <= region.minX || region.maxZ <= region.minZ) return 0;
+
+    // Top level: a single tile covering the whole region
+    int extent = std::max(region.maxX - region.minX, region.maxZ - region.minZ);
+    int topLevel = 0;
+    while ((HEATMAP_TILE_SIZE << topLevel) < extent) topLevel++;
+
+    PyramidWriter writer = { throws, region, directory, std::max(1, threadCount), estimatePeak(throws, region) };
+    HeatmapTile tile;
+    writer.render(topLevel, 0, 0, tile);
+    return writer.failed ? -1 : writer.tilesWritten;
+}
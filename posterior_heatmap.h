@@ -0,0 +1,42 @@
+#pragma once
+#define NOMINMAX
+#include <string>
+#include <vector>
+#include "app_state.h"
+
+// Block-resolution posterior heatmaps, written as a PGM tile pyramid:
+// <directory>/<level>/<tileX>_<tileZ>.pgm, where level 0 is one pixel per block and
+// each level above halves the resolution. Tiles are rendered depth-first, so only
+// one tile per level is held in memory however large the region is. Block tiles are
+// split across threads, which read cell priors looked up beforehand on the calling
+// thread, since the cell lattice cache is not thread-safe.
+
+const int HEATMAP_TILE_SIZE = 256;          // Pixels per tile side
+const double HEATMAP_LOG_RANGE = 12.0;      // Natural-log range below the peak mapped to grey levels
+const double HEATMAP_GAP_PRIOR = 0.05;      // Prior of a cell-sized area between cells, as in the solver
+const int HEATMAP_SCALE_SAMPLES = 256;      // Grid points per side for the peak estimate
+
+// One throw as the solver sees it
+struct HeatmapThrow {
+    double eyeX, eyeZ;      // Eye start position
+    double angle;           // Degrees, as angleBetween
+    bool useDistance;       // F4 distance was measured
+    double distance;        // Nominal F4 distance
+    DistanceLikelihood distanceLikelihood;
+};
+
+// The throw captured in state (coord1 towards coord2)
+HeatmapThrow heatmapThrowFromState(const ApplicationState& state);
+
+// Unnormalized log posterior at a block position after all throws
+double logPosterior(const std::vector<HeatmapThrow>& throws, double x, double z);
+
+struct HeatmapRegion {
+    int minX, minZ;     // Inclusive
+    int maxX, maxZ;     // Exclusive
+};
+
+// Render and write the pyramid. Returns the number of tiles written, or -1 if the
+// directory could not be written.
+int exportPosteriorPyramid(const std::vector<HeatmapThrow>& throws, const HeatmapRegion& region,
+    const std::string& directory, int threadCount);
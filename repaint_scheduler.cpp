@@ -0,0 +1,60 @@
+#define NOMINMAX
+#include "repaint_scheduler.h"
+#include <chrono>
+#include <cmath>
+
+double SteadyRepaintClock::nowMs() const {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(now.time_since_epoch()).count();
+}
+
+void RepaintScheduler::requestUpdate(unsigned int views) {
+    if (!views) return;
+    requests++;
+    if ((dirtyViews & views) == views) {
+        coalesced++;
+    }
+    dirtyViews |= views;
+}
+
+double RepaintScheduler::msUntilFlush() const {
+    if (!dirtyViews) return -1.0;
+    if (!hasFlushed) return 0.0;
+
+    double due = lastFlushMs + frameIntervalMs;
+    double now = clock.nowMs();
+    return due > now ? due - now : 0.0;
+}
+
+unsigned int RepaintScheduler::takeDueViews() {
+    if (msUntilFlush() != 0.0) return 0;
+
+    unsigned int views = dirtyViews;
+    dirtyViews = 0;
+    hasFlushed = true;
+    lastFlushMs = clock.nowMs();
+    flushes++;
+    return views;
+}
+
+unsigned int RepaintScheduler::flush(RepaintTimer& timer) {
+    unsigned int views = takeDueViews();
+
+    // Anything requested too soon after the last flush waits for the timer
+    double delay = msUntilFlush();
+    if (delay > 0 && !timerArmed) {
+        timer.arm((unsigned int)std::ceil(delay));
+        timerArmed = true;
+    }
+    return views;
+}
+
+unsigned int RepaintScheduler::request(unsigned int views, RepaintTimer& timer) {
+    requestUpdate(views);
+    return timerArmed ? 0 : flush(timer);
+}
+
+unsigned int RepaintScheduler::timerFired(RepaintTimer& timer) {
+    timerArmed = false;
+    return flush(timer);
+}
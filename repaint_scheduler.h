@@ -0,0 +1,70 @@
+#pragma once
+#define NOMINMAX
+#include <cstdint>
+
+// Views that can be marked dirty
+enum RepaintView {
+    REPAINT_VIEW_OVERLAY = 1 << 0,
+    REPAINT_VIEW_MAIN_WINDOW = 1 << 1
+};
+
+const double REPAINT_FRAME_INTERVAL_MS = 1000.0 / 60.0; // Target frame rate for coalesced updates
+
+// Time source for the scheduler, replaceable with a simulated clock
+class RepaintClock {
+public:
+    virtual ~RepaintClock() = default;
+    virtual double nowMs() const = 0;
+};
+
+class SteadyRepaintClock : public RepaintClock {
+public:
+    double nowMs() const override;
+};
+
+// One-shot timer that makes the window call timerFired, replaceable with a simulated one
+class RepaintTimer {
+public:
+    virtual ~RepaintTimer() = default;
+    virtual void arm(unsigned int delayMs) = 0;
+};
+
+// Coalesces update requests to at most one flush per frame interval. The first
+// request after an idle period is due immediately so a single key press is not
+// delayed; requests arriving within the interval are merged into the next flush.
+class RepaintScheduler {
+public:
+    RepaintScheduler(const RepaintClock& clock, double frameIntervalMs = REPAINT_FRAME_INTERVAL_MS)
+        : clock(clock), frameIntervalMs(frameIntervalMs) {}
+
+    // Mark views dirty
+    void requestUpdate(unsigned int views);
+
+    // Milliseconds until pending views are due, 0 if due now, negative if nothing is pending
+    double msUntilFlush() const;
+
+    // Dirty views if a flush is due (clearing them), otherwise 0
+    unsigned int takeDueViews();
+
+    // The window's repaint path. Both return the views to repaint now; views that are
+    // not due yet arm the timer once, rounded up to whole milliseconds, and wait for it.
+    unsigned int request(unsigned int views, RepaintTimer& timer);
+    unsigned int timerFired(RepaintTimer& timer);
+
+    uint64_t requestCount() const { return requests; }
+    uint64_t flushCount() const { return flushes; }
+    uint64_t coalescedCount() const { return coalesced; }
+
+private:
+    const RepaintClock& clock;
+    double frameIntervalMs;
+    unsigned int dirtyViews = 0;
+    bool hasFlushed = false;
+    double lastFlushMs = 0.0;
+    bool timerArmed = false;
+    uint64_t requests = 0;
+    uint64_t flushes = 0;
+    uint64_t coalesced = 0;     // View requests merged into an already pending flush
+
+    unsigned int flush(RepaintTimer& timer);
+};
@@ -0,0 +1,141 @@
+// Drives RepaintScheduler's request and timerFired with a simulated clock and timer,
+// as main_window.cpp's RequestRepaint and repaint timer do, and checks that bursts
+// of invalidations coalesce into one repaint per frame, each within the frame deadline.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 repaint_scheduler_test.cpp repaint_scheduler.cpp -o repaint_scheduler_test
+#define NOMINMAX
+#include "repaint_scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+class FakeRepaintClock : public RepaintClock {
+public:
+    double nowMs() const override { return now; }
+    double now = 0.0;
+};
+
+struct Repaint {
+    double timeMs;
+    unsigned int views;
+};
+
+// SetTimer replaced by a due time on the simulated clock
+class FakeRepaintTimer : public RepaintTimer {
+public:
+    explicit FakeRepaintTimer(FakeRepaintClock& clock) : clock(clock) {}
+    void arm(unsigned int delayMs) override { dueMs = clock.now + delayMs; }
+
+    FakeRepaintClock& clock;
+    double dueMs = -1.0;
+};
+
+// Feeds requests and timer expiries to the scheduler's request and timerFired, the
+// calls main_window.cpp makes, and records the repaints they return
+class SimulatedWindow {
+public:
+    explicit SimulatedWindow(FakeRepaintClock& clock) : clock(clock), timer(clock), scheduler(clock) {}
+
+    void request(unsigned int views) {
+        record(scheduler.request(views, timer));
+    }
+
+    // Advance to timeMs, firing the repaint timer on the way if it is due
+    void advanceTo(double timeMs) {
+        while (timer.dueMs >= 0 && timer.dueMs <= timeMs) {
+            clock.now = timer.dueMs;
+            timer.dueMs = -1.0;
+            record(scheduler.timerFired(timer));
+        }
+        clock.now = timeMs;
+    }
+
+    RepaintScheduler& schedulerState() { return scheduler; }
+    std::vector<Repaint> repaints;
+
+private:
+    void record(unsigned int views) {
+        if (views) repaints.push_back({ clock.now, views });
+    }
+
+    FakeRepaintClock& clock;
+    FakeRepaintTimer timer;
+    RepaintScheduler scheduler;
+};
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+// A single key press after an idle period repaints at once
+static void checkIdlePress() {
+    FakeRepaintClock clock;
+    SimulatedWindow window(clock);
+    window.advanceTo(1000.0);
+    window.request(REPAINT_VIEW_OVERLAY | REPAINT_VIEW_MAIN_WINDOW);
+    check(window.repaints.size() == 1 && window.repaints[0].timeMs == 1000.0, "idle press repaints immediately");
+}
+
+// Forty F4 presses within 10 ms of a repaint produce exactly one more repaint of both
+// views, no later than one frame (rounded up to the timer's millisecond) after the last
+static void checkBurst() {
+    FakeRepaintClock clock;
+    SimulatedWindow window(clock);
+    window.request(REPAINT_VIEW_OVERLAY);
+    for (int press = 0; press < 40; press++) {
+        window.advanceTo(0.25 * press);
+        window.request(press % 2 ? REPAINT_VIEW_OVERLAY : REPAINT_VIEW_MAIN_WINDOW);
+    }
+    window.advanceTo(1000.0);
+
+    check(window.repaints.size() == 2, "burst coalesces into one repaint");
+    if (window.repaints.size() == 2) {
+        const Repaint& repaint = window.repaints[1];
+        check(repaint.views == (REPAINT_VIEW_OVERLAY | REPAINT_VIEW_MAIN_WINDOW), "coalesced repaint covers both views");
+        check(repaint.timeMs <= std::ceil(REPAINT_FRAME_INTERVAL_MS), "coalesced repaint is within the frame deadline");
+    }
+    check(window.schedulerState().coalescedCount() >= 38, "repeated requests are counted as coalesced");
+    check(window.schedulerState().msUntilFlush() < 0, "nothing is left pending after the burst");
+}
+
+// Hammering the distance key at 1 kHz for a second repaints at the frame rate, and no
+// request waits longer than a frame for its repaint
+static void checkSustainedHammering() {
+    FakeRepaintClock clock;
+    SimulatedWindow window(clock);
+    std::vector<double> requestTimes;
+    for (int press = 0; press < 1000; press++) {
+        window.advanceTo(press);
+        window.request(REPAINT_VIEW_OVERLAY | REPAINT_VIEW_MAIN_WINDOW);
+        requestTimes.push_back(press);
+    }
+    window.advanceTo(2000.0);
+
+    size_t frames = window.repaints.size();
+    check(frames >= 55 && frames <= 61, "sustained presses repaint at about 60 frames per second");
+
+    double worstWaitMs = 0.0;
+    size_t next = 0;
+    for (double requestMs : requestTimes) {
+        while (next < frames && window.repaints[next].timeMs < requestMs) next++;
+        if (next < frames) worstWaitMs = std::max(worstWaitMs, window.repaints[next].timeMs - requestMs);
+    }
+    check(next < frames, "the last request is repainted");
+    check(worstWaitMs <= std::ceil(REPAINT_FRAME_INTERVAL_MS), "no request waits longer than a frame");
+    std::cout << "1000 presses in 1 s: " << frames << " repaints, longest wait " << worstWaitMs << " ms\n";
+}
+
+int main() {
+    checkIdlePress();
+    checkBurst();
+    checkSustainedHammering();
+
+    std::cout << (ok ? "All repaint scheduler checks passed\n" : "Repaint scheduler checks FAILED\n");
+    return ok ? 0 : 1;
+}
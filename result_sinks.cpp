@@ -0,0 +1,282 @@
+#define NOMINMAX
+#include "result_sinks.h"
+#include "metrics.h"
+#include "solver_config.h"
+#include "number_format.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+ResultSnapshot makeResultSnapshot(uint64_t sequence, const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates) {
+    ResultSnapshot snapshot;
+    snapshot.sequence = sequence;
+    snapshot.angle = state.lastAngle;
+    snapshot.playerX = state.coord1.x;
+    snapshot.playerZ = state.coord1.z;
+    snapshot.distanceMismatch = state.distanceValidationFailed;
+    int rows = std::min(solverConfig.copiedCandidates, (int)candidates.size());
+    for (int i = 0; i < rows; i++) {
+        const auto& candidate = candidates[i];
+        snapshot.rows.push_back({ candidate.projectionX, candidate.projectionZ,
+            candidate.netherX, candidate.netherZ, candidate.conditionalProb });
+    }
+    return snapshot;
+}
+
+std::wstring formatResultText(const ResultSnapshot& snapshot) {
+    // Header, up to ten rows of up to ~70 characters and the warning
+    FormatBuffer<wchar_t, 1024> text;
+    if (!snapshot.rows.empty()) {
+        text.text(L"Stronghold Locations:\n");
+        for (size_t i = 0; i < snapshot.rows.size(); i++) {
+            const auto& row = snapshot.rows[i];
+            text.text(L"#").integer(i + 1).text(L": Overworld (").integer(row.projectionX)
+                .text(L", ").integer(row.projectionZ).text(L") - Nether (")
+                .integer(row.netherX).text(L", ").integer(row.netherZ).text(L") - ")
+                .fixed(row.conditionalProb * 100.0, 1).text(L"%\n");
+        }
+
+        // Add warning if distance validation failed
+        if (snapshot.distanceMismatch) {
+            text.text(L"\nWARNING: Distance mismatch detected!");
+        }
+    }
+    else {
+        text.text(L"Angle: ").general(snapshot.angle).text(L"° - No strongholds found");
+    }
+    return text.str();
+}
+
+std::string formatResultLine(const ResultSnapshot& snapshot) {
+    // Header and up to ten rows of up to ~50 characters
+    FormatBuffer<char, 1024> line;
+    line.integer(snapshot.sequence).text("\t").fixed(snapshot.angle, 3)
+        .text("\t").integer(snapshot.playerX).text("\t").integer(snapshot.playerZ)
+        .text(snapshot.distanceMismatch ? "\t1" : "\t0");
+    for (const auto& row : snapshot.rows) {
+        line.text("\t").integer(row.projectionX).text(",").integer(row.projectionZ)
+            .text(",").integer(row.netherX).text(",").integer(row.netherZ)
+            .text(",").fixed(row.conditionalProb, 4);
+    }
+    line.text("\n");
+    return line.str();
+}
+
+FileResultSink::FileResultSink(const std::string& path) : file(path, std::ios::app) {}
+
+#ifdef _WIN32
+FileResultSink::FileResultSink(const std::wstring& path) : file(path.c_str(), std::ios::app) {}
+#endif
+
+bool FileResultSink::publish(const ResultSnapshot& snapshot) {
+    if (!file.is_open()) return false;
+    file << formatResultLine(snapshot);
+    file.flush();
+    return file.good();
+}
+
+bool StdoutResultSink::publish(const ResultSnapshot& snapshot) {
+    std::string line = formatResultLine(snapshot);
+    return std::fwrite(line.data(), 1, line.size(), stdout) == line.size() && std::fflush(stdout) == 0;
+}
+
+#ifdef _WIN32
+SocketResultSink::~SocketResultSink() {
+    disconnect();
+}
+
+bool SocketResultSink::connectListener() {
+    if (pipe) return true;
+    // Overlapped, so cancel() can abort a write to a listener that stopped reading
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    pipe = handle;
+    return true;
+}
+
+void SocketResultSink::disconnect() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pipe) CloseHandle(pipe);
+    pipe = nullptr;
+}
+
+void SocketResultSink::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    if (pipe) CancelIoEx(pipe, NULL);
+}
+
+bool SocketResultSink::publish(const ResultSnapshot& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) return false;
+    }
+    if (!connectListener()) return true;
+    std::string line = formatResultLine(snapshot);
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!overlapped.hEvent) return false;
+    BOOL started;
+    {
+        // Started under the lock, so a cancel() either sees this write or comes before it
+        std::lock_guard<std::mutex> lock(mutex);
+        started = !cancelled && (WriteFile(pipe, line.data(), (DWORD)line.size(), NULL, &overlapped)
+            || GetLastError() == ERROR_IO_PENDING);
+    }
+    DWORD written = 0;
+    bool delivered = started && GetOverlappedResult(pipe, &overlapped, &written, TRUE) && written == line.size();
+    CloseHandle(overlapped.hEvent);
+    if (!delivered) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+#else
+SocketResultSink::~SocketResultSink() {
+    disconnect();
+}
+
+bool SocketResultSink::connectListener() {
+    if (fd >= 0) return true;
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socketFd < 0) return false;
+    if (connect(socketFd, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(socketFd);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    fd = socketFd;
+    // A cancel() that came in meanwhile still has to stop the sends
+    if (cancelled) shutdown(fd, SHUT_RDWR);
+    return true;
+}
+
+void SocketResultSink::disconnect() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+void SocketResultSink::cancel() {
+    // Shutting the socket down makes a blocked send return with an error
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+}
+
+bool SocketResultSink::publish(const ResultSnapshot& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) return false;
+    }
+    if (!connectListener()) return true;
+    std::string line = formatResultLine(snapshot);
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;     // A listener that went away must not raise SIGPIPE
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < line.size()) {
+        ssize_t count = send(fd, line.data() + sent, line.size() - sent, flags);
+        if (count <= 0) {
+            disconnect();
+            return false;
+        }
+        sent += (size_t)count;
+    }
+    return true;
+}
+#endif
+
+void ResultPublisher::addSink(std::unique_ptr<ResultSink> sink) {
+    workers.push_back(std::make_unique<SinkWorker>());
+    SinkWorker* worker = workers.back().get();
+    worker->sink = std::move(sink);
+    worker->thread = std::thread(run, worker);
+}
+
+void ResultPublisher::publish(const ResultSnapshot& snapshot) {
+    auto shared = std::make_shared<const ResultSnapshot>(snapshot);
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (worker->queue.size() >= RESULT_QUEUE_LIMIT) {
+                worker->queue.pop_front();
+                metrics.resultSinkDrops.add();
+            }
+            worker->queue.push_back(shared);
+        }
+        worker->wake.notify_one();
+    }
+}
+
+void ResultPublisher::stop() {
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stopping = true;
+        }
+        worker->wake.notify_one();
+    }
+
+    // One deadline for all sinks, so shutdown is not held up by more than the timeout
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RESULT_STOP_TIMEOUT_MS);
+    for (auto& worker : workers) {
+        bool finished;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            finished = worker->done.wait_until(lock, deadline, [&]() { return worker->finished; });
+            if (!finished) {
+                metrics.resultSinkDrops.add(worker->queue.size());
+                worker->queue.clear();
+            }
+        }
+        if (!finished) worker->sink->cancel();
+    }
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    workers.clear();
+}
+
+void ResultPublisher::run(SinkWorker* worker) {
+    while (true) {
+        std::shared_ptr<const ResultSnapshot> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->wake.wait(lock, [&]() { return worker->stopping || !worker->queue.empty(); });
+            if (worker->queue.empty()) {
+                worker->finished = true;
+                worker->done.notify_all();
+                return;
+            }
+            snapshot = worker->queue.front();
+            worker->queue.pop_front();
+        }
+
+        TRACE_SPAN("publish result");
+        if (!worker->sink->publish(*snapshot)) {
+            metrics.resultSinkFailures.add();
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+#define NOMINMAX
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "app_state.h"
+
+// Publishing of solve results. The hotkey path only takes an immutable snapshot
+// and queues it; every sink (clipboard, file, socket, stdout) runs on its own
+// thread, so a slow or locked sink delays neither the overlay nor other sinks.
+
+const size_t RESULT_QUEUE_LIMIT = 8;    // Snapshots queued per sink; the oldest is dropped past this
+const int RESULT_STOP_TIMEOUT_MS = 500; // stop() waits this long for a sink before cancelling it
+
+struct ResultRow {
+    int projectionX, projectionZ;
+    int netherX, netherZ;
+    double conditionalProb;
+};
+
+struct ResultSnapshot {
+    uint64_t sequence;
+    double angle;
+    int playerX, playerZ;
+    bool distanceMismatch;
+    std::vector<ResultRow> rows;    // Most likely first, at most solverConfig.copiedCandidates
+};
+
+ResultSnapshot makeResultSnapshot(uint64_t sequence, const ApplicationState& state,
+    const std::vector<StrongholdCandidate>& candidates);
+
+// Human-readable text, as placed on the clipboard
+std::wstring formatResultText(const ResultSnapshot& snapshot);
+
+// One tab-separated line for machine consumers:
+// sequence, angle, x, z, mismatch (0/1), then x,z,netherX,netherZ,probability per row
+std::string formatResultLine(const ResultSnapshot& snapshot);
+
+class ResultSink {
+public:
+    virtual ~ResultSink() {}
+    virtual const char* name() const = 0;
+    // Deliver one snapshot, false if it could not be delivered
+    virtual bool publish(const ResultSnapshot& snapshot) = 0;
+    // Called from another thread to make a publish stuck in the middle of a delivery
+    // return, and every later one fail at once. Sinks that cannot block need not do anything.
+    virtual void cancel() {}
+};
+
+// Appends formatResultLine lines to a file, flushed after each snapshot
+class FileResultSink : public ResultSink {
+public:
+    explicit FileResultSink(const std::string& path);
+#ifdef _WIN32
+    explicit FileResultSink(const std::wstring& path);
+#endif
+    const char* name() const override { return "file"; }
+    bool publish(const ResultSnapshot& snapshot) override;
+
+private:
+    std::ofstream file;
+};
+
+class StdoutResultSink : public ResultSink {
+public:
+    const char* name() const override { return "stdout"; }
+    bool publish(const ResultSnapshot& snapshot) override;
+};
+
+// Writes formatResultLine lines to a local listener: a Unix domain socket, or a
+// named pipe on Windows. Snapshots published while nobody listens are skipped.
+// A listener that stops reading blocks the write until cancel().
+class SocketResultSink : public ResultSink {
+public:
+    explicit SocketResultSink(const std::string& path) : path(path) {}
+    ~SocketResultSink() override;
+    const char* name() const override { return "socket"; }
+    bool publish(const ResultSnapshot& snapshot) override;
+    void cancel() override;
+
+private:
+    bool connectListener();
+    void disconnect();
+
+    std::string path;
+    std::mutex mutex;           // Guards the handle against cancel() while it is opened or closed
+    bool cancelled = false;
+#ifdef _WIN32
+    void* pipe = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+class ResultPublisher {
+public:
+    ResultPublisher() {}
+    ~ResultPublisher() { stop(); }
+    ResultPublisher(const ResultPublisher&) = delete;
+    ResultPublisher& operator=(const ResultPublisher&) = delete;
+
+    // Start a worker thread for the sink; sinks may be added until the first publish
+    void addSink(std::unique_ptr<ResultSink> sink);
+
+    // Queue a snapshot for every sink; never blocks on a sink
+    void publish(const ResultSnapshot& snapshot);
+
+    // Deliver what is queued, then join the workers. A sink that is not done within
+    // RESULT_STOP_TIMEOUT_MS is cancelled and what it still had queued is dropped.
+    void stop();
+
+    bool empty() const { return workers.empty(); }
+
+private:
+    struct SinkWorker {
+        std::unique_ptr<ResultSink> sink;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::shared_ptr<const ResultSnapshot>> queue;
+        bool stopping = false;
+        bool finished = false;      // Set by the worker thread as it exits
+        std::condition_variable done;
+        std::thread thread;
+    };
+
+    static void run(SinkWorker* worker);
+
+    std::vector<std::unique_ptr<SinkWorker>> workers;
+};
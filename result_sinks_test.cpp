@@ -0,0 +1,105 @@
+// Checks that ResultPublisher delivers what is queued when it stops, and that a
+// socket listener which stopped reading cannot hold stop() up past RESULT_STOP_TIMEOUT_MS.
+// POSIX only (the sink talks to a Unix domain socket here), e.g.:
+//   g++ -std=c++17 -O2 -pthread result_sinks_test.cpp result_sinks.cpp solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o result_sinks_test
+#define NOMINMAX
+#include "result_sinks.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+static int listenAt(const std::string& path) {
+    unlink(path.c_str());
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 1) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static ResultSnapshot makeSnapshot(uint64_t sequence) {
+    ResultSnapshot snapshot = { sequence, 123.456, 100, -200, false, {} };
+    for (int i = 0; i < 10; i++) {
+        snapshot.rows.push_back({ 1000 + i, -2000 - i, 125 + i, -250 - i, 0.1 });
+    }
+    return snapshot;
+}
+
+static void checkQueuedDelivered() {
+    std::string path = "/tmp/result_sinks_test_reader.sock";
+    int listener = listenAt(path);
+    check(listener >= 0, "listener socket opens");
+
+    ResultPublisher publisher;
+    publisher.addSink(std::make_unique<SocketResultSink>(path));
+    for (int i = 1; i <= 5; i++) {
+        publisher.publish(makeSnapshot(i));
+    }
+
+    int connection = accept(listener, nullptr, nullptr);
+    std::thread reader;
+    int lines = 0;
+    reader = std::thread([&]() {
+        char buffer[4096];
+        ssize_t count;
+        while ((count = read(connection, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t i = 0; i < count; i++) lines += buffer[i] == '\n';
+        }
+    });
+    publisher.stop();
+    reader.join();
+
+    check(lines == 5, "stop() delivers every queued snapshot to a reading listener");
+    close(connection);
+    close(listener);
+    unlink(path.c_str());
+}
+
+static void checkStuckListener() {
+    std::string path = "/tmp/result_sinks_test_stuck.sock";
+    int listener = listenAt(path);
+    check(listener >= 0, "listener socket opens");
+
+    // Accepted but never read, so the socket buffer fills and send blocks
+    ResultPublisher publisher;
+    publisher.addSink(std::make_unique<SocketResultSink>(path));
+    publisher.publish(makeSnapshot(0));
+    int connection = accept(listener, nullptr, nullptr);
+    for (int i = 1; i <= 20000; i++) {
+        publisher.publish(makeSnapshot(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    publisher.stop();
+    double stopMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    check(stopMs < RESULT_STOP_TIMEOUT_MS + 250, "stop() returns soon after the timeout with a listener that stopped reading");
+    std::cout << "Stuck listener: stop() took " << stopMs << " ms\n";
+    close(connection);
+    close(listener);
+    unlink(path.c_str());
+}
+
+int main() {
+    checkQueuedDelivered();
+    checkStuckListener();
+
+    std::cout << (ok ? "All result sink checks passed\n" : "Result sink checks FAILED\n");
+    return ok ? 0 : 1;
+}
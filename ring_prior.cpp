@@ -0,0 +1,414 @@
+#define NOMINMAX
+#include "ring_prior.h"
+#include "stronghold_calculator.h"
+#include "number_format.h"
+#include "trace.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Strongholds per ring; the last ring holds what is left of the 128
+static const int RING_STRONGHOLDS[JAVA_RING_COUNT] = { 3, 6, 10, 15, 21, 28, 36, 9 };
+
+// Start angles averaged over, within one stronghold spacing, for a ring without a known stronghold
+const int JAVA_START_ANGLE_STEPS = 16;
+// Steps along the part of a ray inside one sector
+const int JAVA_RAY_STEPS = 4;
+
+struct RingIndex {
+    JavaRing rings[JAVA_RING_COUNT];
+    int firstSector[JAVA_RING_COUNT];
+    std::vector<RingSector> sectors;
+};
+
+// Bearing from the origin in degrees, 0 = -z and 90 = +x, in [0, 360)
+static double bearingDegrees(double x, double z) {
+    double bearing = std::atan2(x, -z) * 180.0 / M_PI;
+    return bearing < 0 ? bearing + 360.0 : bearing;
+}
+
+static void pointAtBearing(double bearing, double distance, double& x, double& z) {
+    double radians = bearing * M_PI / 180.0;
+    x = distance * std::sin(radians);
+    z = -distance * std::cos(radians);
+}
+
+static RingIndex buildRingIndex() {
+    RingIndex index;
+    for (int ring = 0; ring < JAVA_RING_COUNT; ring++) {
+        JavaRing& ringInfo = index.rings[ring];
+        ringInfo.strongholds = RING_STRONGHOLDS[ring];
+        ringInfo.minDistance = JAVA_FIRST_RING_MIN + ring * JAVA_RING_SPACING;
+        ringInfo.maxDistance = ringInfo.minDistance + JAVA_RING_WIDTH;
+        double middle = (ringInfo.minDistance + ringInfo.maxDistance) / 2.0;
+        ringInfo.sectors = (int)std::ceil(2.0 * M_PI * middle / JAVA_SECTOR_ARC);
+        index.firstSector[ring] = (int)index.sectors.size();
+
+        double width = 360.0 / ringInfo.sectors;
+        for (int sector = 0; sector < ringInfo.sectors; sector++) {
+            RingSector ringSector;
+            ringSector.ring = ring;
+            ringSector.sector = sector;
+            ringSector.minAngle = sector * width;
+            ringSector.maxAngle = (sector + 1) * width;
+
+            // Bounding box from the corners and the axis bearings inside the sector
+            StrongholdCell& cell = ringSector.cell;
+            cell.xMin = cell.zMin = std::numeric_limits<double>::max();
+            cell.xMax = cell.zMax = std::numeric_limits<double>::lowest();
+            auto extend = [&](double bearing) {
+                for (double distance : { ringInfo.minDistance, ringInfo.maxDistance }) {
+                    double x, z;
+                    pointAtBearing(bearing, distance, x, z);
+                    cell.xMin = std::min(cell.xMin, x);
+                    cell.xMax = std::max(cell.xMax, x);
+                    cell.zMin = std::min(cell.zMin, z);
+                    cell.zMax = std::max(cell.zMax, z);
+                }
+            };
+            extend(ringSector.minAngle);
+            extend(ringSector.maxAngle);
+            for (double axis = 90.0; axis < 360.0; axis += 90.0) {
+                if (axis > ringSector.minAngle && axis < ringSector.maxAngle) extend(axis);
+            }
+
+            pointAtBearing((ringSector.minAngle + ringSector.maxAngle) / 2.0, middle, cell.centerX, cell.centerZ);
+            cell.distance = middle;
+            cell.distanceRange = (int)std::round(middle / 100) * 100;
+            cell.prob = (double)ringInfo.strongholds / ringInfo.sectors;
+            index.sectors.push_back(ringSector);
+        }
+    }
+    return index;
+}
+
+static const RingIndex& ringIndex() {
+    static const RingIndex index = buildRingIndex();
+    return index;
+}
+
+const JavaRing& javaRing(int ring) {
+    return ringIndex().rings[ring];
+}
+
+int javaRingAt(double distanceFromOrigin) {
+    double offset = distanceFromOrigin - JAVA_FIRST_RING_MIN;
+    if (offset < 0) return -1;
+    int ring = (int)(offset / JAVA_RING_SPACING);
+    if (ring >= JAVA_RING_COUNT || offset - ring * JAVA_RING_SPACING > JAVA_RING_WIDTH) return -1;
+    return ring;
+}
+
+const RingSector& ringSectorAt(int ring, int sector) {
+    const RingIndex& index = ringIndex();
+    return index.sectors[index.firstSector[ring] + sector];
+}
+
+static int sectorAtBearing(const JavaRing& ring, double bearing) {
+    int sector = (int)(bearing / 360.0 * ring.sectors);
+    return std::max(0, std::min(ring.sectors - 1, sector));
+}
+
+const RingSector* ringSectorContaining(double x, double z) {
+    int ring = javaRingAt(std::sqrt(x * x + z * z));
+    if (ring < 0) return nullptr;
+    return &ringSectorAt(ring, sectorAtBearing(javaRing(ring), bearingDegrees(x, z)));
+}
+
+// Distance along the ray to the line from the origin at this bearing
+static double rayDistanceAtBearing(double startX, double startZ, double dx, double dz, double bearing) {
+    double unitX, unitZ;
+    pointAtBearing(bearing, 1.0, unitX, unitZ);
+    // (start + t * d) x unit = 0
+    double denominator = dx * unitZ - dz * unitX;
+    if (denominator == 0) return std::numeric_limits<double>::infinity();
+    return -(startX * unitZ - startZ * unitX) / denominator;
+}
+
+// Sectors of one ring between ray distances enter and exit, which stay inside the ring.
+// The bearing turns monotonically along a line and by less than 180 degrees within a ring.
+static void addRingHits(int ring, double startX, double startZ, double dx, double dz, double enter, double exit,
+    std::vector<RingSectorHit>& hits) {
+    const JavaRing& ringInfo = javaRing(ring);
+    double firstBearing = bearingDegrees(startX + enter * dx, startZ + enter * dz);
+    double lastBearing = bearingDegrees(startX + exit * dx, startZ + exit * dz);
+    int sector = sectorAtBearing(ringInfo, firstBearing);
+    int lastSector = sectorAtBearing(ringInfo, lastBearing);
+
+    double turn = lastBearing - firstBearing;
+    if (turn > 180.0) turn -= 360.0;
+    else if (turn < -180.0) turn += 360.0;
+    int step = turn >= 0 ? 1 : -1;
+    double width = 360.0 / ringInfo.sectors;
+
+    for (int visited = 0; sector != lastSector && visited < ringInfo.sectors; visited++) {
+        double boundary = (step > 0 ? sector + 1 : sector) * width;
+        double boundaryDistance = rayDistanceAtBearing(startX, startZ, dx, dz, boundary);
+        boundaryDistance = std::max(enter, std::min(exit, boundaryDistance));
+        if (boundaryDistance > enter) {
+            hits.push_back({ &ringSectorAt(ring, sector), enter, boundaryDistance });
+        }
+        enter = boundaryDistance;
+        sector = (sector + step + ringInfo.sectors) % ringInfo.sectors;
+    }
+    if (exit > enter) {
+        hits.push_back({ &ringSectorAt(ring, lastSector), enter, exit });
+    }
+}
+
+void ringSectorsAlongRay(double startX, double startZ, double dx, double dz, double maxDistance,
+    std::vector<RingSectorHit>& hits) {
+    hits.clear();
+    // |start + t * d|^2 = t^2 + 2bt + c for a unit direction
+    double b = startX * dx + startZ * dz;
+    double c = startX * startX + startZ * startZ;
+
+    for (int ring = 0; ring < JAVA_RING_COUNT; ring++) {
+        const JavaRing& ringInfo = javaRing(ring);
+        double outer = b * b - c + ringInfo.maxDistance * ringInfo.maxDistance;
+        if (outer <= 0) continue;
+        double outerNear = -b - std::sqrt(outer);
+        double outerFar = -b + std::sqrt(outer);
+
+        // Inside the outer circle, minus the part inside the inner circle
+        double spans[2][2] = { { outerNear, outerFar }, { 0.0, 0.0 } };
+        double inner = b * b - c + ringInfo.minDistance * ringInfo.minDistance;
+        if (inner > 0) {
+            spans[0][1] = -b - std::sqrt(inner);
+            spans[1][0] = -b + std::sqrt(inner);
+            spans[1][1] = outerFar;
+        }
+
+        for (auto& span : spans) {
+            double enter = std::max(0.0, span[0]);
+            double exit = std::min(maxDistance, span[1]);
+            if (exit > enter) addRingHits(ring, startX, startZ, dx, dz, enter, exit, hits);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(),
+        [](const RingSectorHit& a, const RingSectorHit& b) { return a.enter < b.enter; });
+}
+
+double javaStrongholdDensity(double distanceFromOrigin) {
+    int ring = javaRingAt(distanceFromOrigin);
+    if (ring < 0 || distanceFromOrigin <= 0) return 0.0;
+    // Uniform in distance across the ring; with a uniform start angle every bearing is equally likely
+    return javaRing(ring).strongholds / (2.0 * M_PI * distanceFromOrigin * JAVA_RING_WIDTH);
+}
+
+// Fraction of the ring's radial segment at this bearing within radius of the player, i.e. the
+// chance that a stronghold at this bearing lies closer than radius
+static double segmentFractionInDisc(const JavaRing& ring, double bearing, double playerX, double playerZ,
+    double radius) {
+    double unitX, unitZ;
+    pointAtBearing(bearing, 1.0, unitX, unitZ);
+    // |s * unit - player|^2 <= radius^2
+    double b = unitX * playerX + unitZ * playerZ;
+    double discriminant = b * b - (playerX * playerX + playerZ * playerZ - radius * radius);
+    if (discriminant <= 0) return 0.0;
+    double root = std::sqrt(discriminant);
+    double lo = std::max(ring.minDistance, b - root);
+    double hi = std::min(ring.maxDistance, b + root);
+    return hi > lo ? (hi - lo) / JAVA_RING_WIDTH : 0.0;
+}
+
+// Chance that none of the ring's strongholds, at startBearing plus multiples of the ring's
+// spacing, lies within radius of the player. skipStart leaves out the one at startBearing.
+static double ringClearProbability(const JavaRing& ring, double startBearing, bool skipStart,
+    double playerX, double playerZ, double radius) {
+    double spacing = 360.0 / ring.strongholds;
+    double playerDistance = std::sqrt(playerX * playerX + playerZ * playerZ);
+    int first = 0, last = ring.strongholds - 1;
+    if (radius < playerDistance) {
+        // Only the bearings the disc around the player covers, seen from the origin
+        double halfWidth = std::asin(radius / playerDistance) * 180.0 / M_PI;
+        double center = bearingDegrees(playerX, playerZ);
+        first = (int)std::ceil((center - halfWidth - startBearing) / spacing);
+        last = (int)std::floor((center + halfWidth - startBearing) / spacing);
+    }
+
+    double clear = 1.0;
+    for (int slot = first; slot <= last && clear > 0; slot++) {
+        if (skipStart && slot % ring.strongholds == 0) continue;
+        clear *= 1.0 - segmentFractionInDisc(ring, startBearing + slot * spacing, playerX, playerZ, radius);
+    }
+    return clear;
+}
+
+double javaNoCloserStrongholdProbability(double playerX, double playerZ, double x, double z, double radius) {
+    int strongholdRing = javaRingAt(std::sqrt(x * x + z * z));
+    if (strongholdRing < 0) return 0.0;
+    double playerDistance = std::sqrt(playerX * playerX + playerZ * playerZ);
+
+    double clear = 1.0;
+    for (int ring = 0; ring < JAVA_RING_COUNT && clear > 0; ring++) {
+        const JavaRing& ringInfo = javaRing(ring);
+        if (ring == strongholdRing) {
+            // The stronghold at (x, z) fixes where the rest of its ring sits
+            clear *= ringClearProbability(ringInfo, bearingDegrees(x, z), true, playerX, playerZ, radius);
+            continue;
+        }
+        if (playerDistance - radius >= ringInfo.maxDistance || playerDistance + radius <= ringInfo.minDistance) continue;
+        if (radius >= playerDistance + ringInfo.maxDistance) return 0.0;
+
+        // Average over the ring's random start angle within one spacing
+        double spacing = 360.0 / ringInfo.strongholds;
+        double ringClear = 0.0;
+        for (int i = 0; i < JAVA_START_ANGLE_STEPS; i++) {
+            double start = (i + 0.5) * spacing / JAVA_START_ANGLE_STEPS;
+            ringClear += ringClearProbability(ringInfo, start, false, playerX, playerZ, radius);
+        }
+        clear *= ringClear / JAVA_START_ANGLE_STEPS;
+    }
+    return clear;
+}
+
+void calculateStrongholdLocationJava(double playerX, double playerZ, double eyeAngle, double targetDistance,
+    const SolverConfig& config) {
+    TRACE_SPAN("solve java");
+    ScopedLatency latency(metrics.solveLatency);
+    strongholdCandidates.clear();
+    appState.distanceValidationFailed = false;
+    appState.validationErrorMessage = L"";
+
+    // Java eyes start flying from the player position itself
+    bool useTargetDistance = false;
+    if (appState.f4PressedFirst && appState.calculatedDistance > 0) {
+        useTargetDistance = true;
+        targetDistance = appState.calculatedDistance;
+    }
+
+    // Weight and weighted position sums per sector, found through the sector's slot
+    struct SectorAccumulator {
+        const RingSector* sector;
+        double prob;
+        double sumX, sumZ;
+    };
+    const RingIndex& index = ringIndex();
+    std::vector<SectorAccumulator> accumulators;
+    std::vector<int> sectorSlots(index.sectors.size(), -1);
+    auto accumulate = [&](const RingSector* sector, double prob, double x, double z) {
+        int& slot = sectorSlots[index.firstSector[sector->ring] + sector->sector];
+        if (slot < 0) {
+            slot = (int)accumulators.size();
+            accumulators.push_back({ sector, 0.0, 0.0, 0.0 });
+        }
+        SectorAccumulator& accumulator = accumulators[slot];
+        accumulator.prob += prob;
+        accumulator.sumX += prob * x;
+        accumulator.sumZ += prob * z;
+    };
+
+    // Likelihood that the eye points at a stronghold t blocks away at (x, z): the density
+    // there, the area element t, and the chance that no stronghold lies closer
+    auto nearestWeight = [&](double x, double z, double t) {
+        double density = javaStrongholdDensity(std::sqrt(x * x + z * z));
+        if (density <= 0) return 0.0;
+        return density * t * javaNoCloserStrongholdProbability(playerX, playerZ, x, z, t);
+    };
+
+    std::vector<double> angleSamples = generateAngleSamples(eyeAngle, config.angleSamples, config.angleStdDev);
+    std::vector<DistanceSample> distanceSamples;
+    if (useTargetDistance) {
+        if (appState.distanceLikelihood.isValid()) {
+            distanceSamples = appState.distanceLikelihood.samples(config.distanceSampleSpacing);
+        }
+        else {
+            distanceSamples = generateDistanceSamples(targetDistance, config.distanceSamples, config.f4DistanceStdDev);
+        }
+    }
+
+    std::vector<RingSectorHit> hits;
+    bool anySampleInRing = false;
+    for (double angleTest : angleSamples) {
+        double angleRad = angleTest * M_PI / 180.0;
+        double dx = std::sin(angleRad);
+        double dz = -std::cos(angleRad);
+        double angleWeight = gaussianProbability(angleTest, eyeAngle, config.angleStdDev);
+
+        if (useTargetDistance) {
+            // F4 case: each distance sample falls in at most one sector
+            for (const auto& distanceSample : distanceSamples) {
+                double x = playerX + distanceSample.distance * dx;
+                double z = playerZ + distanceSample.distance * dz;
+                const RingSector* sector = ringSectorContaining(x, z);
+                if (!sector) continue;
+                anySampleInRing = true;
+                accumulate(sector, angleWeight * distanceSample.weight * nearestWeight(x, z, distanceSample.distance), x, z);
+            }
+        }
+        else {
+            // Ray case: integrate along the part of the ray inside each sector it crosses
+            ringSectorsAlongRay(playerX, playerZ, dx, dz, config.maxRayDistance, hits);
+            if (!hits.empty()) anySampleInRing = true;
+            for (const auto& hit : hits) {
+                double step = (hit.exit - hit.enter) / JAVA_RAY_STEPS;
+                for (int i = 0; i < JAVA_RAY_STEPS; i++) {
+                    double t = hit.enter + (i + 0.5) * step;
+                    double x = playerX + t * dx;
+                    double z = playerZ + t * dz;
+                    accumulate(hit.sector, angleWeight * nearestWeight(x, z, t) * step, x, z);
+                }
+            }
+        }
+    }
+
+    // Sector order keeps equally likely candidates stable through the sort below
+    TRACE_SPAN("format candidates");
+    std::sort(accumulators.begin(), accumulators.end(),
+        [](const SectorAccumulator& a, const SectorAccumulator& b) { return a.sector < b.sector; });
+    double totalRawProb = 0.0;
+    for (const auto& accumulator : accumulators) {
+        if (accumulator.prob <= 0) continue;
+        const RingSector& sector = *accumulator.sector;
+        double avgX = accumulator.sumX / accumulator.prob;
+        double avgZ = accumulator.sumZ / accumulator.prob;
+
+        StrongholdCandidate candidate;
+        candidate.projectionX = (int)std::round(avgX);
+        candidate.projectionZ = (int)std::round(avgZ);
+        candidate.netherX = (int)std::round(avgX / 8.0);
+        candidate.netherZ = (int)std::round(avgZ / 8.0);
+        candidate.cellCenterX = sector.cell.centerX;
+        candidate.cellCenterZ = sector.cell.centerZ;
+        candidate.rawProb = accumulator.prob;
+        candidate.conditionalProb = 0.0;
+        candidate.distance = (int)std::round(std::sqrt((avgX - playerX) * (avgX - playerX) + (avgZ - playerZ) * (avgZ - playerZ)));
+        candidate.distanceFromOrigin = (int)std::round(std::sqrt(avgX * avgX + avgZ * avgZ));
+        candidate.distanceRange = sector.cell.distanceRange;
+
+        WideFormatBuffer text;
+        text.text(L"Ring ").integer(sector.ring + 1).text(L", bearing ").integer((int)std::floor(sector.minAngle))
+            .text(L" to ").integer((int)std::ceil(sector.maxAngle)).text(L" deg");
+        candidate.bounds = text.str();
+
+        totalRawProb += candidate.rawProb;
+        strongholdCandidates.push_back(candidate);
+    }
+
+    if (totalRawProb > 0) {
+        for (auto& candidate : strongholdCandidates) {
+            candidate.conditionalProb = candidate.rawProb / totalRawProb;
+        }
+    }
+
+    std::sort(strongholdCandidates.begin(), strongholdCandidates.end(),
+        [](const StrongholdCandidate& a, const StrongholdCandidate& b) {
+            return a.conditionalProb > b.conditionalProb;
+        });
+
+    // An F4 distance between the rings on every sampled bearing contradicts the throw,
+    // and so does a throw whose every sampled bearing misses the rings within range
+    if (!anySampleInRing) {
+        appState.distanceValidationFailed = true;
+        appState.validationErrorMessage = useTargetDistance ? F4_DISTANCE_MISMATCH_MESSAGE : JAVA_NO_RING_MESSAGE;
+    }
+
+    metrics.solves.add();
+    metrics.solveCandidates.record((double)strongholdCandidates.size());
+    if (appState.distanceValidationFailed) {
+        metrics.distanceValidationFailures.add();
+    }
+}
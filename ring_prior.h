@@ -0,0 +1,67 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "app_state.h"
+#include "solver_config.h"
+
+// Java Edition stronghold prior. Java places 128 strongholds on 8 rings around the
+// origin: the strongholds of a ring are evenly spaced in angle from a random start,
+// each at a uniformly random distance within the ring. Every ring is split into
+// angular sectors, indexed by (ring, sector), so a ray only visits the sectors it
+// passes through. The index is built once and never changes.
+
+const int JAVA_RING_COUNT = 8;
+const int JAVA_STRONGHOLD_COUNT = 128;
+const double JAVA_FIRST_RING_MIN = 1280.0;  // Inner edge of the first ring, biome shift included (blocks)
+const double JAVA_RING_WIDTH = 1536.0;      // Inner to outer edge of a ring (blocks)
+const double JAVA_RING_SPACING = 3072.0;    // Between the inner edges of neighbouring rings (blocks)
+const double JAVA_SECTOR_ARC = 512.0;       // Largest sector width along the middle of its ring (blocks)
+
+// Shown when no sampled bearing of a throw without F4 crosses a ring within maxRayDistance
+const wchar_t* const JAVA_NO_RING_MESSAGE =
+    L"No stronghold ring in this direction: the throw points away from every ring within range. Check the throw or throw again.";
+
+struct JavaRing {
+    int strongholds;
+    double minDistance, maxDistance;
+    int sectors;
+};
+
+struct RingSector {
+    StrongholdCell cell;        // Bounding box and center; prob is the expected number of strongholds
+    int ring, sector;
+    double minAngle, maxAngle;  // Bearing from the origin in degrees, 0 = -z, 90 = +x
+};
+
+struct RingSectorHit {
+    const RingSector* sector;
+    double enter, exit;         // Distances along the ray where it enters and leaves the sector
+};
+
+const JavaRing& javaRing(int ring);
+
+// Ring holding this distance from the origin, -1 inside the first ring, between rings and past the last
+int javaRingAt(double distanceFromOrigin);
+
+const RingSector& ringSectorAt(int ring, int sector);
+
+// Sector holding the point, nullptr outside every ring
+const RingSector* ringSectorContaining(double x, double z);
+
+// Sectors the ray crosses within maxDistance, in order along the ray
+void ringSectorsAlongRay(double startX, double startZ, double dx, double dz, double maxDistance,
+    std::vector<RingSectorHit>& hits);
+
+// Stronghold density (per square block) at this distance from the origin
+double javaStrongholdDensity(double distanceFromOrigin);
+
+// Chance that no stronghold lies within radius of the player, given one at (x, z). The
+// rest of that stronghold's ring sits at fixed bearings from it; every other ring is
+// averaged over its random start angle.
+double javaNoCloserStrongholdProbability(double playerX, double playerZ, double x, double z, double radius);
+
+// Java Edition counterpart of calculateStrongholdLocationWithDistance. The eye flies from
+// the player position towards the nearest stronghold, so every point along the throw is
+// weighted by the ring density and by the chance that no stronghold lies closer.
+void calculateStrongholdLocationJava(double playerX, double playerZ, double eyeAngle, double targetDistance,
+    const SolverConfig& config);
@@ -0,0 +1,201 @@
+#define NOMINMAX
+#include "route_planner.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+RoutePlan strongholdRoute;
+
+struct RoutePoint {
+    double x, z;
+    double prob;
+};
+
+// Cheaper of walking and a portal trip through the nether
+static double legCost(const RoutePoint& from, const RoutePoint& to, bool* viaNether) {
+    double overworld = std::sqrt((to.x - from.x) * (to.x - from.x) + (to.z - from.z) * (to.z - from.z));
+    double nether = overworld / NETHER_SCALE + PORTAL_OVERHEAD_BLOCKS;
+    if (viaNether) *viaNether = nether < overworld;
+    return std::min(overworld, nether);
+}
+
+// Every leg is paid by all the probability mass not yet visited
+static double expectedCost(const std::vector<int>& order, const std::vector<RoutePoint>& points,
+    const std::vector<double>& costs, int n) {
+    double remaining = 1.0;
+    double total = 0.0;
+    int previous = n; // Start point
+    for (int stop : order) {
+        total += remaining * costs[previous * (n + 1) + stop];
+        remaining -= points[stop].prob;
+        previous = stop;
+    }
+    return total;
+}
+
+// Visit next whichever stop has the most probability per block, then relocate
+// single stops while that lowers the expected cost
+static std::vector<int> heuristicOrder(const std::vector<RoutePoint>& points, const std::vector<double>& costs,
+    int n, std::chrono::steady_clock::time_point deadline) {
+    std::vector<int> order;
+    std::vector<bool> visited(n, false);
+    int previous = n;
+    for (int step = 0; step < n; step++) {
+        int best = -1;
+        double bestRatio = -1.0;
+        for (int i = 0; i < n; i++) {
+            if (visited[i]) continue;
+            double ratio = points[i].prob / std::max(1.0, costs[previous * (n + 1) + i]);
+            if (ratio > bestRatio) {
+                bestRatio = ratio;
+                best = i;
+            }
+        }
+        visited[best] = true;
+        order.push_back(best);
+        previous = best;
+    }
+
+    double bestCost = expectedCost(order, points, costs, n);
+    bool improved = true;
+    while (improved && std::chrono::steady_clock::now() < deadline) {
+        improved = false;
+        for (int from = 0; from < n; from++) {
+            for (int to = 0; to < n; to++) {
+                if (from == to) continue;
+                std::vector<int> moved = order;
+                int stop = moved[from];
+                moved.erase(moved.begin() + from);
+                moved.insert(moved.begin() + to, stop);
+                double cost = expectedCost(moved, points, costs, n);
+                if (cost < bestCost - 1e-9) {
+                    bestCost = cost;
+                    order = moved;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return order;
+}
+
+// Held-Karp over visited subsets: best[mask][last] is the lowest expected cost of
+// visiting mask and ending at last. Returns false if the deadline passed.
+static bool exactOrder(const std::vector<RoutePoint>& points, const std::vector<double>& costs,
+    int n, std::chrono::steady_clock::time_point deadline, std::vector<int>& order) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    int subsets = 1 << n;
+    std::vector<double> best((size_t)subsets * n, infinity);
+    std::vector<signed char> parent((size_t)subsets * n, -1);
+    std::vector<double> maskProb(subsets, 0.0);
+
+    for (int mask = 1; mask < subsets; mask++) {
+        int low = 0;
+        while (!(mask & (1 << low))) low++;
+        maskProb[mask] = maskProb[mask & (mask - 1)] + points[low].prob;
+    }
+    for (int i = 0; i < n; i++) {
+        best[(size_t)(1 << i) * n + i] = costs[n * (n + 1) + i];
+    }
+
+    for (int mask = 1; mask < subsets; mask++) {
+        if ((mask & 0xFF) == 0 && std::chrono::steady_clock::now() > deadline) return false;
+        double remaining = 1.0 - maskProb[mask];
+        for (int last = 0; last < n; last++) {
+            double current = best[(size_t)mask * n + last];
+            if (current == infinity) continue;
+            for (int next = 0; next < n; next++) {
+                if (mask & (1 << next)) continue;
+                int nextMask = mask | (1 << next);
+                double cost = current + remaining * costs[last * (n + 1) + next];
+                if (cost < best[(size_t)nextMask * n + next]) {
+                    best[(size_t)nextMask * n + next] = cost;
+                    parent[(size_t)nextMask * n + next] = (signed char)last;
+                }
+            }
+        }
+    }
+
+    int mask = subsets - 1;
+    int last = 0;
+    for (int i = 1; i < n; i++) {
+        if (best[(size_t)mask * n + i] < best[(size_t)mask * n + last]) last = i;
+    }
+    order.assign(n, 0);
+    for (int position = n - 1; position >= 0; position--) {
+        order[position] = last;
+        int previous = parent[(size_t)mask * n + last];
+        mask &= ~(1 << last);
+        last = previous;
+    }
+    return true;
+}
+
+RoutePlan planStrongholdRoute(double startX, double startZ,
+    const std::vector<StrongholdCandidate>& candidates, double budgetMs) {
+    TRACE_SPAN("plan route");
+    auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+
+    // Top candidates, renormalized so the stops share all the probability
+    std::vector<RoutePoint> points;
+    std::vector<int> candidateIndex;
+    double totalProb = 0.0;
+    for (int i = 0; i < (int)candidates.size() && (int)points.size() < ROUTE_MAX_STOPS; i++) {
+        if (candidates[i].conditionalProb < ROUTE_MIN_PROBABILITY) continue;
+        points.push_back({ (double)candidates[i].projectionX, (double)candidates[i].projectionZ, candidates[i].conditionalProb });
+        candidateIndex.push_back(i);
+        totalProb += candidates[i].conditionalProb;
+    }
+
+    RoutePlan plan;
+    int n = (int)points.size();
+    if (n == 0 || totalProb <= 0) return plan;
+    for (auto& point : points) {
+        point.prob /= totalProb;
+    }
+
+    // Leg costs between all stops; row n is the start point
+    points.push_back({ startX, startZ, 0.0 });
+    std::vector<double> costs((size_t)(n + 1) * (n + 1), 0.0);
+    std::vector<bool> viaNether((size_t)(n + 1) * (n + 1), false);
+    for (int from = 0; from <= n; from++) {
+        for (int to = 0; to < n; to++) {
+            bool nether = false;
+            costs[from * (n + 1) + to] = legCost(points[from], points[to], &nether);
+            viaNether[from * (n + 1) + to] = nether;
+        }
+    }
+
+    std::vector<int> order = heuristicOrder(points, costs, n, deadline);
+    if (n <= ROUTE_EXACT_MAX_STOPS) {
+        std::vector<int> optimal;
+        if (exactOrder(points, costs, n, deadline, optimal)) {
+            order = optimal;
+            plan.exact = true;
+        }
+    }
+
+    double found = 0.0;
+    int previous = n;
+    for (int stop : order) {
+        const auto& candidate = candidates[candidateIndex[stop]];
+        found += points[stop].prob;
+
+        RouteStop routeStop;
+        routeStop.candidateIndex = candidateIndex[stop];
+        routeStop.x = candidate.projectionX;
+        routeStop.z = candidate.projectionZ;
+        routeStop.netherX = candidate.netherX;
+        routeStop.netherZ = candidate.netherZ;
+        routeStop.viaNether = viaNether[previous * (n + 1) + stop];
+        routeStop.legCost = costs[previous * (n + 1) + stop];
+        routeStop.foundProb = found;
+        plan.stops.push_back(routeStop);
+        previous = stop;
+    }
+    plan.expectedCost = expectedCost(order, points, costs, n);
+    return plan;
+}
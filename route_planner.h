@@ -0,0 +1,41 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "app_state.h"
+
+// Visiting order for the most likely candidates that minimizes the expected
+// distance travelled before reaching the true stronghold. Each leg is walked in the
+// overworld or taken through the nether, whichever is cheaper.
+//
+// A nether leg builds its exit portal at the stop itself (RouteStop::netherX/Z).
+// Portal placement is not optimized: with these leg costs a shared hub portal H is
+// never cheaper, since |S - first| / 8 <= |S - H| / 8 + walk(H, first). Placement
+// only matters once portals are reused between legs, which this model leaves out.
+
+const int ROUTE_MAX_STOPS = 16;                 // Top-K candidates considered
+const int ROUTE_EXACT_MAX_STOPS = 12;           // Exact subset DP up to this many stops
+const double ROUTE_MIN_PROBABILITY = 0.005;     // Candidates below this are not visited
+const double ROUTE_PLANNER_BUDGET_MS = 5.0;     // Latency budget per plan
+const double NETHER_SCALE = 8.0;                // Overworld blocks per nether block
+const double PORTAL_OVERHEAD_BLOCKS = 100.0;    // Overworld-equivalent cost of building and using a portal pair
+
+struct RouteStop {
+    int candidateIndex;     // Index into the candidate list
+    int x, z;               // Overworld destination
+    int netherX, netherZ;   // Exit portal position in the nether
+    bool viaNether;         // Leg is travelled through the nether
+    double legCost;         // Overworld-equivalent blocks from the previous stop
+    double foundProb;       // Probability the stronghold has been reached after this stop
+};
+
+struct RoutePlan {
+    std::vector<RouteStop> stops;
+    double expectedCost = 0.0;  // Expected blocks travelled, given the stronghold is one of the stops
+    bool exact = false;         // Order is optimal (subset DP finished within the budget)
+};
+
+RoutePlan planStrongholdRoute(double startX, double startZ,
+    const std::vector<StrongholdCandidate>& candidates, double budgetMs = ROUTE_PLANNER_BUDGET_MS);
+
+// Route for the current strongholdCandidates
+extern RoutePlan strongholdRoute;
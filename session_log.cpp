@@ -0,0 +1,588 @@
+#define NOMINMAX
+#include "session_log.h"
+#include "metrics.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <set>
+
+// Byte offsets within the record header
+const size_t RECORD_LENGTH_OFFSET = 20;
+const size_t RECORD_CRC_OFFSET = 24;
+
+static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    // Built once under the function-static initialization guard, so encoding on the
+    // capture worker and decoding on another thread can both use it
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            result[i] = value;
+        }
+        return result;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void put64(std::vector<uint8_t>& out, uint64_t value) {
+    put32(out, (uint32_t)value);
+    put32(out, (uint32_t)(value >> 32));
+}
+
+static void putDouble(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put64(out, bits);
+}
+
+static void putVec3(std::vector<uint8_t>& out, const Vec3& value) {
+    put32(out, (uint32_t)value.x);
+    put32(out, (uint32_t)value.y);
+    put32(out, (uint32_t)value.z);
+}
+
+static void set32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+// Bounds-checked reader over a record or index
+struct LogReader {
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    bool ok = true;
+
+    uint8_t get8() {
+        if (offset + 1 > size) {
+            ok = false;
+            return 0;
+        }
+        return data[offset++];
+    }
+    uint32_t get32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= (uint32_t)get8() << (8 * i);
+        }
+        return value;
+    }
+    uint64_t get64() {
+        uint64_t value = get32();
+        return value | (uint64_t)get32() << 32;
+    }
+    double getDouble() {
+        uint64_t bits = get64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    Vec3 getVec3() {
+        Vec3 value;
+        value.x = (int32_t)get32();
+        value.y = (int32_t)get32();
+        value.z = (int32_t)get32();
+        return value;
+    }
+};
+
+int64_t sessionWallClockMs() {
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+}
+
+// Header: magic, kind, session, wall time, payload length, then the CRC-32 of the
+// header before it and of the payload
+std::vector<uint8_t> encodeSessionRecord(const SessionRecord& record) {
+    std::vector<uint8_t> out;
+    put32(out, SESSION_RECORD_MAGIC);
+    put32(out, (uint32_t)record.kind);
+    put32(out, record.session);
+    put64(out, (uint64_t)record.wallTimeMs);
+    put32(out, 0);  // Payload length
+    put32(out, 0);  // CRC
+
+    switch (record.kind) {
+    case SESSION_RECORD_START:
+        out.push_back((uint8_t)record.config.edition);
+        out.push_back((uint8_t)record.solverMode);
+        putDouble(out, record.config.angleStdDev);
+        out.push_back((uint8_t)record.config.angleSamples);
+        putDouble(out, record.config.f4DistanceStdDev);
+        out.push_back((uint8_t)record.config.distanceSamples);
+        putDouble(out, record.config.distanceSampleSpacing);
+        putDouble(out, record.config.f4CellMargin);
+        putDouble(out, record.config.maxRayDistance);
+        break;
+    case SESSION_RECORD_CAPTURE:
+        out.push_back((uint8_t)record.keyType);
+        putDouble(out, record.keyTimeMs);
+        break;
+    case SESSION_RECORD_DECODE:
+        out.push_back(record.coordsRead ? 1 : 0);
+        putVec3(out, record.coords);
+        break;
+    case SESSION_RECORD_SOLVE: {
+        putVec3(out, record.coord1);
+        putVec3(out, record.coord2);
+        putDouble(out, record.angle);
+        putDouble(out, record.calculatedDistance);
+        size_t presses = std::min<size_t>(record.distancePressTimesMs.size(), 255);
+        out.push_back((uint8_t)presses);
+        for (size_t i = 0; i < presses; i++) {
+            putDouble(out, record.distancePressTimesMs[i]);
+        }
+        size_t rows = std::min<size_t>(record.candidates.size(), SESSION_LOG_CANDIDATES);
+        out.push_back((uint8_t)rows);
+        for (size_t i = 0; i < rows; i++) {
+            const ResultRow& row = record.candidates[i];
+            put32(out, (uint32_t)row.projectionX);
+            put32(out, (uint32_t)row.projectionZ);
+            put32(out, (uint32_t)row.netherX);
+            put32(out, (uint32_t)row.netherZ);
+            putDouble(out, row.conditionalProb);
+        }
+        break;
+    }
+    case SESSION_RECORD_OUTCOME:
+        putDouble(out, record.outcomeX);
+        putDouble(out, record.outcomeZ);
+        break;
+    }
+
+    set32(out, RECORD_LENGTH_OFFSET, (uint32_t)(out.size() - SESSION_RECORD_HEADER_BYTES));
+    uint32_t crc = crc32(out.data(), RECORD_CRC_OFFSET);
+    crc = crc32(out.data() + SESSION_RECORD_HEADER_BYTES, out.size() - SESSION_RECORD_HEADER_BYTES, crc);
+    set32(out, RECORD_CRC_OFFSET, crc);
+    return out;
+}
+
+size_t decodeSessionRecord(const uint8_t* data, size_t size, SessionRecord& record) {
+    LogReader header = { data, std::min(size, SESSION_RECORD_HEADER_BYTES) };
+    if (header.get32() != SESSION_RECORD_MAGIC) return 0;
+    uint32_t kind = header.get32();
+    record = SessionRecord();
+    record.kind = (SessionRecordKind)kind;
+    record.session = header.get32();
+    record.wallTimeMs = (int64_t)header.get64();
+    uint32_t length = header.get32();
+    uint32_t crc = header.get32();
+    if (!header.ok || length > SESSION_LOG_MAX_PAYLOAD || size - SESSION_RECORD_HEADER_BYTES < length) return 0;
+    if (kind < SESSION_RECORD_START || kind > SESSION_RECORD_OUTCOME) return 0;
+
+    uint32_t actualCrc = crc32(data, RECORD_CRC_OFFSET);
+    actualCrc = crc32(data + SESSION_RECORD_HEADER_BYTES, length, actualCrc);
+    if (actualCrc != crc) return 0;
+
+    LogReader payload = { data + SESSION_RECORD_HEADER_BYTES, length };
+    switch (record.kind) {
+    case SESSION_RECORD_START:
+        record.config.edition = payload.get8();
+        record.solverMode = payload.get8();
+        record.config.angleStdDev = payload.getDouble();
+        // Older logs stop here; their other settings read as the defaults
+        if (payload.offset < length) {
+            record.config.angleSamples = payload.get8();
+            record.config.f4DistanceStdDev = payload.getDouble();
+            record.config.distanceSamples = payload.get8();
+            record.config.distanceSampleSpacing = payload.getDouble();
+            record.config.f4CellMargin = payload.getDouble();
+            record.config.maxRayDistance = payload.getDouble();
+        }
+        break;
+    case SESSION_RECORD_CAPTURE:
+        record.keyType = (CaptureEventType)payload.get8();
+        record.keyTimeMs = payload.getDouble();
+        break;
+    case SESSION_RECORD_DECODE:
+        record.coordsRead = payload.get8() != 0;
+        record.coords = payload.getVec3();
+        break;
+    case SESSION_RECORD_SOLVE: {
+        record.coord1 = payload.getVec3();
+        record.coord2 = payload.getVec3();
+        record.angle = payload.getDouble();
+        record.calculatedDistance = payload.getDouble();
+        int presses = payload.get8();
+        for (int i = 0; i < presses && payload.ok; i++) {
+            record.distancePressTimesMs.push_back(payload.getDouble());
+        }
+        int rows = payload.get8();
+        for (int i = 0; i < rows && payload.ok; i++) {
+            ResultRow row;
+            row.projectionX = (int32_t)payload.get32();
+            row.projectionZ = (int32_t)payload.get32();
+            row.netherX = (int32_t)payload.get32();
+            row.netherZ = (int32_t)payload.get32();
+            row.conditionalProb = payload.getDouble();
+            record.candidates.push_back(row);
+        }
+        break;
+    }
+    case SESSION_RECORD_OUTCOME:
+        record.outcomeX = payload.getDouble();
+        record.outcomeZ = payload.getDouble();
+        break;
+    }
+    if (!payload.ok || payload.offset != length) return 0;
+    return SESSION_RECORD_HEADER_BYTES + length;
+}
+
+static std::filesystem::path indexPathFor(const std::filesystem::path& path) {
+    std::filesystem::path indexPath = path;
+    indexPath += ".idx";
+    return indexPath;
+}
+
+static std::vector<uint8_t> readFileBytes(std::ifstream& file, uint64_t offset, uint64_t count) {
+    std::vector<uint8_t> bytes((size_t)count);
+    file.clear();
+    file.seekg((std::streamoff)offset);
+    file.read((char*)bytes.data(), (std::streamsize)count);
+    bytes.resize((size_t)file.gcount());
+    return bytes;
+}
+
+static void encodeIndexEntry(std::vector<uint8_t>& out, const SessionIndexEntry& entry) {
+    put32(out, entry.session);
+    put32(out, entry.records);
+    put64(out, entry.offset);
+    put64(out, entry.bytes);
+    put64(out, (uint64_t)entry.firstTimeMs);
+    put64(out, (uint64_t)entry.lastTimeMs);
+}
+
+// Add a record to the open block, or start a new one when the block is full or the session changed
+static void indexRecord(std::vector<SessionIndexEntry>& entries, uint32_t session, uint64_t offset, uint64_t bytes,
+    int64_t wallTimeMs, bool newBlock) {
+    if (newBlock || entries.empty() || entries.back().session != session
+        || entries.back().records >= (uint32_t)SESSION_INDEX_BLOCK_RECORDS) {
+        entries.push_back({ session, 0, offset, 0, wallTimeMs, wallTimeMs });
+    }
+    SessionIndexEntry& entry = entries.back();
+    entry.records++;
+    entry.bytes += bytes;
+    entry.firstTimeMs = std::min(entry.firstTimeMs, wallTimeMs);
+    entry.lastTimeMs = std::max(entry.lastTimeMs, wallTimeMs);
+}
+
+bool SessionLogReader::open(const std::filesystem::path& path) {
+    entries.clear();
+    valid = indexedBytes = 0;
+    file.close();
+    file.clear();
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::error_code error;
+    uint64_t fileBytes = std::filesystem::file_size(path, error);
+    if (error) return false;
+
+    // Index entries must tile the log from the start; a torn or stale tail is ignored
+    std::ifstream indexFile(indexPathFor(path), std::ios::binary);
+    if (indexFile.is_open()) {
+        std::vector<uint8_t> index((std::istreambuf_iterator<char>(indexFile)), std::istreambuf_iterator<char>());
+        LogReader reader = { index.data(), index.size() };
+        if (reader.get32() == SESSION_INDEX_MAGIC) {
+            while (reader.ok && reader.size - reader.offset >= SESSION_INDEX_ENTRY_BYTES) {
+                SessionIndexEntry entry;
+                entry.session = reader.get32();
+                entry.records = reader.get32();
+                entry.offset = reader.get64();
+                entry.bytes = reader.get64();
+                entry.firstTimeMs = (int64_t)reader.get64();
+                entry.lastTimeMs = (int64_t)reader.get64();
+                if (entry.offset != indexedBytes || entry.bytes > fileBytes - indexedBytes || entry.records == 0) break;
+                entries.push_back(entry);
+                indexedBytes += entry.bytes;
+            }
+        }
+    }
+
+    // Index the records past the index, up to the first torn or corrupt one
+    std::vector<uint8_t> tail = readFileBytes(file, indexedBytes, fileBytes - indexedBytes);
+    size_t offset = 0;
+    bool firstTailRecord = true;
+    SessionRecord record;
+    while (size_t recordBytes = decodeSessionRecord(tail.data() + offset, tail.size() - offset, record)) {
+        indexRecord(entries, record.session, indexedBytes + offset, recordBytes, record.wallTimeMs, firstTailRecord);
+        firstTailRecord = false;
+        offset += recordBytes;
+    }
+    valid = indexedBytes + offset;
+    return true;
+}
+
+std::vector<SessionSummary> SessionLogReader::sessions() const {
+    std::vector<SessionSummary> result;
+    for (const auto& entry : entries) {
+        auto found = std::find_if(result.begin(), result.end(),
+            [&](const SessionSummary& summary) { return summary.session == entry.session; });
+        if (found == result.end()) {
+            result.push_back({ entry.session, entry.records, entry.bytes, entry.firstTimeMs, entry.lastTimeMs });
+            continue;
+        }
+        found->records += entry.records;
+        found->bytes += entry.bytes;
+        found->firstTimeMs = std::min(found->firstTimeMs, entry.firstTimeMs);
+        found->lastTimeMs = std::max(found->lastTimeMs, entry.lastTimeMs);
+    }
+    return result;
+}
+
+void SessionLogReader::readEntry(const SessionIndexEntry& entry, std::vector<SessionRecord>& records) {
+    std::vector<uint8_t> bytes = readFileBytes(file, entry.offset, entry.bytes);
+    size_t offset = 0;
+    SessionRecord record;
+    while (size_t recordBytes = decodeSessionRecord(bytes.data() + offset, bytes.size() - offset, record)) {
+        records.push_back(record);
+        offset += recordBytes;
+    }
+}
+
+std::vector<SessionRecord> SessionLogReader::readSession(uint32_t session) {
+    std::vector<SessionRecord> records;
+    for (const auto& entry : entries) {
+        if (entry.session == session) readEntry(entry, records);
+    }
+    return records;
+}
+
+std::vector<SessionRecord> SessionLogReader::readTimeRange(int64_t fromMs, int64_t toMs) {
+    std::vector<SessionRecord> records;
+    for (const auto& entry : entries) {
+        if (entry.lastTimeMs < fromMs || entry.firstTimeMs > toMs) continue;
+        std::vector<SessionRecord> block;
+        readEntry(entry, block);
+        for (const auto& record : block) {
+            if (record.wallTimeMs >= fromMs && record.wallTimeMs <= toMs) records.push_back(record);
+        }
+    }
+    return records;
+}
+
+static bool writeIndexFile(const std::filesystem::path& path, const std::vector<SessionIndexEntry>& entries) {
+    std::vector<uint8_t> bytes;
+    put32(bytes, SESSION_INDEX_MAGIC);
+    for (const auto& entry : entries) {
+        encodeIndexEntry(bytes, entry);
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    return (bool)file.flush();
+}
+
+bool compactSessionLog(const std::filesystem::path& path, int64_t keepFromMs, uintmax_t keepBytes) {
+    // The reader is closed before the log is replaced
+    std::vector<SessionIndexEntry> index;
+    std::vector<SessionSummary> sessions;
+    {
+        SessionLogReader reader;
+        if (!reader.open(path)) return false;
+        index = reader.index();
+        sessions = reader.sessions();
+    }
+
+    // Newest sessions first until the size budget is spent; the newest one is always kept
+    std::sort(sessions.begin(), sessions.end(),
+        [](const SessionSummary& a, const SessionSummary& b) { return a.lastTimeMs > b.lastTimeMs; });
+    std::set<uint32_t> kept;
+    uintmax_t keptBytes = 0;
+    for (const auto& summary : sessions) {
+        if (!kept.empty() && (summary.lastTimeMs < keepFromMs || keptBytes + summary.bytes > keepBytes)) break;
+        kept.insert(summary.session);
+        keptBytes += summary.bytes;
+    }
+
+    std::filesystem::path compactPath = path;
+    compactPath += ".tmp";
+    std::filesystem::path compactIndexPath = indexPathFor(compactPath);
+    std::vector<SessionIndexEntry> entries;
+    {
+        std::ifstream source(path, std::ios::binary);
+        std::ofstream target(compactPath, std::ios::binary | std::ios::trunc);
+        if (!source.is_open() || !target.is_open()) return false;
+        uint64_t offset = 0;
+        for (SessionIndexEntry entry : index) {
+            if (!kept.count(entry.session)) continue;
+            std::vector<uint8_t> bytes = readFileBytes(source, entry.offset, entry.bytes);
+            if (bytes.size() != entry.bytes) return false;
+            target.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+            entry.offset = offset;
+            offset += entry.bytes;
+            entries.push_back(entry);
+        }
+        if (!target.flush()) return false;
+    }
+    if (!writeIndexFile(compactIndexPath, entries)) return false;
+
+    // Without an index the log is indexed from scratch, so a crash between the renames loses nothing
+    std::error_code error;
+    std::filesystem::remove(indexPathFor(path), error);
+    std::filesystem::rename(compactPath, path, error);
+    if (error) return false;
+    std::filesystem::rename(compactIndexPath, indexPathFor(path), error);
+    return !error;
+}
+
+bool SessionLogWriter::open(const std::filesystem::path& path) {
+    stop();
+    logPath = path;
+    indexPath = indexPathFor(path);
+
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) > SESSION_LOG_COMPACT_BYTES && !error) {
+        compactSessionLog(path, sessionWallClockMs() - SESSION_LOG_KEEP_MS, SESSION_LOG_KEEP_BYTES);
+    }
+
+    // Cut a torn tail and index records the index file missed
+    SessionLogReader reader;
+    logBytes = 0;
+    currentSession = 1;
+    if (reader.open(path)) {
+        logBytes = reader.validBytes();
+        for (const auto& entry : reader.index()) {
+            currentSession = std::max(currentSession, entry.session + 1);
+        }
+        bool complete = reader.indexComplete();
+        std::vector<SessionIndexEntry> entries = reader.index();
+        reader = SessionLogReader();
+        if (std::filesystem::file_size(path, error) != logBytes) {
+            std::filesystem::resize_file(path, logBytes, error);
+            if (error) return false;
+        }
+        if (!complete && !writeIndexFile(indexPath, entries)) return false;
+    }
+    else if (!writeIndexFile(indexPath, {})) {
+        return false;
+    }
+
+    log.open(path, std::ios::binary | std::ios::app);
+    indexFile.open(indexPath, std::ios::binary | std::ios::app);
+    if (!log.is_open() || !indexFile.is_open()) return false;
+    block = { currentSession, 0, logBytes, 0, 0, 0 };
+
+    stopping = false;
+    writer = std::thread(&SessionLogWriter::run, this);
+    return true;
+}
+
+void SessionLogWriter::append(SessionRecord record) {
+    record.session = currentSession;
+    record.wallTimeMs = sessionWallClockMs();
+    QueuedRecord queued = { encodeSessionRecord(record), record.wallTimeMs };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!writer.joinable()) return;
+        if (queue.size() >= SESSION_LOG_QUEUE_LIMIT) {
+            metrics.sessionRecordsDropped.add();
+            return;
+        }
+        queue.push_back(std::move(queued));
+    }
+    wake.notify_one();
+}
+
+void SessionLogWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (writer.joinable()) writer.join();
+    if (log.is_open()) {
+        if (block.records > 0) indexBlock();
+        log.close();
+        indexFile.close();
+    }
+}
+
+void SessionLogWriter::indexBlock() {
+    std::vector<uint8_t> bytes;
+    encodeIndexEntry(bytes, block);
+    indexFile.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    indexFile.flush();
+    block = { currentSession, 0, logBytes, 0, 0, 0 };
+}
+
+void SessionLogWriter::run() {
+    while (true) {
+        std::deque<QueuedRecord> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) break;
+            batch.swap(queue);
+        }
+
+        // Blocks are indexed only once their records are flushed, so the index never
+        // points past what reached the file
+        for (const auto& queued : batch) {
+            log.write((const char*)queued.bytes.data(), (std::streamsize)queued.bytes.size());
+            if (block.records == 0) block.firstTimeMs = queued.wallTimeMs;
+            block.lastTimeMs = queued.wallTimeMs;
+            block.records++;
+            block.bytes += queued.bytes.size();
+            logBytes += queued.bytes.size();
+            if (block.records >= (uint32_t)SESSION_INDEX_BLOCK_RECORDS) {
+                log.flush();
+                indexBlock();
+            }
+        }
+        log.flush();
+    }
+}
+
+std::vector<CaptureEvent> sessionCaptureEvents(const std::vector<SessionRecord>& records) {
+    std::vector<CaptureEvent> events;
+    for (const auto& record : records) {
+        if (record.kind == SESSION_RECORD_CAPTURE) {
+            events.push_back({ record.keyType, record.keyTimeMs, false, { 0, 0, 0 } });
+        }
+        else if (record.kind == SESSION_RECORD_DECODE && !events.empty()
+            && events.back().type == CAPTURE_EVENT_DIRECTION_KEY) {
+            events.back().coordsRead = record.coordsRead;
+            events.back().coords = record.coords;
+        }
+    }
+    return events;
+}
+
+SessionRecord makeSessionStartRecord(const SolverConfig& config, int solverMode) {
+    SessionRecord record;
+    record.kind = SESSION_RECORD_START;
+    record.solverMode = solverMode;
+    record.config = config;
+    return record;
+}
+
+SessionRecord makeSessionSolveRecord(const ApplicationState& state, const std::vector<StrongholdCandidate>& candidates) {
+    SessionRecord record;
+    record.kind = SESSION_RECORD_SOLVE;
+    record.coord1 = state.coord1;
+    record.coord2 = state.coord2;
+    record.angle = state.lastAngle;
+    record.calculatedDistance = state.f4PressedFirst ? state.calculatedDistance : 0.0;
+    record.distancePressTimesMs = state.distanceKeyPressTimesMs;
+    for (size_t i = 0; i < candidates.size() && i < (size_t)SESSION_LOG_CANDIDATES; i++) {
+        const StrongholdCandidate& candidate = candidates[i];
+        record.candidates.push_back({ candidate.projectionX, candidate.projectionZ,
+            candidate.netherX, candidate.netherZ, candidate.conditionalProb });
+    }
+    return record;
+}
@@ -0,0 +1,172 @@
+#pragma once
+#define NOMINMAX
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "capture_state_machine.h"
+#include "result_sinks.h"
+#include "solver_config.h"
+
+// Append-only binary log of every capture, HUD decode, solve and outcome, kept
+// across runs as the source data for replay and calibration. Records are written
+// little-endian, each with its own length and CRC-32, so a torn write at the end of
+// the file is detected and cut off the next time the log is opened. A sidecar index
+// (<log>.idx) lists blocks of consecutive records of one session with their time
+// range and file offset; queries read only the blocks they need. The index is only
+// a cache: whatever it does not cover is rebuilt from the log itself.
+
+const uint32_t SESSION_RECORD_MAGIC = 0x31524c53;   // "SLR1"
+const uint32_t SESSION_INDEX_MAGIC = 0x31494c53;    // "SLI1"
+const size_t SESSION_RECORD_HEADER_BYTES = 28;
+const size_t SESSION_INDEX_ENTRY_BYTES = 40;
+const int SESSION_INDEX_BLOCK_RECORDS = 64;         // Records per index block at most
+const size_t SESSION_LOG_QUEUE_LIMIT = 1024;        // Records queued for the writer; the newest are dropped past this
+const uint32_t SESSION_LOG_MAX_PAYLOAD = 1 << 16;   // Larger lengths mark a corrupt record
+const int SESSION_LOG_CANDIDATES = 10;              // Candidates kept per solve
+const uintmax_t SESSION_LOG_COMPACT_BYTES = 16u << 20;  // The log is compacted on open past this size
+const uintmax_t SESSION_LOG_KEEP_BYTES = 8u << 20;      // Compaction keeps the newest sessions up to this size
+const int64_t SESSION_LOG_KEEP_MS = 90ll * 24 * 60 * 60 * 1000; // Sessions older than this are dropped by compaction
+
+enum SessionRecordKind {
+    SESSION_RECORD_START = 1,   // Solver settings, first in a session and after every reload
+    SESSION_RECORD_CAPTURE,     // Key press
+    SESSION_RECORD_DECODE,      // HUD coordinates read for a direction key
+    SESSION_RECORD_SOLVE,       // Throw and the candidates it produced
+    SESSION_RECORD_OUTCOME      // Player position at the confirm key, pressed at the stronghold
+};
+
+struct SessionRecord {
+    SessionRecordKind kind = SESSION_RECORD_START;
+    uint32_t session = 0;
+    int64_t wallTimeMs = 0;         // System clock, milliseconds since 1970
+
+    // START
+    int solverMode = 0;             // SolverMode
+    SolverConfig config;            // Only the [Solver] values are logged
+
+    // CAPTURE
+    CaptureEventType keyType = CAPTURE_EVENT_DIRECTION_KEY;
+    double keyTimeMs = 0.0;         // captureClockMs time of the press
+
+    // DECODE
+    bool coordsRead = false;
+    Vec3 coords = { 0, 0, 0 };
+
+    // SOLVE
+    Vec3 coord1 = { 0, 0, 0 }, coord2 = { 0, 0, 0 };
+    double angle = 0.0;
+    double calculatedDistance = 0.0;    // 0 without F4
+    std::vector<double> distancePressTimesMs;
+    std::vector<ResultRow> candidates;  // Most likely first, at most SESSION_LOG_CANDIDATES
+
+    // OUTCOME
+    double outcomeX = 0.0, outcomeZ = 0.0;
+};
+
+// Blocks of records of one session, in file order
+struct SessionIndexEntry {
+    uint32_t session;
+    uint32_t records;
+    uint64_t offset, bytes;
+    int64_t firstTimeMs, lastTimeMs;
+};
+
+struct SessionSummary {
+    uint32_t session;
+    uint32_t records;
+    uint64_t bytes;
+    int64_t firstTimeMs, lastTimeMs;
+};
+
+int64_t sessionWallClockMs();
+
+// Record encoding, including the header and CRC
+std::vector<uint8_t> encodeSessionRecord(const SessionRecord& record);
+// Decode the record at data; returns its size, 0 for a torn or corrupt record
+size_t decodeSessionRecord(const uint8_t* data, size_t size, SessionRecord& record);
+
+// Read-only view of a log and its index
+class SessionLogReader {
+public:
+    // False if the log cannot be read. Records past the index are indexed in memory.
+    bool open(const std::filesystem::path& path);
+
+    const std::vector<SessionIndexEntry>& index() const { return entries; }
+    std::vector<SessionSummary> sessions() const;
+
+    std::vector<SessionRecord> readSession(uint32_t session);
+    // Records with fromMs <= wallTimeMs <= toMs
+    std::vector<SessionRecord> readTimeRange(int64_t fromMs, int64_t toMs);
+
+    // Bytes of the log that hold valid records, and whether the index file covers them all
+    uint64_t validBytes() const { return valid; }
+    bool indexComplete() const { return indexedBytes == valid; }
+
+private:
+    void readEntry(const SessionIndexEntry& entry, std::vector<SessionRecord>& records);
+
+    std::ifstream file;
+    std::vector<SessionIndexEntry> entries;
+    uint64_t valid = 0;
+    uint64_t indexedBytes = 0;  // Bytes covered by the index file
+};
+
+// Keep the sessions that ended at or after keepFromMs, newest first up to keepBytes;
+// the log and index are rewritten beside the originals and renamed over them
+bool compactSessionLog(const std::filesystem::path& path, int64_t keepFromMs, uintmax_t keepBytes);
+
+// Appends records on its own thread, so the capture worker only encodes and queues.
+// Opening cuts a torn tail, brings the index up to date, compacts an oversized log
+// and starts a new session; its first record should be a START record.
+class SessionLogWriter {
+public:
+    SessionLogWriter() {}
+    ~SessionLogWriter() { stop(); }
+    SessionLogWriter(const SessionLogWriter&) = delete;
+    SessionLogWriter& operator=(const SessionLogWriter&) = delete;
+
+    bool open(const std::filesystem::path& path);
+    bool isOpen() const { return writer.joinable(); }
+    uint32_t session() const { return currentSession; }
+
+    // Stamp the record with the session and time and queue it; never blocks on the disk
+    void append(SessionRecord record);
+
+    // Write what is queued, index the last block and join the writer
+    void stop();
+
+private:
+    void run();
+    void indexBlock();          // Append block to the index and start the next one
+
+    std::filesystem::path logPath, indexPath;
+    std::ofstream log, indexFile;
+    uint32_t currentSession = 0;
+    uint64_t logBytes = 0;
+    SessionIndexEntry block = {};   // Block being written, indexed once full
+
+    struct QueuedRecord {
+        std::vector<uint8_t> bytes;
+        int64_t wallTimeMs;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<QueuedRecord> queue;
+    bool stopping = false;
+    std::thread writer;
+};
+
+// Direction and distance presses of a session in capture log order, for replayCaptureLog
+std::vector<CaptureEvent> sessionCaptureEvents(const std::vector<SessionRecord>& records);
+
+// Settings record for a new session or a config reload
+SessionRecord makeSessionStartRecord(const SolverConfig& config, int solverMode);
+
+// Solve record for the current appState and strongholdCandidates
+SessionRecord makeSessionSolveRecord(const ApplicationState& state, const std::vector<StrongholdCandidate>& candidates);
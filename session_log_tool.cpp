@@ -0,0 +1,186 @@
+// Queries, exports and compacts a session_log.bin written by the GUI.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread session_log_tool.cpp session_log.cpp capture_state_machine.cpp
+//       stronghold_calculator.cpp fixed_point_solver.cpp first_throw_table.cpp cell_lattice.cpp ring_prior.cpp
+//       distance_estimator.cpp solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o session_log
+// Commands:
+//   list <log>                          sessions with their time range and record count
+//   dump <log> <session>                every record of a session
+//   range <log> <fromMs> <toMs>         records by wall-clock time (ms since 1970)
+//   export <log> <session>              the session's key presses as a capture_log.txt for capture_replay
+//   config <log> <session>              the session's last [Solver] settings, for capture_replay --config
+//   compact <log> [days] [megabytes]    drop old sessions, keep the newest up to the size
+//   bench <log> <records>               cost of appending solve records
+#define NOMINMAX
+#include "session_log.h"
+#include "number_format.h"
+#include "metrics.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Application state (defined by main.cpp in the GUI build)
+ApplicationState appState;
+
+static const char* kindName(SessionRecordKind kind) {
+    switch (kind) {
+    case SESSION_RECORD_START: return "start";
+    case SESSION_RECORD_CAPTURE: return "capture";
+    case SESSION_RECORD_DECODE: return "decode";
+    case SESSION_RECORD_SOLVE: return "solve";
+    case SESSION_RECORD_OUTCOME: return "outcome";
+    }
+    return "?";
+}
+
+static void printRecord(const SessionRecord& record) {
+    NarrowFormatBuffer line;
+    line.text("#").integer(record.session).text(" ").integer(record.wallTimeMs).text(" ").text(kindName(record.kind));
+    switch (record.kind) {
+    case SESSION_RECORD_START:
+        line.text(" edition=").integer(record.config.edition).text(" mode=").integer(record.solverMode)
+            .text(" angleStdDev=").general(record.config.angleStdDev)
+            .text(" angleSamples=").integer(record.config.angleSamples)
+            .text(" f4DistanceStdDev=").general(record.config.f4DistanceStdDev)
+            .text(" distanceSamples=").integer(record.config.distanceSamples)
+            .text(" distanceSampleSpacing=").general(record.config.distanceSampleSpacing)
+            .text(" f4CellMargin=").general(record.config.f4CellMargin)
+            .text(" maxRayDistance=").general(record.config.maxRayDistance);
+        break;
+    case SESSION_RECORD_CAPTURE:
+        line.text(record.keyType == CAPTURE_EVENT_DIRECTION_KEY ? " direction " : " distance ").fixed(record.keyTimeMs, 3);
+        break;
+    case SESSION_RECORD_DECODE:
+        if (record.coordsRead) {
+            line.text(" (").integer(record.coords.x).text(", ").integer(record.coords.y).text(", ")
+                .integer(record.coords.z).text(")");
+        }
+        else {
+            line.text(" unreadable");
+        }
+        break;
+    case SESSION_RECORD_SOLVE:
+        line.text(" (").integer(record.coord1.x).text(", ").integer(record.coord1.z).text(") angle=")
+            .fixed(record.angle, 2).text(" presses=").integer(record.distancePressTimesMs.size());
+        if (record.calculatedDistance > 0) line.text(" distance=").fixed(record.calculatedDistance, 0);
+        if (!record.candidates.empty()) {
+            const ResultRow& top = record.candidates[0];
+            line.text(" top=(").integer(top.projectionX).text(", ").integer(top.projectionZ).text(") ")
+                .fixed(top.conditionalProb * 100.0, 1).text("%");
+        }
+        break;
+    case SESSION_RECORD_OUTCOME:
+        line.text(" (").fixed(record.outcomeX, 0).text(", ").fixed(record.outcomeZ, 0).text(")");
+        break;
+    }
+    std::cout << line.c_str() << "\n";
+}
+
+static int usage() {
+    std::cerr << "Usage: session_log list <log>\n"
+        << "       session_log dump <log> <session>\n"
+        << "       session_log range <log> <fromMs> <toMs>\n"
+        << "       session_log export <log> <session>\n"
+        << "       session_log config <log> <session>\n"
+        << "       session_log compact <log> [days] [megabytes]\n"
+        << "       session_log bench <log> <records>\n";
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+    std::string command = argv[1];
+    std::string path = argv[2];
+
+    if (command == "compact") {
+        double days = argc > 3 ? std::atof(argv[3]) : SESSION_LOG_KEEP_MS / 86400000.0;
+        double megabytes = argc > 4 ? std::atof(argv[4]) : SESSION_LOG_KEEP_BYTES / 1048576.0;
+        if (!compactSessionLog(path, sessionWallClockMs() - (int64_t)(days * 86400000.0),
+            (uintmax_t)(megabytes * 1048576.0))) {
+            std::cerr << "Could not compact " << path << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "bench" && argc > 3) {
+        int count = std::atoi(argv[3]);
+        SessionLogWriter writer;
+        if (!writer.open(path)) {
+            std::cerr << "Could not open " << path << "\n";
+            return 1;
+        }
+        std::vector<StrongholdCandidate> candidates(SESSION_LOG_CANDIDATES);
+        for (int i = 0; i < SESSION_LOG_CANDIDATES; i++) {
+            candidates[i] = { 1000 + i, -2000 - i, 125, -250, 1000.0, 2000.0, 0.1, 0.1, 2236, 2236, 2200, L"" };
+        }
+        appState.f4PressedFirst = true;
+        appState.calculatedDistance = 1800.0;
+        appState.distanceKeyPressTimesMs = { 0.0, 150.0, 300.0 };
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            appState.coord1 = { i, 64, -i };
+            writer.append(makeSessionSolveRecord(appState, candidates));
+        }
+        auto queued = std::chrono::steady_clock::now();
+        writer.stop();
+        auto written = std::chrono::steady_clock::now();
+
+        double appendUs = std::chrono::duration<double, std::micro>(queued - start).count() / std::max(1, count);
+        double totalMs = std::chrono::duration<double, std::milli>(written - start).count();
+        NarrowFormatBuffer line;
+        line.text("Appended ").integer(count).text(" solve records: ").fixed(appendUs, 2)
+            .text(" us per append, ").fixed(totalMs, 1).text(" ms until written, ")
+            .integer(metrics.sessionRecordsDropped.get()).text(" dropped from the full queue");
+        std::cout << line.c_str() << "\n";
+        return 0;
+    }
+
+    SessionLogReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Could not open " << path << "\n";
+        return 1;
+    }
+
+    if (command == "list") {
+        for (const auto& summary : reader.sessions()) {
+            NarrowFormatBuffer line;
+            line.text("#").integer(summary.session).text(" ").integer(summary.firstTimeMs).text(" to ")
+                .integer(summary.lastTimeMs).text("  ").integer(summary.records).text(" records, ")
+                .integer(summary.bytes).text(" bytes");
+            std::cout << line.c_str() << "\n";
+        }
+        if (!reader.indexComplete()) std::cout << "Index is behind the log; the writer catches up on its next open\n";
+    }
+    else if (command == "dump" && argc > 3) {
+        for (const auto& record : reader.readSession((uint32_t)std::strtoul(argv[3], nullptr, 10))) {
+            printRecord(record);
+        }
+    }
+    else if (command == "range" && argc > 4) {
+        for (const auto& record : reader.readTimeRange(std::atoll(argv[3]), std::atoll(argv[4]))) {
+            printRecord(record);
+        }
+    }
+    else if (command == "export" && argc > 3) {
+        writeCaptureLog(std::cout, sessionCaptureEvents(reader.readSession((uint32_t)std::strtoul(argv[3], nullptr, 10))));
+    }
+    else if (command == "config" && argc > 3) {
+        const SessionRecord* start = nullptr;
+        std::vector<SessionRecord> records = reader.readSession((uint32_t)std::strtoul(argv[3], nullptr, 10));
+        for (const auto& record : records) {
+            if (record.kind == SESSION_RECORD_START) start = &record;
+        }
+        if (!start) {
+            std::cerr << "No settings record in session " << argv[3] << "\n";
+            return 1;
+        }
+        writeSolverConfig(std::cout, start->config, "Solver");
+    }
+    else {
+        return usage();
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+#define NOMINMAX
+#include "solver_config.h"
+#include "number_format.h"
+#include <cstring>
+#include <sstream>
+
+SolverConfig solverConfig;
+
+struct ConfigField {
+    const char* section;
+    const char* key;
+    bool isInteger;
+    double minValue, maxValue;
+    bool odd;
+    double SolverConfig::* realValue;
+    int SolverConfig::* intValue;
+    const char* const* names;   // Names of the integer values 0..maxValue, written instead of numbers
+};
+
+static const char* const EDITION_NAMES[EDITION_COUNT] = { "bedrock", "java" };
+
+static ConfigField realField(const char* section, const char* key, double SolverConfig::* value, double minValue, double maxValue) {
+    return { section, key, false, minValue, maxValue, false, value, nullptr, nullptr };
+}
+
+static ConfigField intField(const char* section, const char* key, int SolverConfig::* value, int minValue, int maxValue, bool odd = false) {
+    return { section, key, true, (double)minValue, (double)maxValue, odd, nullptr, value, nullptr };
+}
+
+static ConfigField namedField(const char* section, const char* key, int SolverConfig::* value, const char* const* names, int count) {
+    return { section, key, true, 0.0, (double)(count - 1), false, nullptr, value, names };
+}
+
+static const ConfigField CONFIG_FIELDS[] = {
+    namedField("Solver", "Edition", &SolverConfig::edition, EDITION_NAMES, EDITION_COUNT),
+    realField("Solver", "AngleStdDev", &SolverConfig::angleStdDev, 0.1, 10.0),
+    intField("Solver", "AngleSamples", &SolverConfig::angleSamples, 1, MAX_SOLVER_SAMPLES, true),
+    realField("Solver", "F4DistanceStdDev", &SolverConfig::f4DistanceStdDev, 1.0, 500.0),
+    intField("Solver", "DistanceSamples", &SolverConfig::distanceSamples, 1, MAX_SOLVER_SAMPLES, true),
+    realField("Solver", "DistanceSampleSpacing", &SolverConfig::distanceSampleSpacing, 5.0, 500.0),
+    realField("Solver", "F4CellMargin", &SolverConfig::f4CellMargin, 0.0, 500.0),
+    realField("Solver", "MaxRayDistance", &SolverConfig::maxRayDistance, 1000.0, 30000.0),
+    intField("Display", "OverlayCandidates", &SolverConfig::overlayCandidates, 1, 10),
+    intField("Display", "MainWindowCandidates", &SolverConfig::mainWindowCandidates, 1, 20),
+    intField("Display", "CopiedCandidates", &SolverConfig::copiedCandidates, 1, 10),
+    intField("OCR", "SearchTop", &SolverConfig::ocrSearchTop, 0, 200),
+    intField("OCR", "MinStreak", &SolverConfig::ocrMinStreak, 1, 32),
+    intField("OCR", "LabelOffset", &SolverConfig::ocrLabelOffset, 0, 200),
+};
+
+static std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+void readSolverConfig(std::istream& in, SolverConfig& config, std::vector<std::string>& errors) {
+    std::string line, section;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        // Skip empty lines and comments
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+        if (line[0] == '[') {
+            section = trim(line.substr(1, line.find(']') - 1));
+            continue;
+        }
+
+        size_t equalPos = line.find('=');
+        if (equalPos == std::string::npos) continue;
+        std::string key = trim(line.substr(0, equalPos));
+        std::string value = trim(line.substr(equalPos + 1));
+
+        for (const auto& field : CONFIG_FIELDS) {
+            if (section != field.section || key != field.key) continue;
+
+            if (field.names) {
+                int index = 0;
+                while (index <= (int)field.maxValue && value != field.names[index]) index++;
+                if (index <= (int)field.maxValue) {
+                    config.*field.intValue = index;
+                }
+                else {
+                    std::ostringstream message;
+                    message << field.section << "." << field.key << ": '" << value << "' is not one of";
+                    for (int i = 0; i <= (int)field.maxValue; i++) {
+                        message << (i == 0 ? " " : ", ") << field.names[i];
+                    }
+                    errors.push_back(message.str());
+                }
+                break;
+            }
+
+            std::istringstream valueText(value);
+            double number;
+            std::string rest;
+            bool valid = (valueText >> number) && !(valueText >> rest)
+                && number >= field.minValue && number <= field.maxValue;
+            if (valid && field.isInteger) {
+                valid = number == (double)(int)number && (!field.odd || (int)number % 2 == 1);
+            }
+
+            if (!valid) {
+                std::ostringstream message;
+                message << field.section << "." << field.key << ": '" << value << "' is not "
+                    << (field.odd ? "an odd integer" : field.isInteger ? "an integer" : "a number")
+                    << " in " << field.minValue << ".." << field.maxValue;
+                errors.push_back(message.str());
+            }
+            else if (field.isInteger) {
+                config.*field.intValue = (int)number;
+            }
+            else {
+                config.*field.realValue = number;
+            }
+            break;
+        }
+    }
+}
+
+std::vector<ConfigSetting> solverConfigSettings(const SolverConfig& config) {
+    std::vector<ConfigSetting> settings;
+    for (const auto& field : CONFIG_FIELDS) {
+        std::string value;
+        if (field.names) {
+            value = field.names[config.*field.intValue];
+        }
+        else if (field.isInteger) {
+            value = std::to_string(config.*field.intValue);
+        }
+        else {
+            char digits[32];
+            value.assign(digits, formatShortestChars(digits, sizeof(digits), config.*field.realValue));
+        }
+        settings.push_back({ field.section, field.key, value });
+    }
+    return settings;
+}
+
+void writeSolverConfig(std::ostream& out, const SolverConfig& config, const char* onlySection) {
+    std::string section;
+    for (const auto& setting : solverConfigSettings(config)) {
+        if (onlySection && setting.section != onlySection) continue;
+        if (setting.section != section) {
+            section = setting.section;
+            out << "\n[" << section << "]\n";
+        }
+        out << setting.key << "=" << setting.value << "\n";
+    }
+}
+
+void rewriteConfig(std::istream& in, std::ostream& out, const std::vector<ConfigSetting>& settings) {
+    std::vector<std::string> lines;
+    std::vector<bool> written(settings.size(), false);
+    std::vector<std::string> sections;       // In file order
+    std::vector<size_t> sectionEnds;         // Line after the last header or key line of each section
+
+    std::string line, section;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::string content = trim(line);
+        if (!content.empty() && content[0] == '[') {
+            section = trim(content.substr(1, content.find(']') - 1));
+            sections.push_back(section);
+            sectionEnds.push_back(lines.size() + 1);
+        }
+        else if (!content.empty() && content[0] != '#' && content[0] != ';' && content.find('=') != std::string::npos) {
+            std::string key = trim(content.substr(0, content.find('=')));
+            for (size_t i = 0; i < settings.size(); i++) {
+                if (settings[i].section == section && settings[i].key == key) {
+                    line = line.substr(0, line.find('=') + 1) + settings[i].value;
+                    written[i] = true;
+                }
+            }
+            // Keys before any header belong to no section and are left where they are
+            if (!sections.empty() && sections.back() == section) sectionEnds.back() = lines.size() + 1;
+        }
+        lines.push_back(line);
+    }
+
+    // Missing keys of sections already in the file, inserted back to front so the
+    // positions of earlier sections stay valid
+    std::vector<std::vector<std::string>> inserts(sections.size());
+    std::vector<std::string> newSections;
+    std::vector<std::vector<std::string>> newSectionLines;
+    for (size_t i = 0; i < settings.size(); i++) {
+        if (written[i]) continue;
+        std::string entry = settings[i].key + "=" + settings[i].value;
+        size_t index = 0;
+        while (index < sections.size() && sections[index] != settings[i].section) index++;
+        if (index < sections.size()) {
+            inserts[index].push_back(entry);
+            continue;
+        }
+        index = 0;
+        while (index < newSections.size() && newSections[index] != settings[i].section) index++;
+        if (index == newSections.size()) {
+            newSections.push_back(settings[i].section);
+            newSectionLines.emplace_back();
+        }
+        newSectionLines[index].push_back(entry);
+    }
+    for (size_t index = sections.size(); index-- > 0;) {
+        lines.insert(lines.begin() + sectionEnds[index], inserts[index].begin(), inserts[index].end());
+    }
+
+    for (const auto& kept : lines) {
+        out << kept << "\n";
+    }
+    for (size_t index = 0; index < newSections.size(); index++) {
+        if (!lines.empty() || index > 0) out << "\n";
+        out << "[" << newSections[index] << "]\n";
+        for (const auto& entry : newSectionLines[index]) {
+            out << entry << "\n";
+        }
+    }
+}
+
+// FNV-1a over the bytes of the values the table build used
+uint32_t firstThrowConfigFingerprint(const SolverConfig& config) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&](const void* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ ((const uint8_t*)data)[i]) * 16777619u;
+        }
+    };
+    mix(&config.angleStdDev, sizeof(config.angleStdDev));
+    mix(&config.angleSamples, sizeof(config.angleSamples));
+    mix(&config.maxRayDistance, sizeof(config.maxRayDistance));
+    return hash;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#define NOMINMAX
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "cell_lattice.h"
+#include "distance_estimator.h"
+
+// Solver, display and OCR tuning read from config.ini. The constants below are
+// the defaults; the solver reads the live values from solverConfig, which the GUI
+// reloads whenever the file changes. Tables derived from these values (the fixed
+// point sample rotations, the first-throw table) are checked against them lazily.
+
+// Standard deviation for angle measurements (in degrees)
+const double ANGLE_STD_DEV = 2.0; // Adjustable based on measurement precision
+// Spacing between distance samples drawn from the F4 likelihood (in blocks)
+const double DISTANCE_SAMPLE_SPACING = 50.0;
+// How far an F4 point may lie outside a cell and still count as hitting it (in blocks)
+const double F4_CELL_MARGIN = 50.0;
+// Largest odd sample count for the angle and fallback F4 distance samples
+const int MAX_SOLVER_SAMPLES = 15;
+
+// Stronghold placement the solver assumes
+enum StrongholdEdition {
+    EDITION_BEDROCK,        // Grid of cells (cell_lattice.h)
+    EDITION_JAVA,           // Concentric rings (ring_prior.h)
+    EDITION_COUNT
+};
+
+struct SolverConfig {
+    // [Solver]
+    int edition = EDITION_BEDROCK;          // StrongholdEdition
+    double angleStdDev = ANGLE_STD_DEV;
+    int angleSamples = 5;                   // Odd; spaced angleStdDev / 2 apart
+    double f4DistanceStdDev = F4_DISTANCE_STD_DEV;
+    int distanceSamples = 5;                // Odd; F4 samples when no press likelihood exists
+    double distanceSampleSpacing = DISTANCE_SAMPLE_SPACING;
+    double f4CellMargin = F4_CELL_MARGIN;
+    double maxRayDistance = LATTICE_MAX_RAY_DISTANCE;
+
+    // [Display]
+    int overlayCandidates = 6;
+    int mainWindowCandidates = 10;
+    int copiedCandidates = 5;
+
+    // [OCR]
+    int ocrSearchTop = 30;                  // First HUD row searched for the coordinate label
+    int ocrMinStreak = 4;                   // White pixels in a row that mark the label (at scale 1)
+    int ocrLabelOffset = 44;                // Width of "Position: " at scale 1
+};
+
+extern SolverConfig solverConfig;
+
+// Read the [Solver], [Display] and [OCR] sections on top of config. Unknown keys
+// and other sections are ignored; a value that does not parse or is out of range
+// leaves the previous value and adds a message to errors.
+void readSolverConfig(std::istream& in, SolverConfig& config, std::vector<std::string>& errors);
+
+// Write the sections read by readSolverConfig, or only the named one. Numbers are
+// written so they read back exactly.
+void writeSolverConfig(std::ostream& out, const SolverConfig& config, const char* onlySection = nullptr);
+
+struct ConfigSetting {
+    std::string section, key, value;
+};
+
+// The settings writeSolverConfig writes, in the same order
+std::vector<ConfigSetting> solverConfigSettings(const SolverConfig& config);
+
+// Copy an existing config file from in to out with settings applied. A key already in
+// its section gets the new value in place; missing ones are added after the last line of
+// their section, or in a new section at the end. Comments, blank lines, unknown keys and
+// other sections are kept as they are.
+void rewriteConfig(std::istream& in, std::ostream& out, const std::vector<ConfigSetting>& settings);
+
+// Identifies the values a precomputed first-throw table depends on
+uint32_t firstThrowConfigFingerprint(const SolverConfig& config);
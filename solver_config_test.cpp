@@ -0,0 +1,111 @@
+// Checks that written settings read back exactly and that rewriting config.ini keeps
+// what the user put there: comments, blank lines, unknown keys and sections.
+// Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 solver_config_test.cpp solver_config.cpp number_format.cpp -o solver_config_test
+#define NOMINMAX
+#include "solver_config.h"
+#include <iostream>
+#include <sstream>
+
+static bool ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAILED: " << what << "\n";
+        ok = false;
+    }
+}
+
+static std::string rewrite(const std::string& text, const std::vector<ConfigSetting>& settings) {
+    std::istringstream in(text);
+    std::ostringstream out;
+    rewriteConfig(in, out, settings);
+    return out.str();
+}
+
+// Values that the default 6 significant digits would round
+static void checkRoundTrip() {
+    SolverConfig config;
+    config.angleStdDev = 0.1 + 1e-12;
+    config.f4DistanceStdDev = 123.45678901234;
+    config.distanceSampleSpacing = 50.0 / 3.0;
+    config.maxRayDistance = 12345.678901;
+
+    std::stringstream file;
+    writeSolverConfig(file, config);
+    SolverConfig readBack;
+    std::vector<std::string> errors;
+    readSolverConfig(file, readBack, errors);
+
+    check(errors.empty(), "written settings read back without errors");
+    check(readBack.angleStdDev == config.angleStdDev && readBack.f4DistanceStdDev == config.f4DistanceStdDev
+        && readBack.distanceSampleSpacing == config.distanceSampleSpacing && readBack.maxRayDistance == config.maxRayDistance,
+        "written numbers read back exactly");
+
+    std::ostringstream defaults;
+    writeSolverConfig(defaults, SolverConfig(), "Solver");
+    check(defaults.str().find("AngleStdDev=2\n") != std::string::npos, "round numbers stay short");
+}
+
+static void checkRewriteKeepsUserLines() {
+    std::string original =
+        "; tuned for my setup\r\n"
+        "[Hotkeys]\r\n"
+        "DirectionKey = 9\r\n"
+        "\r\n"
+        "[Solver]\r\n"
+        "# wider cone after the 1.21 update\r\n"
+        "AngleStdDev=3.5\r\n"
+        "Experimental=yes\r\n"
+        "\r\n"
+        "[Plugins]\r\n"
+        "Path=C:\\tools\r\n";
+    std::vector<ConfigSetting> settings = {
+        { "Hotkeys", "DirectionKey", "84" },
+        { "Hotkeys", "DistanceKey", "115" },
+        { "Solver", "AngleStdDev", "0.25" },
+        { "Solver", "AngleSamples", "7" },
+        { "OCR", "SearchTop", "40" },
+    };
+    std::string expected =
+        "; tuned for my setup\n"
+        "[Hotkeys]\n"
+        "DirectionKey =84\n"
+        "DistanceKey=115\n"
+        "\n"
+        "[Solver]\n"
+        "# wider cone after the 1.21 update\n"
+        "AngleStdDev=0.25\n"
+        "Experimental=yes\n"
+        "AngleSamples=7\n"
+        "\n"
+        "[Plugins]\n"
+        "Path=C:\\tools\n"
+        "\n"
+        "[OCR]\n"
+        "SearchTop=40\n";
+    std::string rewritten = rewrite(original, settings);
+    check(rewritten == expected, "comments, unknown keys and sections survive a rewrite");
+    check(rewrite(rewritten, settings) == rewritten, "rewriting again changes nothing");
+
+    std::istringstream in(rewritten);
+    SolverConfig config;
+    std::vector<std::string> errors;
+    readSolverConfig(in, config, errors);
+    check(config.angleStdDev == 0.25 && config.angleSamples == 7 && config.ocrSearchTop == 40,
+        "rewritten file reads back with the new values");
+}
+
+static void checkNewFile() {
+    std::string created = rewrite("", { { "Hotkeys", "DirectionKey", "9" }, { "Solver", "Edition", "java" } });
+    check(created == "[Hotkeys]\nDirectionKey=9\n\n[Solver]\nEdition=java\n", "a missing file gets every section");
+}
+
+int main() {
+    checkRoundTrip();
+    checkRewriteKeepsUserLines();
+    checkNewFile();
+
+    std::cout << (ok ? "All solver config checks passed\n" : "Solver config checks FAILED\n");
+    return ok ? 0 : 1;
+}
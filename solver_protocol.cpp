@@ -0,0 +1,119 @@
+#define NOMINMAX
+#include "solver_protocol.h"
+#include <cstring>
+
+static void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void putDouble(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put32(out, (uint32_t)bits);
+    put32(out, (uint32_t)(bits >> 32));
+}
+
+// Bounds-checked reader over a payload
+struct PayloadReader {
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    bool ok = true;
+
+    uint8_t get8() {
+        if (offset + 1 > size) {
+            ok = false;
+            return 0;
+        }
+        return data[offset++];
+    }
+    uint32_t get32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= (uint32_t)get8() << (8 * i);
+        }
+        return value;
+    }
+    double getDouble() {
+        uint64_t bits = get32();
+        bits |= (uint64_t)get32() << 32;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+std::vector<uint8_t> encodeSolverRequest(const SolverRequest& request) {
+    std::vector<uint8_t> out;
+    put32(out, SOLVER_REQUEST_MAGIC);
+    put32(out, request.requestId);
+    put32(out, (uint32_t)request.x1);
+    put32(out, (uint32_t)request.z1);
+    put32(out, (uint32_t)request.x2);
+    put32(out, (uint32_t)request.z2);
+    putDouble(out, request.f4Distance);
+    out.push_back(request.solverMode);
+    out.push_back(request.maxCandidates);
+    return out;
+}
+
+bool decodeSolverRequest(const uint8_t* data, size_t size, SolverRequest& request) {
+    PayloadReader reader = { data, size };
+    if (reader.get32() != SOLVER_REQUEST_MAGIC) return false;
+    request.requestId = reader.get32();
+    request.x1 = (int32_t)reader.get32();
+    request.z1 = (int32_t)reader.get32();
+    request.x2 = (int32_t)reader.get32();
+    request.z2 = (int32_t)reader.get32();
+    request.f4Distance = reader.getDouble();
+    request.solverMode = reader.get8();
+    request.maxCandidates = reader.get8();
+    return reader.ok && reader.offset == size;
+}
+
+std::vector<uint8_t> encodeSolverResponse(const SolverResponse& response) {
+    std::vector<uint8_t> out;
+    put32(out, SOLVER_RESPONSE_MAGIC);
+    put32(out, response.requestId);
+    out.push_back(response.status);
+    out.push_back((uint8_t)response.candidates.size());
+    for (const auto& row : response.candidates) {
+        put32(out, (uint32_t)row.projectionX);
+        put32(out, (uint32_t)row.projectionZ);
+        put32(out, (uint32_t)row.netherX);
+        put32(out, (uint32_t)row.netherZ);
+        put32(out, (uint32_t)row.distance);
+        putDouble(out, row.conditionalProb);
+    }
+    return out;
+}
+
+bool decodeSolverResponse(const uint8_t* data, size_t size, SolverResponse& response) {
+    PayloadReader reader = { data, size };
+    if (reader.get32() != SOLVER_RESPONSE_MAGIC) return false;
+    response.requestId = reader.get32();
+    response.status = reader.get8();
+    int count = reader.get8();
+    response.candidates.clear();
+    for (int i = 0; i < count && reader.ok; i++) {
+        SolverResultRow row;
+        row.projectionX = (int32_t)reader.get32();
+        row.projectionZ = (int32_t)reader.get32();
+        row.netherX = (int32_t)reader.get32();
+        row.netherZ = (int32_t)reader.get32();
+        row.distance = (int32_t)reader.get32();
+        row.conditionalProb = reader.getDouble();
+        response.candidates.push_back(row);
+    }
+    return reader.ok && reader.offset == size;
+}
+
+void appendFrameLength(std::vector<uint8_t>& out, uint32_t length) {
+    put32(out, length);
+}
+
+uint32_t readFrameLength(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#define NOMINMAX
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary protocol of the solver service. Every message is a frame: a 32-bit
+// little-endian payload length followed by the payload. All integers are
+// little-endian; doubles are sent as their IEEE-754 bit pattern.
+
+const uint32_t SOLVER_REQUEST_MAGIC = 0x31514853;   // "SHQ1"
+const uint32_t SOLVER_RESPONSE_MAGIC = 0x31524853;  // "SHR1"
+const uint32_t MAX_SOLVER_FRAME = 4096;
+const int MAX_SOLVER_CANDIDATES = 64;
+
+enum SolverStatus {
+    SOLVER_STATUS_OK = 0,
+    SOLVER_STATUS_BAD_REQUEST = 1
+};
+
+// One throw: the two captured positions, optionally with an F4 distance
+struct SolverRequest {
+    uint32_t requestId;
+    int32_t x1, z1;         // First capture (throw position)
+    int32_t x2, z2;         // Second capture (direction)
+    double f4Distance;      // 0 when no distance was measured
+    uint8_t solverMode;     // SolverMode
+    uint8_t maxCandidates;
+};
+
+struct SolverResultRow {
+    int32_t projectionX, projectionZ;
+    int32_t netherX, netherZ;
+    int32_t distance;
+    double conditionalProb;
+};
+
+struct SolverResponse {
+    uint32_t requestId;
+    uint8_t status;
+    std::vector<SolverResultRow> candidates;
+};
+
+// Payload encoding (without the length prefix)
+std::vector<uint8_t> encodeSolverRequest(const SolverRequest& request);
+bool decodeSolverRequest(const uint8_t* data, size_t size, SolverRequest& request);
+std::vector<uint8_t> encodeSolverResponse(const SolverResponse& response);
+bool decodeSolverResponse(const uint8_t* data, size_t size, SolverResponse& response);
+
+// Length prefix for a payload
+void appendFrameLength(std::vector<uint8_t>& out, uint32_t length);
+uint32_t readFrameLength(const uint8_t* data);
@@ -0,0 +1,140 @@
+#define NOMINMAX
+#include "solver_service.h"
+#include "stronghold_calculator.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Cells built before the first query, enough for throws within this distance of the origin
+const double WARM_LATTICE_RADIUS = 6000.0;
+
+static bool isValidCoordinate(int32_t coordinate) {
+    return coordinate >= -MAX_SOLVER_COORDINATE && coordinate <= MAX_SOLVER_COORDINATE;
+}
+
+bool isValidSolverRequest(const SolverRequest& request) {
+    // Also false for NaN and infinite distances
+    bool validDistance = request.f4Distance >= 0 && request.f4Distance <= MAX_SOLVER_F4_DISTANCE;
+    return request.solverMode <= SOLVER_FIXED_POINT && validDistance
+        && isValidCoordinate(request.x1) && isValidCoordinate(request.z1)
+        && isValidCoordinate(request.x2) && isValidCoordinate(request.z2);
+}
+
+static SolverResponse badRequestResponse(const SolverRequest& request) {
+    SolverResponse response;
+    response.requestId = request.requestId;
+    response.status = SOLVER_STATUS_BAD_REQUEST;
+    return response;
+}
+
+SolverResponse solveRequest(const SolverRequest& request) {
+    if (!isValidSolverRequest(request)) return badRequestResponse(request);
+    SolverResponse response;
+    response.requestId = request.requestId;
+    response.status = SOLVER_STATUS_OK;
+
+    // Same state the capture logic leaves behind before CAPTURE_ACTION_SOLVE
+    appState = ApplicationState();
+    appState.coord1 = { request.x1, 0, request.z1 };
+    appState.coord2 = { request.x2, 0, request.z2 };
+    appState.capturePhase = 2;
+    appState.lastAngle = angleBetween(request.x1, request.z1, request.x2, request.z2);
+    if (request.f4Distance > 0) {
+        appState.f4PressedFirst = true;
+        appState.calculatedDistance = request.f4Distance;
+    }
+
+    SolverMode previousMode = solverMode;
+    solverMode = (SolverMode)request.solverMode;
+    solveCapturedThrow(request.f4Distance > 0 ? request.f4Distance : -1);
+    solverMode = previousMode;
+
+    int count = std::min({ (int)strongholdCandidates.size(), (int)request.maxCandidates, MAX_SOLVER_CANDIDATES });
+    for (int i = 0; i < count; i++) {
+        const auto& candidate = strongholdCandidates[i];
+        response.candidates.push_back({ candidate.projectionX, candidate.projectionZ,
+            candidate.netherX, candidate.netherZ, candidate.distance, candidate.conditionalProb });
+    }
+    return response;
+}
+
+// Requests that solve to the same candidates (everything but id and row count)
+static bool sameThrow(const SolverRequest& a, const SolverRequest& b) {
+    return a.x1 == b.x1 && a.z1 == b.z1 && a.x2 == b.x2 && a.z2 == b.z2
+        && std::memcmp(&a.f4Distance, &b.f4Distance, sizeof(double)) == 0 && a.solverMode == b.solverMode;
+}
+
+SolverBatcher::SolverBatcher() {
+    worker = std::thread(&SolverBatcher::run, this);
+}
+
+SolverBatcher::~SolverBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+std::future<SolverResponse> SolverBatcher::submit(const SolverRequest& request) {
+    PendingRequest entry;
+    entry.request = request;
+    std::future<SolverResponse> result = entry.promise.get_future();
+    if (!isValidSolverRequest(request)) {
+        requests++;
+        entry.promise.set_value(badRequestResponse(request));
+        return result;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(entry));
+    }
+    requests++;
+    wake.notify_one();
+    return result;
+}
+
+void SolverBatcher::run() {
+    std::vector<const StrongholdCell*> warmCells;
+    strongholdCellsNear(0, 0, WARM_LATTICE_RADIUS, warmCells);
+
+    while (true) {
+        // Everything queued while the previous batch was solving forms the next batch
+        std::deque<PendingRequest> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || !pending.empty(); });
+            if (pending.empty()) return;
+            batch.swap(pending);
+        }
+        batches++;
+
+        TRACE_SPAN("solve batch");
+        std::vector<bool> answered(batch.size(), false);
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (answered[i]) continue;
+            // Solve once with the largest row count any identical request asked for
+            SolverRequest widest = batch[i].request;
+            for (size_t j = i + 1; j < batch.size(); j++) {
+                if (sameThrow(batch[i].request, batch[j].request)) {
+                    widest.maxCandidates = std::max(widest.maxCandidates, batch[j].request.maxCandidates);
+                }
+            }
+            SolverResponse full = solveRequest(widest);
+            solves++;
+
+            for (size_t j = i; j < batch.size(); j++) {
+                if (answered[j] || !sameThrow(batch[i].request, batch[j].request)) continue;
+                SolverResponse response = full;
+                response.requestId = batch[j].request.requestId;
+                if (response.candidates.size() > batch[j].request.maxCandidates) {
+                    response.candidates.resize(batch[j].request.maxCandidates);
+                }
+                batch[j].promise.set_value(std::move(response));
+                answered[j] = true;
+            }
+        }
+    }
+}
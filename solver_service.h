@@ -0,0 +1,59 @@
+#pragma once
+#define NOMINMAX
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "solver_protocol.h"
+
+// Shared solver for several clients. Requests from any thread are queued and a
+// single solver thread drains the queue in batches: identical throws in a batch
+// are solved once and the result fanned out, and the cell lattice and prior table
+// stay warm between queries. The solver thread owns appState and
+// strongholdCandidates of the process.
+
+class SolverBatcher {
+public:
+    SolverBatcher();
+    ~SolverBatcher();
+
+    // Invalid requests are answered at once and never reach the solver thread
+    std::future<SolverResponse> submit(const SolverRequest& request);
+
+    uint64_t requestCount() const { return requests; }
+    uint64_t batchCount() const { return batches; }
+    uint64_t solveCount() const { return solves; }
+
+private:
+    struct PendingRequest {
+        SolverRequest request;
+        std::promise<SolverResponse> promise;
+    };
+
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<PendingRequest> pending;
+    bool stopping = false;
+    std::atomic<uint64_t> requests{ 0 };
+    std::atomic<uint64_t> batches{ 0 };
+    std::atomic<uint64_t> solves{ 0 };
+    std::thread worker;
+};
+
+// Request limits. Coordinates past the world border and F4 distances past the
+// longest ray reach no cell, and larger values overflow the solvers' arithmetic
+// or make them walk an unbounded number of cells.
+const int32_t MAX_SOLVER_COORDINATE = 30000000;     // World border
+const double MAX_SOLVER_F4_DISTANCE = 10000.0;      // LATTICE_MAX_RAY_DISTANCE
+
+// Whether a request is within the limits above and names a known solver mode
+bool isValidSolverRequest(const SolverRequest& request);
+
+// Solve one request against the process-wide solver state. Invalid requests are
+// answered with SOLVER_STATUS_BAD_REQUEST without touching that state.
+SolverResponse solveRequest(const SolverRequest& request);
@@ -0,0 +1,254 @@
+// Local solver daemon and a small client for it. The daemon listens on a Unix domain
+// socket (a named pipe on Windows) and answers framed solver_protocol.h requests
+// through one shared SolverBatcher. Builds without Win32, e.g.:
+//   g++ -std=c++17 -O2 -pthread solver_service_tool.cpp solver_service.cpp solver_protocol.cpp
+//       stronghold_calculator.cpp fixed_point_solver.cpp first_throw_table.cpp cell_lattice.cpp ring_prior.cpp
+//       distance_estimator.cpp solver_config.cpp number_format.cpp trace.cpp metrics.cpp -o solver_service
+#define NOMINMAX
+#include "solver_service.h"
+#include "stronghold_calculator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Application state (defined by main.cpp in the GUI build); owned by the solver thread
+ApplicationState appState;
+
+#ifdef _WIN32
+const char* DEFAULT_SERVICE_PATH = "\\\\.\\pipe\\stronghold-solver";
+typedef HANDLE Connection;
+const Connection INVALID_CONNECTION = INVALID_HANDLE_VALUE;
+
+static bool readExact(Connection connection, uint8_t* data, size_t size) {
+    while (size > 0) {
+        DWORD got = 0;
+        if (!ReadFile(connection, data, (DWORD)size, &got, NULL) || got == 0) return false;
+        data += got;
+        size -= got;
+    }
+    return true;
+}
+
+static bool writeAll(Connection connection, const uint8_t* data, size_t size) {
+    DWORD written = 0;
+    return WriteFile(connection, data, (DWORD)size, &written, NULL) && written == size;
+}
+
+static void closeConnection(Connection connection) {
+    FlushFileBuffers(connection);
+    DisconnectNamedPipe(connection);
+    CloseHandle(connection);
+}
+
+static Connection connectToService(const char* path) {
+    return CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+}
+#else
+const char* DEFAULT_SERVICE_PATH = "/tmp/stronghold-solver.sock";
+typedef int Connection;
+const Connection INVALID_CONNECTION = -1;
+
+static bool readExact(Connection connection, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t got = read(connection, data, size);
+        if (got <= 0) return false;
+        data += got;
+        size -= (size_t)got;
+    }
+    return true;
+}
+
+static bool writeAll(Connection connection, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(connection, data, size);
+        if (written <= 0) return false;
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static void closeConnection(Connection connection) {
+    close(connection);
+}
+
+static bool makeSocketAddress(const char* path, sockaddr_un& address) {
+    if (std::strlen(path) >= sizeof(address.sun_path)) return false;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path);
+    return true;
+}
+
+static Connection connectToService(const char* path) {
+    sockaddr_un address;
+    if (!makeSocketAddress(path, address)) return INVALID_CONNECTION;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return INVALID_CONNECTION;
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return INVALID_CONNECTION;
+    }
+    return fd;
+}
+#endif
+
+static bool readFrame(Connection connection, std::vector<uint8_t>& payload) {
+    uint8_t header[4];
+    if (!readExact(connection, header, sizeof(header))) return false;
+    uint32_t length = readFrameLength(header);
+    if (length > MAX_SOLVER_FRAME) return false;
+    payload.resize(length);
+    return readExact(connection, payload.data(), length);
+}
+
+static bool writeFrame(Connection connection, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> frame;
+    appendFrameLength(frame, (uint32_t)payload.size());
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    return writeAll(connection, frame.data(), frame.size());
+}
+
+// One client: requests are answered in order until the client disconnects
+static void serveClient(SolverBatcher& batcher, Connection connection) {
+    std::vector<uint8_t> payload;
+    while (readFrame(connection, payload)) {
+        SolverRequest request;
+        SolverResponse response;
+        if (decodeSolverRequest(payload.data(), payload.size(), request)) {
+            response = batcher.submit(request).get();
+        }
+        else {
+            response.requestId = 0;
+            response.status = SOLVER_STATUS_BAD_REQUEST;
+        }
+        if (!writeFrame(connection, encodeSolverResponse(response))) break;
+    }
+    closeConnection(connection);
+}
+
+static int serve(const char* path) {
+    SolverBatcher batcher;
+    std::cout << "Serving on " << path << "\n";
+
+#ifdef _WIN32
+    while (true) {
+        HANDLE pipe = CreateNamedPipeA(path, PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+            PIPE_UNLIMITED_INSTANCES, MAX_SOLVER_FRAME, MAX_SOLVER_FRAME, 0, NULL);
+        if (pipe == INVALID_HANDLE_VALUE) {
+            std::cerr << "Could not create pipe " << path << "\n";
+            return 1;
+        }
+        if (!ConnectNamedPipe(pipe, NULL) && GetLastError() != ERROR_PIPE_CONNECTED) {
+            CloseHandle(pipe);
+            continue;
+        }
+        std::thread(serveClient, std::ref(batcher), pipe).detach();
+    }
+#else
+    // A client that disconnects before its answer is written must not kill the daemon;
+    // writeAll sees EPIPE instead and serveClient drops the connection
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address;
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || !makeSocketAddress(path, address)) {
+        std::cerr << "Bad socket path " << path << "\n";
+        return 1;
+    }
+    unlink(path);
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        std::cerr << "Could not listen on " << path << "\n";
+        return 1;
+    }
+    while (true) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) continue;
+        std::thread(serveClient, std::ref(batcher), client).detach();
+    }
+#endif
+}
+
+// Send the same throw repeatedly and report the answer and the round-trip latency
+static int query(const char* path, const SolverRequest& request, int repeat) {
+    Connection connection = connectToService(path);
+    if (connection == INVALID_CONNECTION) {
+        std::cerr << "Could not connect to " << path << "\n";
+        return 1;
+    }
+
+    SolverResponse response;
+    std::vector<uint8_t> payload;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) {
+        SolverRequest numbered = request;
+        numbered.requestId = (uint32_t)i;
+        if (!writeFrame(connection, encodeSolverRequest(numbered)) || !readFrame(connection, payload)
+            || !decodeSolverResponse(payload.data(), payload.size(), response)) {
+            std::cerr << "Service closed the connection\n";
+            closeConnection(connection);
+            return 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    closeConnection(connection);
+
+    if (response.status != SOLVER_STATUS_OK) {
+        std::cerr << "Service rejected the request\n";
+        return 1;
+    }
+    for (const auto& row : response.candidates) {
+        std::cout << row.projectionX << " " << row.projectionZ << "  nether " << row.netherX << " " << row.netherZ
+            << "  " << row.distance << " blocks  " << row.conditionalProb * 100.0 << "%\n";
+    }
+    std::cout << repeat << " request(s), " << seconds * 1e6 / repeat << " us per round trip\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "serve") {
+        return serve(argc > 2 ? argv[2] : DEFAULT_SERVICE_PATH);
+    }
+
+    if (command == "query" && argc >= 4) {
+        SolverRequest request = {};
+        request.maxCandidates = 5;
+        char comma;
+        std::istringstream first(argv[2]), second(argv[3]);
+        if (!(first >> request.x1 >> comma >> request.z1) || !(second >> request.x2 >> comma >> request.z2)) {
+            std::cerr << "Positions are given as x,z\n";
+            return 1;
+        }
+
+        const char* path = DEFAULT_SERVICE_PATH;
+        int repeat = 1;
+        for (int i = 4; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--fixed") request.solverMode = SOLVER_FIXED_POINT;
+            else if (arg == "--distance" && i + 1 < argc) request.f4Distance = std::atof(argv[++i]);
+            else if (arg == "--count" && i + 1 < argc) request.maxCandidates = (uint8_t)std::atoi(argv[++i]);
+            else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--path" && i + 1 < argc) path = argv[++i];
+        }
+        return query(path, request, repeat);
+    }
+
+    std::cerr << "Usage: solver_service serve [path]\n"
+        << "       solver_service query <x1,z1> <x2,z2> [--distance d] [--fixed] [--count n] [--repeat n] [--path p]\n";
+    return 1;
+}
@@ -1,10 +1,17 @@
 // Enhanced stronghold calculator with uncertainty handling and Bedrock eye position fix
 #define NOMINMAX
 #include "stronghold_calculator.h"
+#include "trace.h"
+#include "metrics.h"
+#include "number_format.h"
+#include "fixed_point_solver.h"
+#include "first_throw_table.h"
+#include "ring_prior.h"
 #include <map>
 #include <algorithm>
 #include <cmath>
 #include <vector>
+#include <deque>
 
 // Distance probabilities from the HTML version
 std::map<int, double> distanceProbabilities = {
@@ -15,13 +22,8 @@ std::map<int, double> distanceProbabilities = {
     {2800, 0.0258}, {3000, 0.0171}, {3100, 0.0169}, {3200, 0.0189}
 };
 
-// Standard deviation for angle measurements (in degrees)
-const double ANGLE_STD_DEV = 2.0; // Adjustable based on measurement precision
-// Standard deviation for F4 distance measurements (in blocks)
-const double F4_DISTANCE_STD_DEV = 25.0; // Adjustable based on F4 precision
-
-std::vector<StrongholdCell> strongholdCells;
 std::vector<StrongholdCandidate> strongholdCandidates;
+SolverMode solverMode = SOLVER_DOUBLE;
 
 // Helper function to calculate Gaussian probability
 double gaussianProbability(double x, double mean, double stdDev) {
@@ -31,93 +33,47 @@ double gaussianProbability(double x, double mean, double stdDev) {
 }
 
 // Generate multiple angle samples for uncertainty
-std::vector<double> generateAngleSamples(double centerAngle, int numSamples = 5) {
+std::vector<double> generateAngleSamples(double centerAngle, int numSamples, double angleStdDev) {
     std::vector<double> angles;
     for (int i = 0; i < numSamples; i++) {
-        double offset = (i - numSamples / 2) * (ANGLE_STD_DEV / 2.0);
+        double offset = (i - numSamples / 2) * (angleStdDev / 2.0);
         angles.push_back(centerAngle + offset);
     }
     return angles;
 }
 
-// Generate distance samples for F4 uncertainty
-std::vector<double> generateDistanceSamples(double centerDistance, int numSamples = 5) {
-    std::vector<double> distances;
+// Generate distance samples for F4 uncertainty when no press likelihood is available
+std::vector<DistanceSample> generateDistanceSamples(double centerDistance, int numSamples, double stdDev) {
+    std::vector<DistanceSample> distances;
     for (int i = 0; i < numSamples; i++) {
-        double offset = (i - numSamples / 2) * (F4_DISTANCE_STD_DEV / 2.0);
-        distances.push_back(std::max(0.0, centerDistance + offset));
+        double offset = (i - numSamples / 2) * (stdDev / 2.0);
+        double distance = std::max(0.0, centerDistance + offset);
+        distances.push_back({ distance, gaussianProbability(distance, centerDistance, stdDev) });
     }
     return distances;
 }
 
-void generateStrongholdCells() {
-    strongholdCells.clear();
-    int cellSize = 272;
-    int gap = 160;
-    int totalStep = cellSize + gap; // 432 blocks between cell starts
-
-    for (int xIndex = -15; xIndex <= 15; xIndex++) {
-        for (int zIndex = -15; zIndex <= 15; zIndex++) {
-            double xMin, xMax, zMin, zMax;
-
-            // Calculate X bounds
-            if (xIndex >= 0) {
-                xMin = xIndex * totalStep;
-                xMax = xMin + cellSize;
-            }
-            else {
-                xMax = xIndex * totalStep - gap;
-                xMin = xMax - cellSize;
-            }
-
-            // Calculate Z bounds
-            if (zIndex >= 0) {
-                zMin = zIndex * totalStep;
-                zMax = zMin + cellSize;
-            }
-            else {
-                zMax = zIndex * totalStep - gap;
-                zMin = zMax - cellSize;
-            }
-
-            double centerX = (xMin + xMax) / 2.0;
-            double centerZ = (zMin + zMax) / 2.0;
-
-            // Check if this cell is at least 512 blocks from origin
-            double distanceFromOrigin = std::sqrt(centerX * centerX + centerZ * centerZ);
-            if (distanceFromOrigin >= 512) {
-                // Find the closest distance range in our data
-                int closestDistance = 500;
-                double minDiff = std::abs(500 - (int)distanceFromOrigin);
-
-                for (auto& pair : distanceProbabilities) {
-                    double diff = std::abs(pair.first - (int)distanceFromOrigin);
-                    if (diff < minDiff) {
-                        minDiff = diff;
-                        closestDistance = pair.first;
-                    }
-                }
-
-                double prob = distanceProbabilities[closestDistance];
+double angleBetween(double x1, double y1, double x2, double y2) {
+    double dx = x2 - x1;
+    double dz = y2 - y1;
+    double angle = std::atan2(dx, -dz) * 180.0 / M_PI; // note the -dz
+    if (angle < 0) angle += 360.0;
+    return angle;
+}
 
-                StrongholdCell cell;
-                cell.centerX = centerX;
-                cell.centerZ = centerZ;
-                cell.xMin = xMin;
-                cell.xMax = xMax;
-                cell.zMin = zMin;
-                cell.zMax = zMax;
-                cell.prob = prob;
-                cell.distance = distanceFromOrigin;
-                cell.distanceRange = closestDistance;
+void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance) {
+    calculateStrongholdLocationWithDistance(playerX, playerZ, eyeAngle, targetDistance, solverConfig);
+}
 
-                strongholdCells.push_back(cell);
-            }
-        }
+void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance,
+    const SolverConfig& config) {
+    if (config.edition == EDITION_JAVA) {
+        calculateStrongholdLocationJava(playerX, playerZ, eyeAngle, targetDistance, config);
+        return;
     }
-}
 
-void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance) {
+    TRACE_SPAN("solve");
+    ScopedLatency latency(metrics.solveLatency);
     strongholdCandidates.clear();
     appState.distanceValidationFailed = false;
     appState.validationErrorMessage = L"";
@@ -133,82 +89,105 @@ void calculateStrongholdLocationWithDistance(double playerX, double playerZ, dou
         targetDistance = appState.calculatedDistance;
     }
 
-    // Map to accumulate probabilities for each cell
-    std::map<const StrongholdCell*, double> cellProbabilities;
-    std::map<const StrongholdCell*, std::vector<std::pair<double, double>>> cellProjections;
+    // Virtual cells for F4 points outside every cell; a deque keeps their addresses stable
+    static std::deque<StrongholdCell> virtualCells;
+    virtualCells.clear();
+
+    // Lattice cells are only built where the throw reaches; old tiles are dropped before any are referenced
+    trimStrongholdCellCache();
+    std::vector<const StrongholdCell*> nearbyCells;
+
+    // Accumulated probability and projection sum for each cell; ray hits find theirs through cellSlots
+    struct CellAccumulator {
+        const StrongholdCell* cell;
+        double prob;
+        double sumX, sumZ;
+        int projections;
+    };
+    std::vector<CellAccumulator> accumulators;
+    std::map<const StrongholdCell*, size_t> cellSlots;
+    auto accumulate = [&](size_t slot, double prob, double x, double z) {
+        CellAccumulator& accumulator = accumulators[slot];
+        accumulator.prob += prob;
+        accumulator.sumX += x;
+        accumulator.sumZ += z;
+        accumulator.projections++;
+    };
 
     // Generate angle samples to account for uncertainty
-    std::vector<double> angleSamples = generateAngleSamples(eyeAngle);
+    std::vector<double> angleSamples = generateAngleSamples(eyeAngle, config.angleSamples, config.angleStdDev);
 
-    // Generate distance samples if using F4
-    std::vector<double> distanceSamples;
+    // Generate distance samples if using F4, weighted by the press-count likelihood
+    std::vector<DistanceSample> distanceSamples;
     if (useTargetDistance) {
-        distanceSamples = generateDistanceSamples(targetDistance);
+        if (appState.distanceLikelihood.isValid()) {
+            distanceSamples = appState.distanceLikelihood.samples(config.distanceSampleSpacing);
+        }
+        else {
+            distanceSamples = generateDistanceSamples(targetDistance, config.distanceSamples, config.f4DistanceStdDev);
+        }
     }
     else {
-        distanceSamples.push_back(0); // Placeholder for non-F4 case
+        distanceSamples.push_back({ 0, 1.0 }); // Placeholder for non-F4 case
+    }
+
+    // F4 samples can only reach the cells around their annulus sector; collect those once
+    // so each sample tests a handful of cells instead of querying the lattice
+    std::vector<const StrongholdCell*> sectorCells;
+    if (useTargetDistance && !distanceSamples.empty()) {
+        double halfAngle = 0.0, minSample = distanceSamples[0].distance, maxSample = minSample;
+        for (double angleTest : angleSamples) {
+            halfAngle = std::max(halfAngle, std::abs(angleTest - eyeAngle));
+        }
+        for (const auto& distanceSample : distanceSamples) {
+            minSample = std::min(minSample, distanceSample.distance);
+            maxSample = std::max(maxSample, distanceSample.distance);
+        }
+        strongholdCellsInWedge(eyeStartX, eyeStartZ, eyeAngle, halfAngle, minSample, maxSample,
+            config.f4CellMargin, sectorCells);
+        for (const StrongholdCell* cellPtr : sectorCells) {
+            accumulators.push_back({ cellPtr, 0.0, 0.0, 0.0, 0 });
+        }
     }
 
     // Process each combination of angle and distance samples
+    bool anySampleHitCell = false;
     for (double angleTest : angleSamples) {
         double angleRad = angleTest * M_PI / 180.0;
         double dx = std::sin(angleRad);
         double dz = -std::cos(angleRad);
 
         // Weight for this angle sample
-        double angleWeight = gaussianProbability(angleTest, eyeAngle, ANGLE_STD_DEV);
+        double angleWeight = gaussianProbability(angleTest, eyeAngle, config.angleStdDev);
 
         if (useTargetDistance) {
             // F4 case: test multiple distance samples
-            for (double distanceTest : distanceSamples) {
-                double distanceWeight = gaussianProbability(distanceTest, targetDistance, F4_DISTANCE_STD_DEV);
-                double combinedWeight = angleWeight * distanceWeight;
+            for (const auto& distanceSample : distanceSamples) {
+                double distanceTest = distanceSample.distance;
+                double combinedWeight = angleWeight * distanceSample.weight;
 
                 // Calculate the point at this distance along this ray FROM THE EYE START POSITION
                 double exactX = eyeStartX + distanceTest * dx;
                 double exactZ = eyeStartZ + distanceTest * dz;
 
-                // Check all cells for intersection or proximity
-                for (auto& cell : strongholdCells) {
+                // Cells within the F4 margin of the exact point (allowed F4 distance deviation)
+                bool hitAnyCell = false;
+                for (size_t slot = 0; slot < sectorCells.size(); slot++) {
+                    const StrongholdCell* cellPtr = sectorCells[slot];
                     // Find the closest point on this cell to the exact point
-                    double clampedX = std::max(cell.xMin, std::min(cell.xMax, exactX));
-                    double clampedZ = std::max(cell.zMin, std::min(cell.zMax, exactZ));
-
-                    double distanceToCell = std::sqrt(
-                        std::pow(clampedX - exactX, 2) + std::pow(clampedZ - exactZ, 2)
-                    );
-
-                    // Allow up to 50 blocks deviation from F4 distance
-                    if (distanceToCell <= 50.0) {
-                        const StrongholdCell* cellPtr = &cell;
-                        if (cellProbabilities.count(cellPtr) > 0) {
-                            cellProbabilities[cellPtr] += combinedWeight * cell.prob;
-                        }
-                        else {
-                            cellProbabilities[cellPtr] = combinedWeight * cell.prob;
-                        }
-                        cellProjections[cellPtr].push_back({ clampedX, clampedZ });
-                    }
+                    double clampedX = std::max(cellPtr->xMin, std::min(cellPtr->xMax, exactX));
+                    double clampedZ = std::max(cellPtr->zMin, std::min(cellPtr->zMax, exactZ));
+                    if (std::sqrt((clampedX - exactX) * (clampedX - exactX)
+                        + (clampedZ - exactZ) * (clampedZ - exactZ)) > config.f4CellMargin) continue;
+                    hitAnyCell = true;
+                    accumulate(slot, combinedWeight * cellPtr->prob, clampedX, clampedZ);
                 }
 
-                // Also consider exact F4 points that don't hit any cell
-                bool hitAnyCell = false;
-                for (const auto& cell : strongholdCells) {
-                    double clampedX = std::max(cell.xMin, std::min(cell.xMax, exactX));
-                    double clampedZ = std::max(cell.zMin, std::min(cell.zMax, exactZ));
-                    double distanceToCell = std::sqrt(
-                        std::pow(clampedX - exactX, 2) + std::pow(clampedZ - exactZ, 2)
-                    );
-                    if (distanceToCell <= 50.0) {
-                        hitAnyCell = true;
-                        break;
-                    }
-                }
+                anySampleHitCell = anySampleHitCell || hitAnyCell;
 
-                // If no cell was hit, add as standalone candidate
+                // Also consider exact F4 points that don't hit any cell, as standalone candidates
                 if (!hitAnyCell) {
                     // Create a virtual "cell" for non-cell locations
-                    static std::vector<StrongholdCell> virtualCells;
                     StrongholdCell virtualCell;
                     virtualCell.centerX = exactX;
                     virtualCell.centerZ = exactZ;
@@ -222,14 +201,15 @@ void calculateStrongholdLocationWithDistance(double playerX, double playerZ, dou
 
                     virtualCells.push_back(virtualCell);
                     const StrongholdCell* virtualPtr = &virtualCells.back();
-                    cellProbabilities[virtualPtr] = combinedWeight * virtualCell.prob;
-                    cellProjections[virtualPtr].push_back({ exactX, exactZ });
+                    accumulators.push_back({ virtualPtr, combinedWeight * virtualCell.prob, exactX, exactZ, 1 });
                 }
             }
         }
         else {
             // Non-F4 case: ray-casting logic with angle uncertainty, but from eye start position
-            for (const auto& cell : strongholdCells) {
+            strongholdCellsAlongRay(eyeStartX, eyeStartZ, dx, dz, config.maxRayDistance, nearbyCells);
+            for (const StrongholdCell* cellPtr : nearbyCells) {
+                const StrongholdCell& cell = *cellPtr;
                 double toCenterX = cell.centerX - eyeStartX;
                 double toCenterZ = cell.centerZ - eyeStartZ;
                 double t = (toCenterX * dx + toCenterZ * dz);
@@ -244,35 +224,30 @@ void calculateStrongholdLocationWithDistance(double playerX, double playerZ, dou
                         double clampedX = std::max(cell.xMin, std::min(cell.xMax, projectionX));
                         double clampedZ = std::max(cell.zMin, std::min(cell.zMax, projectionZ));
 
-                        const StrongholdCell* cellPtr = &cell;
-                        if (cellProbabilities.count(cellPtr) > 0) {
-                            cellProbabilities[cellPtr] += angleWeight * cell.prob;
-                        }
-                        else {
-                            cellProbabilities[cellPtr] = angleWeight * cell.prob;
+                        auto inserted = cellSlots.insert({ cellPtr, accumulators.size() });
+                        if (inserted.second) {
+                            accumulators.push_back({ cellPtr, 0.0, 0.0, 0.0, 0 });
                         }
-                        cellProjections[cellPtr].push_back({ clampedX, clampedZ });
+                        accumulate(inserted.first->second, angleWeight * cell.prob, clampedX, clampedZ);
                     }
                 }
             }
         }
     }
 
-    // Convert accumulated probabilities to candidates
-    for (const auto& pair : cellProbabilities) {
-        const StrongholdCell* cell = pair.first;
-        double accumulatedProb = pair.second;
+    // Convert accumulated probabilities to candidates, in cell address order so that
+    // equally likely candidates keep a stable order through the sort below
+    TRACE_SPAN("format candidates");
+    std::sort(accumulators.begin(), accumulators.end(),
+        [](const CellAccumulator& a, const CellAccumulator& b) { return a.cell < b.cell; });
+    for (const auto& accumulator : accumulators) {
+        const StrongholdCell* cell = accumulator.cell;
+        double accumulatedProb = accumulator.prob;
 
-        if (accumulatedProb > 0 && cellProjections.count(cell) > 0 && !cellProjections.at(cell).empty()) {
+        if (accumulatedProb > 0 && accumulator.projections > 0) {
             // Average the projection points
-            double avgX = 0, avgZ = 0;
-            const auto& projections = cellProjections.at(cell);
-            for (const auto& projection : projections) {
-                avgX += projection.first;
-                avgZ += projection.second;
-            }
-            avgX /= projections.size();
-            avgZ /= projections.size();
+            double avgX = accumulator.sumX / accumulator.projections;
+            double avgZ = accumulator.sumZ / accumulator.projections;
 
             // Calculate distance from PLAYER position to projection (for display purposes)
             double distanceToProjection = std::sqrt(
@@ -296,10 +271,10 @@ void calculateStrongholdLocationWithDistance(double playerX, double playerZ, dou
                 candidate.bounds = L"Exact F4 distance point";
             }
             else {
-                std::wstringstream ss;
-                ss << L"(" << (int)cell->xMin << L", " << (int)cell->zMin
-                    << L") to (" << (int)cell->xMax << L", " << (int)cell->zMax << L")";
-                candidate.bounds = ss.str();
+                WideFormatBuffer text;
+                text.text(L"(").integer((int)cell->xMin).text(L", ").integer((int)cell->zMin)
+                    .text(L") to (").integer((int)cell->xMax).text(L", ").integer((int)cell->zMax).text(L")");
+                candidate.bounds = text.str();
             }
 
             strongholdCandidates.push_back(candidate);
@@ -323,4 +298,37 @@ void calculateStrongholdLocationWithDistance(double playerX, double playerZ, dou
         [](const StrongholdCandidate& a, const StrongholdCandidate& b) {
             return a.conditionalProb > b.conditionalProb;
         });
+
+    // An F4 distance that reaches no cell on any sampled bearing contradicts the throw
+    if (useTargetDistance && !anySampleHitCell) {
+        appState.distanceValidationFailed = true;
+        appState.validationErrorMessage = F4_DISTANCE_MISMATCH_MESSAGE;
+    }
+
+    metrics.solves.add();
+    metrics.solveCandidates.record((double)strongholdCandidates.size());
+    if (appState.distanceValidationFailed) {
+        metrics.distanceValidationFailures.add();
+    }
+}
+
+void solveCapturedThrow(double targetDistance) {
+    if (solverConfig.edition == EDITION_JAVA) {
+        // The fixed-point solver and the first-throw table only know the Bedrock grid
+        calculateStrongholdLocationJava(appState.coord1.x, appState.coord1.z, appState.lastAngle, targetDistance, solverConfig);
+    }
+    else if (solverMode == SOLVER_FIXED_POINT) {
+        calculateStrongholdLocationFixedPoint(appState.coord1.x, appState.coord1.z,
+            appState.coord2.x - appState.coord1.x, appState.coord2.z - appState.coord1.z);
+    }
+    else if (!(appState.f4PressedFirst && appState.calculatedDistance > 0)
+        && firstThrowTable.lookup(appState.coord1.x, appState.coord1.z, appState.lastAngle, strongholdCandidates)) {
+        // Throw near spawn without F4: answered from the precomputed table
+        appState.distanceValidationFailed = false;
+        appState.validationErrorMessage = L"";
+        metrics.firstThrowTableHits.add();
+    }
+    else {
+        calculateStrongholdLocationWithDistance(appState.coord1.x, appState.coord1.z, appState.lastAngle, targetDistance);
+    }
 }
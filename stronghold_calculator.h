@@ -1,9 +1,37 @@
 #pragma once
 #define NOMINMAX
-#include "common.h"
+#include "app_state.h"
+#include "cell_lattice.h"
+#include "solver_config.h"
+#include <vector>
 
-// Generate all possible stronghold cells
-void generateStrongholdCells();
+enum SolverMode {
+    SOLVER_DOUBLE,          // Floating-point solver
+    SOLVER_FIXED_POINT      // Bit-for-bit reproducible solver (fixed_point_solver.h)
+};
+
+extern SolverMode solverMode;
+
+// Shown when the F4 distance reaches no stronghold cell (or ring) on any sampled bearing
+const wchar_t* const F4_DISTANCE_MISMATCH_MESSAGE =
+    L"Distance mismatch: the F4 distance does not reach a possible stronghold in this direction. Check the F4 presses or throw again.";
 
 // Calculate stronghold locations based on player position and eye angle
-void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance = -1);
\ No newline at end of file
+void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance = -1);
+
+// Same with other solver settings, e.g. a wider angleStdDev for a mouse-tracked angle
+void calculateStrongholdLocationWithDistance(double playerX, double playerZ, double eyeAngle, double targetDistance,
+    const SolverConfig& config);
+
+// Angle samples angleStdDev / 2 apart, and F4 distance samples when no press likelihood exists
+std::vector<double> generateAngleSamples(double centerAngle, int numSamples, double angleStdDev);
+std::vector<DistanceSample> generateDistanceSamples(double centerDistance, int numSamples, double stdDev);
+double gaussianProbability(double x, double mean, double stdDev);
+
+// Utility function for angle calculation
+double angleBetween(double x1, double y1, double x2, double y2);
+
+// Solve the throw between appState.coord1 and coord2 with the selected solverMode.
+// Double-mode throws without F4 are answered from firstThrowTable when it covers them.
+// Java Edition throws (solverConfig.edition) always use the ring prior.
+void solveCapturedThrow(double targetDistance = -1);
@@ -0,0 +1,112 @@
+#define NOMINMAX
+#include "throw_recommender.h"
+#include "stronghold_calculator.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+std::vector<ThrowRecommendation> nextThrowRecommendations;
+
+// Measurement noise is integrated with a 5-point Gauss-Hermite rule (in units of the angle standard deviation)
+static const double NOISE_OFFSETS[] = { -2.856970, -1.355626, 0.0, 1.355626, 2.856970 };
+static const double NOISE_WEIGHTS[] = { 0.011257, 0.222076, 0.533333, 0.222076, 0.011257 };
+
+struct ThrowTarget {
+    double x, z;
+    double prob;
+};
+
+static double entropyBits(const double* probs, int count) {
+    double entropy = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (probs[i] > 0) entropy -= probs[i] * std::log2(probs[i]);
+    }
+    return entropy;
+}
+
+static double wrapDegrees(double angle) {
+    angle = std::fmod(angle + 180.0, 360.0);
+    if (angle < 0) angle += 360.0;
+    return angle - 180.0;
+}
+
+// Expected posterior entropy after a throw from (x, z) whose measured angle points at
+// the true stronghold with Gaussian noise
+static double expectedPosteriorEntropy(double x, double z, const std::vector<ThrowTarget>& targets, double angleStdDev) {
+    int count = (int)targets.size();
+    double angles[THROW_MAX_CANDIDATES];
+    double posterior[THROW_MAX_CANDIDATES];
+    for (int i = 0; i < count; i++) {
+        angles[i] = angleBetween(x, z, targets[i].x, targets[i].z);
+    }
+
+    double expected = 0.0;
+    for (int truth = 0; truth < count; truth++) {
+        for (int k = 0; k < 5; k++) {
+            double measured = angles[truth] + NOISE_OFFSETS[k] * angleStdDev;
+            double total = 0.0;
+            for (int i = 0; i < count; i++) {
+                double error = wrapDegrees(measured - angles[i]) / angleStdDev;
+                posterior[i] = targets[i].prob * std::exp(-0.5 * error * error);
+                total += posterior[i];
+            }
+            if (total <= 0) continue;
+            for (int i = 0; i < count; i++) {
+                posterior[i] /= total;
+            }
+            expected += targets[truth].prob * NOISE_WEIGHTS[k] * entropyBits(posterior, count);
+        }
+    }
+    return expected;
+}
+
+std::vector<ThrowRecommendation> recommendNextThrow(double playerX, double playerZ,
+    const std::vector<StrongholdCandidate>& candidates, double budgetMs) {
+    TRACE_SPAN("recommend throw");
+    auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+
+    std::vector<ThrowTarget> targets;
+    double totalProb = 0.0;
+    for (int i = 0; i < (int)candidates.size() && (int)targets.size() < THROW_MAX_CANDIDATES; i++) {
+        targets.push_back({ (double)candidates[i].projectionX, (double)candidates[i].projectionZ, candidates[i].conditionalProb });
+        totalProb += candidates[i].conditionalProb;
+    }
+    std::vector<ThrowRecommendation> result;
+    if (targets.size() < 2 || totalProb <= 0) return result;
+    if (targets[0].prob / totalProb >= THROW_CONFIDENT_PROBABILITY) return result;
+
+    double prior[THROW_MAX_CANDIDATES];
+    for (int i = 0; i < (int)targets.size(); i++) {
+        targets[i].prob /= totalProb;
+        prior[i] = targets[i].prob;
+    }
+    double priorEntropy = entropyBits(prior, (int)targets.size());
+    double angleStdDev = solverConfig.angleStdDev;
+
+    // Runs on the capture worker itself; the deadline is checked once per grid row
+    int side = 2 * THROW_GRID_RADIUS + 1;
+    for (int row = 0; row < side; row++) {
+        if (std::chrono::steady_clock::now() > deadline) break;
+        for (int col = 0; col < side; col++) {
+            double dx = (col - THROW_GRID_RADIUS) * THROW_GRID_SPACING;
+            double dz = (row - THROW_GRID_RADIUS) * THROW_GRID_SPACING;
+            double walk = std::sqrt(dx * dx + dz * dz);
+            if (walk > THROW_GRID_RADIUS * THROW_GRID_SPACING) continue;
+
+            ThrowRecommendation entry;
+            entry.x = (int)std::lround(playerX + dx);
+            entry.z = (int)std::lround(playerZ + dz);
+            entry.walkDistance = walk;
+            entry.expectedGain = priorEntropy - expectedPosteriorEntropy(playerX + dx, playerZ + dz, targets, angleStdDev);
+            entry.gainPerBlock = entry.expectedGain / std::max(THROW_MIN_WALK, walk);
+            if (entry.expectedGain > 0) result.push_back(entry);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const ThrowRecommendation& a, const ThrowRecommendation& b) {
+        return a.gainPerBlock > b.gainPerBlock;
+    });
+    if ((int)result.size() > THROW_RECOMMENDATIONS) result.resize(THROW_RECOMMENDATIONS);
+    return result;
+}
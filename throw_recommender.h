@@ -0,0 +1,30 @@
+#pragma once
+#define NOMINMAX
+#include <vector>
+#include "app_state.h"
+
+// Where to throw the next eye. Each grid position near the player is scored by how
+// much a simulated throw from there would reduce the entropy of the candidate
+// distribution, per block walked to get there.
+
+const int THROW_GRID_RADIUS = 10;               // Grid cells in each direction from the player
+const double THROW_GRID_SPACING = 20.0;         // Blocks between grid positions
+const double THROW_MIN_WALK = 16.0;             // Walking cost floor so nearby spots are not favoured unfairly
+const int THROW_MAX_CANDIDATES = 16;            // Top candidates kept in the simulated posterior
+const double THROW_RECOMMENDER_BUDGET_MS = 25.0; // Positions not scored by then are skipped
+const int THROW_RECOMMENDATIONS = 3;            // Positions kept after ranking
+const double THROW_CONFIDENT_PROBABILITY = 0.8; // No recommendation once the top candidate is this likely
+
+struct ThrowRecommendation {
+    int x, z;                   // Overworld position to throw from
+    double walkDistance;        // Blocks from the player
+    double expectedGain;        // Expected entropy reduction in bits
+    double gainPerBlock;        // Ranking score
+};
+
+// Best positions first; empty when the candidates are already unambiguous
+std::vector<ThrowRecommendation> recommendNextThrow(double playerX, double playerZ,
+    const std::vector<StrongholdCandidate>& candidates, double budgetMs = THROW_RECOMMENDER_BUDGET_MS);
+
+// Recommendations for the current strongholdCandidates
+extern std::vector<ThrowRecommendation> nextThrowRecommendations;
@@ -0,0 +1,115 @@
+#define NOMINMAX
+#include "trace.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// One slot of a ring. The sequence number is published last so a reader can
+// tell a complete slot from one the owning thread is overwriting.
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{ 0 };
+    TraceEvent event = { nullptr, 0, 0 };
+};
+
+struct TraceRing {
+    int threadId = 0;
+    std::atomic<uint64_t> head{ 0 };
+    TraceSlot slots[TRACE_RING_CAPACITY];
+};
+
+// Rings are never freed, so a dump can still read spans of threads that have
+// exited. A thread returns its ring to the free list when it exits and the next
+// new thread takes it over, so short-lived workers (a seed search starts about a
+// thousand) share a few rings instead of leaking one each; their spans appear on
+// the same track, which is fine since they never overlap.
+std::mutex ringsMutex;
+std::vector<std::unique_ptr<TraceRing>> rings;
+std::vector<TraceRing*> freeRings;
+
+struct RingOwner {
+    TraceRing* ring = nullptr;
+
+    ~RingOwner() {
+        if (!ring) return;
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        freeRings.push_back(ring);
+    }
+};
+
+TraceRing* currentRing() {
+    thread_local RingOwner owner;
+    if (!owner.ring) {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        if (!freeRings.empty()) {
+            owner.ring = freeRings.back();
+            freeRings.pop_back();
+        }
+        else {
+            rings.push_back(std::make_unique<TraceRing>());
+            owner.ring = rings.back().get();
+            owner.ring->threadId = (int)rings.size();
+        }
+    }
+    return owner.ring;
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+}
+
+uint64_t traceNowNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - epoch;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void traceRecord(const char* name, uint64_t startNs, uint64_t durationNs) {
+    TraceRing* ring = currentRing();
+    uint64_t index = ring->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = ring->slots[index % TRACE_RING_CAPACITY];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = { name, startNs, durationNs };
+    slot.sequence.store(index + 1, std::memory_order_release);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void writeChromeTrace(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& ring : rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > (uint64_t)TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0;
+
+        for (uint64_t index = begin; index < head; index++) {
+            const TraceSlot& slot = ring->slots[index % TRACE_RING_CAPACITY];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+            TraceEvent event = slot.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1) continue;
+
+            if (!first) out << ",";
+            first = false;
+            out << "\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+                << ",\"ts\":" << (event.startNs / 1000) << "." << (event.startNs % 1000 / 100)
+                << ",\"dur\":" << (event.durationNs / 1000) << "." << (event.durationNs % 1000 / 100)
+                << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
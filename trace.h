@@ -0,0 +1,49 @@
+#pragma once
+#define NOMINMAX
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Hot-path tracing. Spans are recorded into a fixed-size ring buffer owned by the
+// calling thread (single writer, no locks) and can be dumped as Chrome trace-event
+// JSON (chrome://tracing or https://ui.perfetto.dev).
+// Define DISABLE_TRACE_SPANS to compile every TRACE_SPAN out.
+
+const int TRACE_RING_CAPACITY = 4096; // Spans kept per thread, oldest are overwritten
+
+struct TraceEvent {
+    const char* name;   // Must be a string literal
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+// Nanoseconds since the first trace call in this process
+uint64_t traceNowNs();
+
+// Record a finished span on the calling thread's ring
+void traceRecord(const char* name, uint64_t startNs, uint64_t durationNs);
+
+// Write every thread's recorded spans as Chrome trace-event JSON
+void writeChromeTrace(std::ostream& out);
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name(name), startNs(traceNowNs()) {}
+    ~TraceSpan() { traceRecord(name, startNs, traceNowNs() - startNs); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    uint64_t startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef DISABLE_TRACE_SPANS
+#define TRACE_SPAN(name) ((void)0)
+#else
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#endif